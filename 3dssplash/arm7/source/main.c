@@ -31,6 +31,7 @@
 #include <maxmod7.h>
 #include "common/isPhatCheck.h"
 #include "common/arm7status.h"
+#include "common/discCache.h"
 
 void my_touchInit();
 void my_installSystemFIFO(void);
@@ -168,6 +169,8 @@ int main() {
 		}
 		swiWaitForVBlank();
 	}
+
+	discCacheRequestFlush();
 	return 0;
 }
 
@@ -20,6 +20,7 @@
 #include "common/tonccpy.h"
 #include "fileCopy.h"
 #include "save/Save.h"
+#include "patchJournal.h"
 #include "gbaswitch.h"
 
 static u8 blankBuf[0x10000] = {0};
@@ -121,10 +122,10 @@ ITCM_CODE void gptc_patchWait()
 	prefetchPatch[5] = 0x08000000+(entryPoint*4);
 
 	u32 patchOffset = 0x01FFFFE4;
-	tonccpy((u8*)0x08000000+patchOffset, prefetchPatch, 6*sizeof(u32));
+	journal_copy((u8*)0x08000000+patchOffset, prefetchPatch, 6*sizeof(u32));
 
 	u32 branchCode = 0xEA000000+(patchOffset/sizeof(u32))-2;
-	tonccpy((u16*)0x08000000, &branchCode, sizeof(u32));
+	journal_copy((u16*)0x08000000, &branchCode, sizeof(u32));
 
 	u32 searchRange = 0x08000000+romFileSize;
 	if (romFileSize > 0x01FFFFE4) searchRange = 0x09FFFFE4;
@@ -141,10 +142,13 @@ ITCM_CODE void gptc_patchWait()
 		  || data8_last == 0x47 || data8_last == 0x81 || data8_last == 0x85
 		  || data8_last == 0xE0 || data8_last == 0xE7 || *(u16*)(addr+4) == 0x4017 || *(u16*)(addr-2) == 0xFFFE)
 		{
-			toncset((u16*)addr, 0, sizeof(u32));
+			journal_fill((u16*)addr, 0, sizeof(u32));
 		}
 	}
+}
 
+static void gptc_patchGreenSwap()
+{
 	scanKeys();
 	int keys = keysHeld();
 
@@ -153,7 +157,7 @@ ITCM_CODE void gptc_patchWait()
 		u32 gsPatchOffset = 0x01FFFFCC;
 		tonccpy((u8*)0x08000000+gsPatchOffset, greenSwapPatch, 6*sizeof(u32));
 
-		branchCode = 0xEA000000+(gsPatchOffset/sizeof(u32))-2;
+		u32 branchCode = 0xEA000000+(gsPatchOffset/sizeof(u32))-2;
 		tonccpy((u16*)0x08000000, &branchCode, sizeof(u32));
 	}
 }
@@ -204,9 +208,16 @@ static void fixRomPadding(void) {
 	} */
 }
 
-static void gptc_patchRom()
+// Returns whether the journal is still being replayed
+static bool gptc_patchRom(bool replay)
 {
-	gptc_patchWait();
+	// The wait state scan goes through the whole ROM, so it's replayed from the journal when possible
+	replay = replay && journal_replay(JOURNAL_WAIT);
+	if (!replay) {
+		journal_setSection(JOURNAL_WAIT);
+		gptc_patchWait();
+	}
+	gptc_patchGreenSwap();
 
 	const u32 nop = 0xE1A00000;
 	const u16 nopT = 0x46C0;
@@ -842,6 +853,8 @@ static void gptc_patchRom()
 		if (*(u16*)(0x08000000 + 0x1A16) == 0x0D81)
 			*(u16*)(0x08000000 + 0x1A16) = 0x087B;
 	}
+
+	return replay;
 }
 
 
@@ -955,34 +968,51 @@ int main(int argc, char **argv) {
 		}
 		s2RamAccess(false);
 	} else if (*(u32*)0x080000AC != 0x4732424D) {
+		const bool useJournal = (*(u16*)(0x020000C0) != 0x5A45);
+		bool replay = useJournal && journal_load();
+
 		if (*(u16*)(0x020000C0) != 0x5A45) {
-			gptc_patchRom();
+			replay = gptc_patchRom(replay);
 			//iprintf("ROM patched\n");
 		}
 
-		const save_type_t* saveType = savingAllowed ? save_findTag() : NULL;
-		//iprintf("Save tag found\n");
-		if (saveType != NULL && saveType->patchFunc != NULL) {
-			if (saveType->patchFunc(saveType) && *(u16*)(0x020000C0) == 0x5A45) {
-				consoleDemoInit();
-				printf("\x1B[41mWARNING!\x1B[47m\n");
-				printf("This game uses a save type\n");
-				printf("other than SRAM.\n\n");
-				printf("Please SRAM-patch your ROM\n");
-				printf("in order to save your data.\n\n");
-				printf("Press A to continue\nwithout saving\n");
-
-				u16 pressed = 0;
-				do {
-					swiWaitForVBlank();
-					scanKeys();
-					pressed = keysDown();
-				} while (!(pressed & KEY_A));
-
-				consoleClear();
+		// savingAllowed only depends on the game code, so it's the same as when the journal was written
+		const save_type_t* saveType = NULL;
+		bool savePatched = false;
+		if (replay && journal_replay(JOURNAL_SAVE)) {
+			saveType = save_getType(journal_saveType());
+			savePatched = journal_savePatched();
+		} else {
+			saveType = savingAllowed ? save_findTag() : NULL;
+			//iprintf("Save tag found\n");
+			if (saveType != NULL && saveType->patchFunc != NULL) {
+				journal_setSection(JOURNAL_SAVE);
+				savePatched = saveType->patchFunc(saveType);
+			}
+			if (useJournal) {
+				journal_write(save_typeIndex(saveType), savePatched);
 			}
 		}
 
+		if (savePatched && *(u16*)(0x020000C0) == 0x5A45) {
+			consoleDemoInit();
+			printf("\x1B[41mWARNING!\x1B[47m\n");
+			printf("This game uses a save type\n");
+			printf("other than SRAM.\n\n");
+			printf("Please SRAM-patch your ROM\n");
+			printf("in order to save your data.\n\n");
+			printf("Press A to continue\nwithout saving\n");
+
+			u16 pressed = 0;
+			do {
+				swiWaitForVBlank();
+				scanKeys();
+				pressed = keysDown();
+			} while (!(pressed & KEY_A));
+
+			consoleClear();
+		}
+
 		if (*(u16*)(0x020000C0) != 0x5A45) {
 			fixRomPadding();
 		}
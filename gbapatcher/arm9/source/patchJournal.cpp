@@ -0,0 +1,217 @@
+#include <nds.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <vector>
+
+#include "common/tonccpy.h"
+#include "patchJournal.h"
+
+extern u32 romFileSize;
+
+#define JOURNAL_MAGIC	0x4A504247	// "GBPJ"
+#define JOURNAL_VERSION	2			// Bump when the recorded patches change
+#define JOURNAL_FOLDER	"/_nds/TWiLightMenu/cache/gbapatch"
+
+#define SAMPLE_COUNT	64
+#define SAMPLE_SIZE		64
+
+struct JournalHeader
+{
+	u32 magic;
+	u32 version;
+	u32 romSize;
+	u32 gameCode;
+	u32 complement;
+	u32 sampleHash;
+	s32 saveType;
+	u32 savePatched;
+	u32 sectionSize[JOURNAL_SECTION_COUNT];
+};
+
+// Each write is stored as its ROM offset, length and a hash of the bytes it replaced,
+// then the data padded to 4 bytes
+struct JournalEntry
+{
+	u32 offset;
+	u32 len;
+	u32 originalHash;
+};
+
+static JournalHeader header;
+static std::vector<u8> sections[JOURNAL_SECTION_COUNT];
+static JournalSection current = JOURNAL_WAIT;
+static char journalPath[64];
+
+static u32 bytesHash(const void* src, u32 len)
+{
+	// FNV-1a, a byte at a time as patches don't have to be word aligned
+	u32 hash = 2166136261u;
+	for (u32 i = 0; i < len; i++) {
+		hash = (hash ^ ((const u8*)src)[i]) * 16777619u;
+	}
+	return hash;
+}
+
+static u32 sampleHash()
+{
+	// FNV-1a over the header and evenly spaced samples of the unpatched ROM
+	u32 hash = 2166136261u;
+	const u32 step = (romFileSize > SAMPLE_SIZE) ? (romFileSize - SAMPLE_SIZE) / SAMPLE_COUNT : 0;
+	for (int i = 0; i <= SAMPLE_COUNT; i++) {
+		const u32* sample = (u32*)(0x08000000 + ((i == 0) ? 0 : ((i * step) & ~3)));
+		const u32 len = (i == 0) ? 0xC0 : SAMPLE_SIZE;
+		for (u32 w = 0; w < len/sizeof(u32); w++) {
+			hash = (hash ^ sample[w]) * 16777619u;
+		}
+	}
+	return hash;
+}
+
+bool journal_load()
+{
+	for (int i = 0; i < JOURNAL_SECTION_COUNT; i++) {
+		sections[i].clear();
+	}
+	current = JOURNAL_WAIT;
+
+	header.magic = JOURNAL_MAGIC;
+	header.version = JOURNAL_VERSION;
+	header.romSize = romFileSize;
+	header.gameCode = *(u32*)0x080000AC;
+	header.complement = *(u8*)0x080000BD;
+	header.sampleHash = sampleHash();
+	header.saveType = -1;
+	header.savePatched = false;
+	sprintf(journalPath, JOURNAL_FOLDER "/%08lX%08lX.bin", (unsigned long)header.romSize, (unsigned long)header.sampleHash);
+
+	FILE* file = fopen(journalPath, "rb");
+	if (!file) {
+		return false;
+	}
+
+	JournalHeader fileHeader;
+	bool valid = (fread(&fileHeader, sizeof(JournalHeader), 1, file) == 1
+				&& fileHeader.magic == header.magic
+				&& fileHeader.version == header.version
+				&& fileHeader.romSize == header.romSize
+				&& fileHeader.gameCode == header.gameCode
+				&& fileHeader.complement == header.complement
+				&& fileHeader.sampleHash == header.sampleHash);
+	for (int i = 0; valid && i < JOURNAL_SECTION_COUNT; i++) {
+		sections[i].resize(fileHeader.sectionSize[i]);
+		valid = (sections[i].empty() || fread(sections[i].data(), 1, sections[i].size(), file) == sections[i].size());
+	}
+	fclose(file);
+
+	if (!valid) {
+		for (int i = 0; i < JOURNAL_SECTION_COUNT; i++) {
+			sections[i].clear();
+		}
+		return false;
+	}
+
+	header.saveType = fileHeader.saveType;
+	header.savePatched = fileHeader.savePatched;
+	return true;
+}
+
+bool journal_replay(JournalSection section)
+{
+	const std::vector<u8>& data = sections[section];
+
+	// Another ROM with the same size and samples won't have the same bytes under every patch
+	bool valid = true;
+	for (u32 pos = 0; valid && pos < data.size(); ) {
+		const JournalEntry* entry = (const JournalEntry*)&data[pos];
+		pos += sizeof(JournalEntry);
+		valid = (pos <= data.size()
+				&& entry->len <= data.size() - pos
+				&& entry->len <= 0x02000000 && entry->offset <= 0x02000000 - entry->len
+				&& bytesHash((u8*)0x08000000 + entry->offset, entry->len) == entry->originalHash);
+		pos += (entry->len + 3) & ~3;
+	}
+
+	if (!valid) {
+		// Nothing was written, so the patches from here on are found and recorded again
+		for (int i = section; i < JOURNAL_SECTION_COUNT; i++) {
+			sections[i].clear();
+		}
+		return false;
+	}
+
+	for (u32 pos = 0; pos < data.size(); ) {
+		const JournalEntry* entry = (const JournalEntry*)&data[pos];
+		pos += sizeof(JournalEntry);
+		tonccpy((u8*)0x08000000 + entry->offset, &data[pos], entry->len);
+		pos += (entry->len + 3) & ~3;
+	}
+	return true;
+}
+
+void journal_setSection(JournalSection section)
+{
+	current = section;
+}
+
+// Must be called before the ROM is written, returns where to store the new data
+static u8* record(const void* dst, u32 len)
+{
+	std::vector<u8>& data = sections[current];
+	const u32 pos = data.size();
+	data.resize(pos + sizeof(JournalEntry) + ((len + 3) & ~3));
+
+	JournalEntry* entry = (JournalEntry*)&data[pos];
+	entry->offset = (u32)dst - 0x08000000;
+	entry->len = len;
+	entry->originalHash = bytesHash(dst, len);
+	return &data[pos + sizeof(JournalEntry)];
+}
+
+void journal_copy(void* dst, const void* src, u32 len)
+{
+	tonccpy(record(dst, len), src, len);
+	tonccpy(dst, src, len);
+}
+
+void journal_fill(void* dst, u8 value, u32 len)
+{
+	toncset(record(dst, len), value, len);
+	toncset(dst, value, len);
+}
+
+int journal_saveType()
+{
+	return header.saveType;
+}
+
+bool journal_savePatched()
+{
+	return header.savePatched;
+}
+
+void journal_write(int saveType, bool savePatched)
+{
+	header.saveType = saveType;
+	header.savePatched = savePatched;
+	for (int i = 0; i < JOURNAL_SECTION_COUNT; i++) {
+		header.sectionSize[i] = sections[i].size();
+	}
+
+	mkdir("/_nds/TWiLightMenu/cache", 0777);
+	mkdir(JOURNAL_FOLDER, 0777);
+
+	FILE* file = fopen(journalPath, "wb");
+	if (!file) {
+		return;
+	}
+	bool written = (fwrite(&header, sizeof(JournalHeader), 1, file) == 1);
+	for (int i = 0; written && i < JOURNAL_SECTION_COUNT; i++) {
+		written = (sections[i].empty() || fwrite(sections[i].data(), 1, sections[i].size(), file) == sections[i].size());
+	}
+	fclose(file);
+
+	if (!written) {
+		// Don't leave a partial journal behind
+		remove(journalPath);
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <nds/ndstypes.h>
+
+enum JournalSection
+{
+	JOURNAL_WAIT = 0,	// Prefetch branch and wait state fixes
+	JOURNAL_SAVE,		// Save type patches
+
+	JOURNAL_SECTION_COUNT
+};
+
+/**
+ * Per-ROM record of the patches written to Slot-2 RAM, kept in
+ * /_nds/TWiLightMenu/cache/gbapatch. The ROM is identified by its size,
+ * header and a sampled hash, so relaunching a game replays the writes
+ * instead of scanning the whole ROM again.
+ *
+ * Must be called before the ROM is patched.
+ * Returns true if a journal was found and can be replayed.
+ */
+bool journal_load();
+
+/**
+ * Apply the recorded writes of a section, if the ROM still holds the
+ * bytes each of them replaced.
+ * Returns false without writing anything otherwise. That section and the
+ * ones after it are then dropped, to be patched and recorded again.
+ */
+bool journal_replay(JournalSection section);
+
+/**
+ * Select the section that journal_copy and journal_fill record into.
+ */
+void journal_setSection(JournalSection section);
+
+/**
+ * Write to the ROM, and record the write in the current section.
+ */
+void journal_copy(void* dst, const void* src, u32 len);
+void journal_fill(void* dst, u8 value, u32 len);
+
+/**
+ * The save type and save patch result of a loaded journal.
+ * The type is -1 if no save tag was found.
+ */
+int journal_saveType();
+bool journal_savePatched();
+
+/**
+ * Write the recorded patches for this ROM.
+ */
+void journal_write(int saveType, bool savePatched);
@@ -1,4 +1,4 @@
-#include "common/tonccpy.h"
+#include "patchJournal.h"
 #include "find.h"
 #include "Save.h"
 #include "EepromSave.h"
@@ -80,12 +80,12 @@ bool eeprom_patchV111(const save_type_t* type)
 	u8* readFunc = memsearch8((u8*)0x08000000, romFileSize, sReadEepromDwordV111Sig, 0x10, true);
 	if (!readFunc)
 		return false;
-	tonccpy(readFunc, &patch_eeprom_1, sizeof(patch_eeprom_1));
+	journal_copy(readFunc, &patch_eeprom_1, sizeof(patch_eeprom_1));
 
 	u8* progFunc = memsearch8((u8*)0x08000000, romFileSize, sProgramEepromDwordV111Sig, 0x10, true);
 	if (!progFunc)
 		return false;
-	tonccpy(progFunc, &patch_eeprom_2, sizeof(patch_eeprom_2));
+	journal_copy(progFunc, &patch_eeprom_2, sizeof(patch_eeprom_2));
 	return true;
 }
 
@@ -121,12 +121,12 @@ bool eeprom_patchV120(const save_type_t* type)
 	u8* readFunc = memsearch8((u8*)romPos, curRomSize, sReadEepromDwordV120Sig, 0x10, true);
 	if (!readFunc)
 		return false;
-	tonccpy(readFunc, &patch_eeprom_1, sizeof(patch_eeprom_1));
+	journal_copy(readFunc, &patch_eeprom_1, sizeof(patch_eeprom_1));
 
 	u8* progFunc = memsearch8((u8*)romPos, curRomSize, sProgramEepromDwordV120Sig, 0x10, true);
 	if (!progFunc)
 		return false;
-	tonccpy(progFunc, &patch_eeprom_2, sizeof(patch_eeprom_2));
+	journal_copy(progFunc, &patch_eeprom_2, sizeof(patch_eeprom_2));
 
 	}
 
@@ -165,12 +165,12 @@ bool eeprom_patchV124(const save_type_t* type)
 	u8* readFunc = memsearch8((u8*)romPos, curRomSize, sReadEepromDwordV120Sig, 0x10, true);
 	if (!readFunc)
 		return false;
-	tonccpy(readFunc, &patch_eeprom_1, sizeof(patch_eeprom_1));
+	journal_copy(readFunc, &patch_eeprom_1, sizeof(patch_eeprom_1));
 
 	u8* progFunc = memsearch8((u8*)romPos, curRomSize, sProgramEepromDwordV124Sig, 0x10, true);
 	if (!progFunc)
 		return false;
-	tonccpy(progFunc, &patch_eeprom_2, sizeof(patch_eeprom_2));
+	journal_copy(progFunc, &patch_eeprom_2, sizeof(patch_eeprom_2));
 
 	}
 
@@ -182,11 +182,11 @@ bool eeprom_patchV126(const save_type_t* type)
 	u8* readFunc = memsearch8((u8*)0x08000000, romFileSize, sReadEepromDwordV120Sig, 0x10, true);
 	if (!readFunc)
 		return false;
-	tonccpy(readFunc, &patch_eeprom_1, sizeof(patch_eeprom_1));
+	journal_copy(readFunc, &patch_eeprom_1, sizeof(patch_eeprom_1));
 
 	u8* progFunc = memsearch8((u8*)0x08000000, romFileSize, sProgramEepromDwordV126Sig, 0x10, true);
 	if (!progFunc)
 		return false;
-	tonccpy(progFunc, &patch_eeprom_2, sizeof(patch_eeprom_2));
+	journal_copy(progFunc, &patch_eeprom_2, sizeof(patch_eeprom_2));
 	return true;
 }
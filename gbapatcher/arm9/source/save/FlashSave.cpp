@@ -1,4 +1,4 @@
-#include "common/tonccpy.h"
+#include "patchJournal.h"
 #include "find.h"
 #include "Save.h"
 #include "FlashSave.h"
@@ -200,17 +200,17 @@ bool flash_patchV120(const save_type_t* type)
 	u8* func1 = memsearch8((u8*)0x08000000, romFileSize, flash_V12X_find1, sizeof(flash_V12X_find1), true);
 	if (!func1)
 		return false;
-	tonccpy(func1, &flash_V12X_replace1, sizeof(flash_V12X_replace1));
+	journal_copy(func1, &flash_V12X_replace1, sizeof(flash_V12X_replace1));
 
 	u8* func2 = memsearch8((u8*)0x08000000, romFileSize, flash_V12X_find2, sizeof(flash_V12X_find2), true);
 	if (!func2)
 		return false;
-	tonccpy(func2, &flash_V12X_replace2, sizeof(flash_V12X_replace2));
+	journal_copy(func2, &flash_V12X_replace2, sizeof(flash_V12X_replace2));
 
 	u8* func3 = memsearch8((u8*)0x08000000, romFileSize, flash_V12X_find3, sizeof(flash_V12X_find3), true);
 	if (!func3)
 		return false;
-	tonccpy(func3, &flash_V12X_replace3, sizeof(flash_V12X_replace3));
+	journal_copy(func3, &flash_V12X_replace3, sizeof(flash_V12X_replace3));
 
 	return true;
 }
@@ -220,22 +220,22 @@ bool flash_patchV123(const save_type_t* type)
 	u8* func1 = memsearch8((u8*)0x08000000, romFileSize, flash_V12Y_find1, sizeof(flash_V12Y_find1), true);
 	if (!func1)
 		return false;
-	tonccpy(func1, &flash_V12Y_replace1, sizeof(flash_V12Y_replace1));
+	journal_copy(func1, &flash_V12Y_replace1, sizeof(flash_V12Y_replace1));
 
 	u8* func2 = memsearch8((u8*)0x08000000, romFileSize, flash_V12Y_find2, sizeof(flash_V12Y_find2), true);
 	if (!func2)
 		return false;
-	tonccpy(func2, &flash_V12Y_replace2, sizeof(flash_V12Y_replace2));
+	journal_copy(func2, &flash_V12Y_replace2, sizeof(flash_V12Y_replace2));
 
 	u8* func3 = memsearch8((u8*)0x08000000, romFileSize, flash_V12Y_find3, sizeof(flash_V12Y_find3), true);
 	if (!func3)
 		return false;
-	tonccpy(func3, &flash_V12Y_replace3, sizeof(flash_V12Y_replace3));
+	journal_copy(func3, &flash_V12Y_replace3, sizeof(flash_V12Y_replace3));
 
 	u8* func4 = memsearch8((u8*)0x08000000, romFileSize, flash_V12Y_find4, sizeof(flash_V12Y_find4), true);
 	if (!func4)
 		return false;
-	tonccpy(func4, &flash_V12Y_replace4, sizeof(flash_V12Y_replace4));
+	journal_copy(func4, &flash_V12Y_replace4, sizeof(flash_V12Y_replace4));
 
 	return true;
 }
@@ -276,27 +276,27 @@ bool flash_patch512V130(const save_type_t* type)
 	u8* func1 = memsearch8((u8*)romPos, curRomSize, flash512_V13X_find1, sizeof(flash512_V13X_find1), true);
 	if (!func1)
 		return false;
-	tonccpy(func1, &flash512_V13X_replace1, sizeof(flash512_V13X_replace1));
+	journal_copy(func1, &flash512_V13X_replace1, sizeof(flash512_V13X_replace1));
 
 	u8* func2 = memsearch8((u8*)romPos, curRomSize, flash512_V13X_find2, sizeof(flash512_V13X_find2), true);
 	if (!func2)
 		return false;
-	tonccpy(func2, &flash512_V13X_replace2, sizeof(flash512_V13X_replace2));
+	journal_copy(func2, &flash512_V13X_replace2, sizeof(flash512_V13X_replace2));
 
 	u8* func3 = memsearch8((u8*)romPos, curRomSize, flash512_V13X_find3, sizeof(flash512_V13X_find3), true);
 	if (!func3)
 		return false;
-	tonccpy(func3, &flash512_V13X_replace3_4, sizeof(flash512_V13X_replace3_4));
+	journal_copy(func3, &flash512_V13X_replace3_4, sizeof(flash512_V13X_replace3_4));
 
 	u8* func4 = memsearch8((u8*)romPos, curRomSize, flash512_V13X_find4, sizeof(flash512_V13X_find4), true);
 	if (!func4)
 		return false;
-	tonccpy(func4, &flash512_V13X_replace3_4, sizeof(flash512_V13X_replace3_4));
+	journal_copy(func4, &flash512_V13X_replace3_4, sizeof(flash512_V13X_replace3_4));
 
 	u8* func5 = memsearch8((u8*)romPos, curRomSize, flash512_V13X_find5, sizeof(flash512_V13X_find5), true);
 	if (!func5)
 		return false;
-	tonccpy(func5, &flash512_V13X_replace5, sizeof(flash512_V13X_replace5));
+	journal_copy(func5, &flash512_V13X_replace5, sizeof(flash512_V13X_replace5));
 
 	}
 
@@ -308,22 +308,22 @@ bool flash_patch1MV102(const save_type_t* type)
 	u8* func1 = memsearch8((u8*)0x08000000, romFileSize, flash1M_V102_find1, sizeof(flash1M_V102_find1), true);
 	if (!func1)
 		return false;
-	tonccpy(func1, &flash1M_V102_replace1, sizeof(flash1M_V102_replace1));
+	journal_copy(func1, &flash1M_V102_replace1, sizeof(flash1M_V102_replace1));
 
 	u8* func2 = memsearch8((u8*)0x08000000, romFileSize, flash1M_V102_find2, sizeof(flash1M_V102_find2), true);
 	if (!func2)
 		return false;
-	tonccpy(func2, &flash1M_V102_replace2, sizeof(flash1M_V102_replace2));
+	journal_copy(func2, &flash1M_V102_replace2, sizeof(flash1M_V102_replace2));
 
 	u8* func3 = memsearch8((u8*)0x08000000, romFileSize, flash1M_V102_find3, sizeof(flash1M_V102_find3), true);
 	if (!func3)
 		return false;
-	tonccpy(func3, &flash1M_V102_replace3, sizeof(flash1M_V102_replace3));
+	journal_copy(func3, &flash1M_V102_replace3, sizeof(flash1M_V102_replace3));
 
 	u8* func4 = memsearch8((u8*)0x08000000, romFileSize, flash1M_V102_find4, sizeof(flash1M_V102_find4), true);
 	if (!func4)
 		return false;
-	tonccpy(func4, &flash1M_V102_replace4, sizeof(flash1M_V102_replace4));
+	journal_copy(func4, &flash1M_V102_replace4, sizeof(flash1M_V102_replace4));
 
 	return true;
 }
@@ -333,27 +333,27 @@ bool flash_patch1MV103(const save_type_t* type)
 	u8* func1 = memsearch8((u8*)0x08000000, romFileSize, flash1M_V103_find1, sizeof(flash1M_V103_find1), true);
 	if (!func1)
 		return false;
-	tonccpy(func1, &flash1M_V103_replace1, sizeof(flash1M_V103_replace1));
+	journal_copy(func1, &flash1M_V103_replace1, sizeof(flash1M_V103_replace1));
 
 	u8* func2 = memsearch8((u8*)0x08000000, romFileSize, flash1M_V103_find2, sizeof(flash1M_V103_find2), true);
 	if (!func2)
 		return false;
-	tonccpy(func2, &flash1M_V103_replace2, sizeof(flash1M_V103_replace2));
+	journal_copy(func2, &flash1M_V103_replace2, sizeof(flash1M_V103_replace2));
 
 	u8* func3 = memsearch8((u8*)0x08000000, romFileSize, flash1M_V103_find3, sizeof(flash1M_V103_find3), true);
 	if (!func3)
 		return false;
-	tonccpy(func3, &flash1M_V103_replace3, sizeof(flash1M_V103_replace3));
+	journal_copy(func3, &flash1M_V103_replace3, sizeof(flash1M_V103_replace3));
 
 	u8* func4 = memsearch8((u8*)0x08000000, romFileSize, flash1M_V103_find4, sizeof(flash1M_V103_find4), true);
 	if (!func4)
 		return false;
-	tonccpy(func4, &flash1M_V103_replace4, sizeof(flash1M_V103_replace4));
+	journal_copy(func4, &flash1M_V103_replace4, sizeof(flash1M_V103_replace4));
 
 	u8* func5 = memsearch8((u8*)0x08000000, romFileSize, flash1M_V103_find5, sizeof(flash1M_V103_find5), true);
 	if (!func5)
 		return false;
-	tonccpy(func5, &flash1M_V103_replace5, sizeof(flash1M_V103_replace5));
+	journal_copy(func5, &flash1M_V103_replace5, sizeof(flash1M_V103_replace5));
 
 	return true;
 }
@@ -71,3 +71,13 @@ ITCM_CODE const save_type_t* save_findTag()
 	}
 	return NULL;
 }
+
+int save_typeIndex(const save_type_t* type)
+{
+	return type ? (type - sSaveTypes) : -1;
+}
+
+const save_type_t* save_getType(int index)
+{
+	return (index >= 0 && index < SAVE_TYPE_COUNT) ? &sSaveTypes[index] : NULL;
+}
@@ -51,3 +51,7 @@ struct save_type_t
 };
 
 const save_type_t* save_findTag();
+
+// For the patch journal, which stores the save type by its index
+int save_typeIndex(const save_type_t* type);
+const save_type_t* save_getType(int index);
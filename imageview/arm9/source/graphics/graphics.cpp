@@ -28,6 +28,7 @@
 #include "graphics/gif.hpp"
 #include "common/lodepng.h"
 #include "graphics/color.h"
+#include "common/temporalDither.h"
 
 #include <nds.h>
 
@@ -176,92 +177,9 @@ void imageLoad(const char* filename) {
 			}
 		}
 
-		bool alternatePixel = false;
-		int x = 0;
-		int y = 0;
-		for (unsigned i=0;i<image.size()/4;i++) {
-			u8 pixelAdjustInfo = 0;
-			u8 alphaG = image[(i*4)+3];
-			if (alternatePixel) {
-				if (image[(i*4)] >= 0x4 && image[(i*4)] < 0xFC) {
-					image[(i*4)] += 0x4;
-					pixelAdjustInfo |= BIT(0);
-				}
-				if (image[(i*4)+1] >= 0x2 && image[(i*4)+1] < 0xFE) {
-					image[(i*4)+1] += 0x2;
-					pixelAdjustInfo |= BIT(1);
-				}
-				if (image[(i*4)+2] >= 0x4 && image[(i*4)+2] < 0xFC) {
-					image[(i*4)+2] += 0x4;
-					pixelAdjustInfo |= BIT(2);
-				}
-				if (image[(i*4)+3] >= 0x4 && image[(i*4)+3] < 0xFC) {
-					image[(i*4)+3] += 0x4;
-					pixelAdjustInfo |= BIT(3);
-				}
-				if (alphaG >= 0x2 && alphaG < 0xFE) {
-					alphaG += 0x2;
-					pixelAdjustInfo |= BIT(4);
-				}
-			}
-			if (image[(i*4)+3] > 0) {
-				u16 res = 0;
-				if (image[(i*4)+3] == 255) {
-					res = rgb8ToRgb565(image[(i*4)], image[(i*4)+1], image[(i*4)+2]);
-				} else {
-					res = rgb8ToRgb565_alphablend(image[(i*4)], image[(i*4)+1], image[(i*4)+2], 0, 0, 0, image[(i*4)+3], alphaG);
-				}
-				dsImageBuffer[0][(xPos+x+(y*256))+(yPos*256)] = res;
-			}
-			if (alternatePixel) {
-				if (pixelAdjustInfo & BIT(0)) {
-					image[(i*4)] -= 0x4;
-				}
-				if (pixelAdjustInfo & BIT(1)) {
-					image[(i*4)+1] -= 0x2;
-				}
-				if (pixelAdjustInfo & BIT(2)) {
-					image[(i*4)+2] -= 0x4;
-				}
-				if (pixelAdjustInfo & BIT(3)) {
-					image[(i*4)+3] -= 0x4;
-				}
-				if (pixelAdjustInfo & BIT(4)) {
-					alphaG -= 0x2;
-				}
-			} else {
-				if (image[(i*4)] >= 0x4 && image[(i*4)] < 0xFC) {
-					image[(i*4)] += 0x4;
-				}
-				if (image[(i*4)+1] >= 0x2 && image[(i*4)+1] < 0xFE) {
-					image[(i*4)+1] += 0x2;
-				}
-				if (image[(i*4)+2] >= 0x4 && image[(i*4)+2] < 0xFC) {
-					image[(i*4)+2] += 0x4;
-				}
-				if (image[(i*4)+3] >= 0x4 && image[(i*4)+3] < 0xFC) {
-					image[(i*4)+3] += 0x4;
-				}
-				if (alphaG >= 0x2 && alphaG < 0xFE) {
-					alphaG += 0x2;
-				}
-			}
-			if (image[(i*4)+3] > 0) {
-				u16 res = 0;
-				if (image[(i*4)+3] == 255) {
-					res = rgb8ToRgb565(image[(i*4)], image[(i*4)+1], image[(i*4)+2]);
-				} else {
-					res = rgb8ToRgb565_alphablend(image[(i*4)], image[(i*4)+1], image[(i*4)+2], 0, 0, 0, image[(i*4)+3], alphaG);
-				}
-				dsImageBuffer[1][(xPos+x+(y*256))+(yPos*256)] = res;
-			}
-			x++;
-			if ((unsigned)x == width) {
-				alternatePixel = !alternatePixel;
-				x=0;
-				y++;
-			}
-			alternatePixel = !alternatePixel;
+		for (unsigned y = 0; y < height; y++) {
+			const int dstOffset = ((yPos+y)*256)+xPos;
+			temporalDitherRow(image.data()+(y*width*4), 4, true, width, y, TDFormatRgb565, NULL, dsImageBuffer[0]+dstOffset, dsImageBuffer[1]+dstOffset);
 		}
 		doubleBuffer = true;
 		return;
@@ -323,63 +241,10 @@ void imageLoad(const char* filename) {
 			u8 *bmpImageBuffer = new u8[(width * height)*bits];
 			fread(bmpImageBuffer, bits, width * height, file);
 
-			bool alternatePixel = false;
-			int x = 0;
-			int y = height-1;
-			for (u32 i = 0; i < width*height; i++) {
-				u8 pixelAdjustInfo = 0;
-				if (alternatePixel) {
-					if (bmpImageBuffer[(i*bits)] >= 0x4 && bmpImageBuffer[(i*bits)] < 0xFC) {
-						bmpImageBuffer[(i*bits)] += 0x4;
-						pixelAdjustInfo |= BIT(0);
-					}
-					if (bmpImageBuffer[(i*bits)+1] >= 0x2 && bmpImageBuffer[(i*bits)+1] < 0xFE) {
-						bmpImageBuffer[(i*bits)+1] += 0x2;
-						pixelAdjustInfo |= BIT(1);
-					}
-					if (bmpImageBuffer[(i*bits)+2] >= 0x4 && bmpImageBuffer[(i*bits)+2] < 0xFC) {
-						bmpImageBuffer[(i*bits)+2] += 0x4;
-						pixelAdjustInfo |= BIT(2);
-					}
-				}
-				u16 color = rgb8ToRgb565(bmpImageBuffer[(i*bits)], bmpImageBuffer[(i*bits)+1], bmpImageBuffer[(i*bits)+2]);
-				if (colorTable) {
-					color = colorTable[color % 0x8000];
-				}
-				dsImageBuffer[0][(xPos+x+(y*256))+(yPos*256)] = color;
-				if (alternatePixel) {
-					if (pixelAdjustInfo & BIT(0)) {
-						bmpImageBuffer[(i*bits)] -= 0x4;
-					}
-					if (pixelAdjustInfo & BIT(1)) {
-						bmpImageBuffer[(i*bits)+1] -= 0x2;
-					}
-					if (pixelAdjustInfo & BIT(2)) {
-						bmpImageBuffer[(i*bits)+2] -= 0x4;
-					}
-				} else {
-					if (bmpImageBuffer[(i*bits)] >= 0x4 && bmpImageBuffer[(i*bits)] < 0xFC) {
-						bmpImageBuffer[(i*bits)] += 0x4;
-					}
-					if (bmpImageBuffer[(i*bits)+1] >= 0x2 && bmpImageBuffer[(i*bits)+1] < 0xFE) {
-						bmpImageBuffer[(i*bits)+1] += 0x2;
-					}
-					if (bmpImageBuffer[(i*bits)+2] >= 0x4 && bmpImageBuffer[(i*bits)+2] < 0xFC) {
-						bmpImageBuffer[(i*bits)+2] += 0x4;
-					}
-				}
-				color = rgb8ToRgb565(bmpImageBuffer[(i*bits)], bmpImageBuffer[(i*bits)+1], bmpImageBuffer[(i*bits)+2]);
-				if (colorTable) {
-					color = colorTable[color % 0x8000];
-				}
-				dsImageBuffer[1][(xPos+x+(y*256))+(yPos*256)] = color;
-				x++;
-				if (x == (int)width) {
-					alternatePixel = !alternatePixel;
-					x=0;
-					y--;
-				}
-				alternatePixel = !alternatePixel;
+			for (u32 row = 0; row < height; row++) {
+				const int y = height-1-row; // Stored bottom-up
+				const int dstOffset = ((yPos+y)*256)+xPos;
+				temporalDitherRow(bmpImageBuffer+(row*width*bits), bits, false, width, y, TDFormatRgb565, colorTable, dsImageBuffer[0]+dstOffset, dsImageBuffer[1]+dstOffset);
 			}
 			delete[] bmpImageBuffer;
 			doubleBuffer = true;
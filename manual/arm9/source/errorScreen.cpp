@@ -5,6 +5,7 @@
 // #include "autoboot.h"
 #include "common/twlmenusettings.h"
 #include "common/systemdetails.h"
+#include "common/discCache.h"
 #include "common/flashcard.h"
 #include "graphics/fontHandler.h"
 #include "common/tonccpy.h"
@@ -100,6 +101,7 @@ void checkSdEject(void) {
 					*(u16*)(0x0200080E) = swiCRC16(0xFFFF, (void*)0x02000810, 0x3F0);		// Unlaunch CRC16
 				}
 			}
+			discCacheFlushAll();
 			fifoSendValue32(FIFO_USER_02, 1);	// ReturntoDSiMenu
 			swiWaitForVBlank();
 		}
@@ -108,6 +110,7 @@ void checkSdEject(void) {
 				unlaunchSetHiyaBoot();
 			}
 			memcpy((u32*)0x02000300, autoboot_bin, 0x020);
+			discCacheFlushAll();
 			fifoSendValue32(FIFO_USER_02, 1);	// ReturntoDSiMenu
 			swiWaitForVBlank();
 		}*/
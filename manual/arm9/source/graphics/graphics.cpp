@@ -29,6 +29,7 @@
 #include "graphics/gif.hpp"
 
 #include <nds.h>
+#include <algorithm>
 
 extern bool fadeType;
 extern bool controlTopBright;
@@ -162,21 +163,30 @@ void pageScroll(void) {
 }
 
 void topBarLoad(void) {
-	Gif gif ("nitro:/graphics/topbar.gif", false, false, true);
-	const auto &frame = gif.frame(0);
-	u16 *dst = bgGetGfxPtr(bg3Main);
+	// Pre-offset strip generated at build time by gif2strip.py
+	struct {
+		char magic[4];
+		u16 width;
+		u16 height;
+		u16 palCount;
+		u16 palOffset;
+	} header;
+	static u8 strip[256*18] = {0};
+
+	FILE *file = fopen("nitro:/graphics/topbar.bin", "rb");
+	if (!file) return;
+	fread(&header, 1, sizeof(header), file);
+	const int palCount = std::min((int)header.palCount, 6);
+	fread(topBarPal+4, 1, palCount * 2, file);
+	fseek(file, (header.palCount - palCount) * 2, SEEK_CUR);
+	const u32 stripSize = std::min((u32)header.width * header.height, (u32)sizeof(strip));
+	fread(strip, 1, stripSize, file);
+	fclose(file);
 
 	extern bool useTwlCfg;
 	int favoriteColor = (int)(useTwlCfg ? *(u8*)0x02000444 : PersonalData->theme);
 	if (favoriteColor < 0 || favoriteColor >= 16) favoriteColor = 0; // Invalid color found, so default to gray
 
-	/* tonccpy(BG_PALETTE + 0xFC, gif.gct().data(), gif.gct().size() * 2);
-	if (colorTable) {
-		for (int i = 0xFC; i < (int)0xFC + gif.gct().size(); i++) {
-			BG_PALETTE[i] = colorTable[BG_PALETTE[i] % 0x8000];
-		}
-	} */
-	tonccpy(topBarPal+4, gif.gct().data(), gif.gct().size() * 2);
 	topBarPal[4+4] = palUserFont[favoriteColor][1];
 	topBarPal[4+5] = palUserFont[favoriteColor][0];
 	if (colorTable) {
@@ -185,15 +195,8 @@ void topBarLoad(void) {
 		}
 	}
 
-	for (uint i = 0; i < frame.image.imageData.size(); i += 2) {
-		toncset16(dst++, (frame.image.imageData[i] + 0xFA) | (frame.image.imageData[i + 1] + 0xFA) << 8, 1);
-	}
-	for (int i = 0; i < 256/2; i++) {
-		toncset16(dst++, 0xFEFE, 1);
-	}
-	for (int i = 0; i < 256/2; i++) {
-		toncset16(dst++, 0xFFFF, 1);
-	}
+	DC_FlushRange(strip, stripSize);
+	dmaCopyWords(3, strip, bgGetGfxPtr(bg3Main), stripSize);
 }
 
 void graphicsInit() {
@@ -0,0 +1,125 @@
+#!/usr/bin/env python
+
+# Converts a small GIF UI strip into a blob that can be DMA'd straight into
+# an 8bpp bitmap background, with the pixel indices already offset to the
+# palette slots the strip uses at runtime.
+#
+# Output format (little endian):
+#   u32 magic "STRP"
+#   u16 width, u16 height (including filler rows)
+#   u16 palette count, u16 palette offset
+#   u16 palette[count] (DS RGB555)
+#   u8  pixels[width * height], padded to 4 bytes
+
+import argparse
+import struct
+
+parser = argparse.ArgumentParser(description="Converts a GIF UI strip into a pre-offset 8bpp blob for TWiLight Menu++")
+parser.add_argument("input", metavar="input.gif", type=str, help="GIF to convert")
+parser.add_argument("-o", "--output", metavar="output.bin", type=str, required=True, help="file to output to")
+parser.add_argument("-p", "--paloffset", type=lambda x: int(x, 0), default=0, help="value added to each pixel index")
+parser.add_argument("-f", "--fill", type=lambda x: int(x, 0), action="append", default=[], help="append a row filled with this index (repeatable)")
+
+args = parser.parse_args()
+
+
+def lzw_decode(data, min_code_size, pixel_count):
+	clear = 1 << min_code_size
+	end = clear + 1
+	out = bytearray()
+	table = [bytes([i]) for i in range(clear)] + [b"", b""]
+	code_size = min_code_size + 1
+	prev = None
+	pos = 0
+	while pos + code_size <= len(data) * 8:
+		code = 0
+		for i in range(code_size):
+			if data[(pos + i) >> 3] & (1 << ((pos + i) & 7)):
+				code |= 1 << i
+		pos += code_size
+
+		if code == clear:
+			table = table[:clear + 2]
+			code_size = min_code_size + 1
+			prev = None
+			continue
+		if code == end:
+			break
+
+		if code < len(table):
+			entry = table[code]
+			if prev is not None:
+				table.append(prev + entry[:1])
+		else:
+			entry = prev + prev[:1]
+			table.append(entry)
+		out += entry
+		prev = entry
+
+		if len(table) == (1 << code_size) and code_size < 12:
+			code_size += 1
+		if len(out) >= pixel_count:
+			break
+	return bytes(out[:pixel_count])
+
+
+def read_gif(path):
+	with open(path, "rb") as f:
+		data = f.read()
+
+	if data[:3] != b"GIF":
+		raise SystemExit("%s is not a GIF" % path)
+
+	width, height, flags = struct.unpack_from("<HHB", data, 6)
+	pos = 13
+	palette = []
+	if flags & 0x80:
+		count = 2 << (flags & 7)
+		for i in range(count):
+			r, g, b = data[pos + i * 3:pos + i * 3 + 3]
+			palette.append((r >> 3) | ((g >> 3) << 5) | ((b >> 3) << 10) | 0x8000)
+		pos += count * 3
+
+	while pos < len(data):
+		block = data[pos]
+		pos += 1
+		if block == 0x21:  # Extension, skip
+			pos += 1
+			while data[pos]:
+				pos += data[pos] + 1
+			pos += 1
+		elif block == 0x2C:  # Image descriptor
+			w, h, flags = struct.unpack_from("<4xHHB", data, pos)
+			pos += 9
+			if flags & 0x80:
+				raise SystemExit("local color tables are not supported")
+			if flags & 0x40:
+				raise SystemExit("interlaced images are not supported")
+			min_code_size = data[pos]
+			pos += 1
+			lzw = bytearray()
+			while data[pos]:
+				lzw += data[pos + 1:pos + 1 + data[pos]]
+				pos += data[pos] + 1
+			return width, height, palette, lzw_decode(lzw, min_code_size, w * h)
+		else:
+			break
+
+	raise SystemExit("%s has no image" % path)
+
+
+width, height, palette, pixels = read_gif(args.input)
+
+pixels = bytearray((p + args.paloffset) & 0xFF for p in pixels)
+for fill in args.fill:
+	pixels += bytes([fill & 0xFF]) * width
+	height += 1
+while len(pixels) % 4:
+	pixels.append(0)
+
+with open(args.output, "wb") as f:
+	f.write(b"STRP")
+	f.write(struct.pack("<HHHH", width, height, len(palette), args.paloffset))
+	for color in palette:
+		f.write(struct.pack("<H", color))
+	f.write(pixels)
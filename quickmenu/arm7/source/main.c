@@ -32,6 +32,7 @@
 #include <maxmod7.h>
 #include "common/isPhatCheck.h"
 #include "common/arm7status.h"
+#include "common/discCache.h"
 
 #define REG_SCFG_WL *(vu16*)0x4004020
 
@@ -367,5 +368,7 @@ int main() {
 		}
 		swiWaitForVBlank();
 	}
+
+	discCacheRequestFlush();
 	return 0;
 }
\ No newline at end of file
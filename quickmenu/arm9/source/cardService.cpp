@@ -0,0 +1,127 @@
+#include "cardService.h"
+
+#include <string.h>
+
+#include "common/systemdetails.h"
+#include "read_card.h"
+
+#define CARD_TIMER 2
+#define CARD_RECORD_COUNT 4
+
+struct CardRecord {
+	bool reusable;
+	bool hasBanner;
+	sNDSHeaderExt header;
+	sNDSBannerExt banner;
+};
+
+static CardRecord records[CARD_RECORD_COUNT];
+static int nextRecord = 0;
+static CardRecord* current = NULL;	// NULL if the card couldn't be read
+
+static CardState state = CardState::Empty;
+static int resetStep = 0;
+static volatile bool delayDone = false;
+
+static void delayHandler(void) {
+	timerStop(CARD_TIMER);
+	delayDone = true;
+}
+
+static void startDelay(int frames) {
+	delayDone = false;
+	timerStart(CARD_TIMER, ClockDivider_1024, (u16)-(frames * (BUS_CLOCK >> 10) / 60), delayHandler);
+}
+
+static void readCard(void) {
+	current = NULL;
+
+	// Identify the card by its header before going through the secure area
+	u32 header[0x200/sizeof(u32)];
+	cardParamCommand (CARD_CMD_HEADER_READ, 0,
+		CARD_ACTIVATE | CARD_nRESET | CARD_CLK_SLOW | CARD_BLK_SIZE(1) | CARD_DELAY1(0x1FFF) | CARD_DELAY2(0x3F),
+		header, 0x200/sizeof(u32));
+
+	const u16 headerCRC = ((u16*)header)[0x15E/sizeof(u16)];
+	if (headerCRC == swiCRC16(0xFFFF, header, 0x15E)) {
+		for (int i = 0; i < CARD_RECORD_COUNT; i++) {
+			if (records[i].reusable && records[i].header.headerCRC16 == headerCRC && memcmp(&records[i].header, header, 0x160) == 0) {
+				current = &records[i];
+				return;
+			}
+		}
+	}
+
+	if (cardInit() != 0) {
+		return;
+	}
+
+	CardRecord* record = &records[nextRecord];
+	nextRecord = (nextRecord + 1) % CARD_RECORD_COUNT;
+
+	cardRead(0, &record->header, sizeof(sNDSHeaderExt));
+	record->hasBanner = (record->header.bannerOffset > 0);
+	if (record->hasBanner) {
+		cardRead(record->header.bannerOffset, &record->banner, NDS_BANNER_SIZE_DSi);
+	}
+	// The SuperCard DSTWO check reads past the banner, so always read that card
+	record->reusable = (memcmp(record->header.gameCode, "ALXX", 4) != 0);
+	current = record;
+}
+
+bool cardServiceUpdate(void) {
+	if (REG_SCFG_MC == 0x11) {
+		if (state == CardState::Empty) {
+			return false;
+		}
+		timerStop(CARD_TIMER);
+		state = CardState::Empty;
+		current = NULL;
+		return true;
+	}
+
+	switch (state) {
+		case CardState::Empty:
+			current = NULL;
+			if (sys().arm7SCFGLocked()) {
+				// Can't reset the card, so there's nothing to read
+				state = CardState::Ready;
+				return true;
+			}
+			resetStep = CARD_RESET_POWER_OFF;
+			startDelay(my_cardResetStep(resetStep));
+			state = CardState::Resetting;
+			return true;
+		case CardState::Resetting:
+			if (!delayDone) {
+				return false;
+			}
+			if (++resetStep < CARD_RESET_START) {
+				startDelay(my_cardResetStep(resetStep));
+				return false;
+			}
+			my_cardResetStep(CARD_RESET_START);
+			readCard();
+
+			// Power off after done retrieving info
+			disableSlot1();
+
+			state = CardState::Ready;
+			return true;
+		case CardState::Ready:
+			break;
+	}
+	return false;
+}
+
+CardState cardServiceState(void) {
+	return state;
+}
+
+const sNDSHeaderExt* cardServiceHeader(void) {
+	return current ? &current->header : NULL;
+}
+
+const sNDSBannerExt* cardServiceBanner(void) {
+	return (current && current->hasBanner) ? &current->banner : NULL;
+}
@@ -0,0 +1,31 @@
+#ifndef CARDSERVICE_H
+#define CARDSERVICE_H
+
+#include <nds.h>
+#include "ndsheaderbanner.h"
+
+enum class CardState {
+	Empty,		// No card in Slot-1
+	Resetting,	// Card inserted, waiting for it to power back on
+	Ready,		// Header and banner have been read (or can't be, if SCFG is locked)
+};
+
+/**
+ * Poll Slot-1 once per frame (DSi mode only). The card is reset over several
+ * frames using a hardware timer for the delays, instead of waiting for vblanks.
+ * The header and banner of the last few cards are kept, keyed by header CRC,
+ * so putting the same card back in doesn't read it again.
+ * Returns true if the state changed.
+ */
+bool cardServiceUpdate(void);
+
+CardState cardServiceState(void);
+
+/**
+ * The inserted card's header and banner, or NULL if they couldn't be read.
+ * Only valid when the state is Ready.
+ */
+const sNDSHeaderExt* cardServiceHeader(void);
+const sNDSBannerExt* cardServiceBanner(void);
+
+#endif // CARDSERVICE_H
@@ -5,7 +5,7 @@
 #include "common/systemdetails.h"
 #include "common/flashcard.h"
 #include "common/tonccpy.h"
-#include "common/inifile.h"
+#include "common/esrbDatabase.h"
 #include "common/logging.h"
 #include "graphics/fontHandler.h"
 #include "graphics/graphics.h"
@@ -13,8 +13,6 @@
 #include "ndsheaderbanner.h"
 #include "language.h"
 
-#include "dsGameInfoMap.h"
-
 extern u16 bmpImageBuffer[256*192];
 
 void createEsrbSplash(void) {
@@ -28,28 +26,18 @@ void createEsrbSplash(void) {
 		gameTid3[i] = gameTid[ms().secondaryDevice][i];
 	}
 
-	CIniFile esrbInfo("nitro:/ESRB.ini");
-	std::string rating = esrbInfo.GetString(gameTid3, "Rating", "");
-	if (rating == "") {
+	EsrbInfo esrbInfo;
+	if (!esrbLookup("nitro:/ESRB.bin", gameTid3, esrbInfo)) {
 		remove(sys().isRunFromSD() ? "sd:/_nds/nds-bootstrap/esrb.bin" : "fat:/_nds/nds-bootstrap/esrb.bin");
 		return;
 	}
 
-	std::string descriptors = esrbInfo.GetString(gameTid3, "Descriptors en", "");
-	const bool onlineNotice = esrbInfo.GetInt(gameTid3, "Online", 0);
-
-	bool sideways = false;
-	if ((rating == "E" || rating == "EC" || rating == "RP") && descriptors == "") {
-		// Search for games starting sideways
-		// TODO: If the list gets large enough, switch to bsearch().
-		for (unsigned int i = 0; i < sizeof(sidewaysGameList)/sizeof(sidewaysGameList[0]); i++) {
-			if (memcmp(gameTid[ms().secondaryDevice], sidewaysGameList[i], 3) == 0) {
-				// Found match
-				sideways = true;
-				break;
-			}
-		}
-	}
+	const std::string rating = esrbInfo.rating;
+	const std::string &descriptors = esrbInfo.descriptors;
+	const bool onlineNotice = esrbInfo.online;
+
+	// Only games starting sideways without descriptors have a sideways splash
+	const bool sideways = ((rating == "E" || rating == "EC" || rating == "RP") && descriptors == "" && esrbInfo.sideways);
 
 	char esrbImagePath[64];
 	if (rating == "E" && descriptors == "") {
@@ -33,10 +33,12 @@
 #include "graphics/fontHandler.h"
 #include "common/lodepng.h"
 #include "common/logging.h"
+#include "folderIndex.h"
 #include "ndsheaderbanner.h"
 #include "myDSiMode.h"
 #include "language.h"
 #include "read_card.h"
+#include "cardService.h"
 
 #include "extension.h"
 
@@ -316,7 +318,7 @@ void getGameInfo(int num, bool isDir, const char* name, bool fromArgv)
 
 		// First try banner bin
 		snprintf(customIconPath, sizeof(customIconPath), "%s:/_nds/TWiLightMenu/icons/%s.bin", sys().isRunFromSD() ? "sd" : "fat", name);
-		customIcon[num] = (access(customIconPath, F_OK) == 0);
+		customIcon[num] = (folderIndexExists(customIconPath));
 		if (customIcon[num]) {
 			customIcon[num] = 2; // custom icon is a banner bin
 			FILE *file = fopen(customIconPath, "rb");
@@ -343,7 +345,7 @@ void getGameInfo(int num, bool isDir, const char* name, bool fromArgv)
 		} else {
 			// If no banner bin, try png
 			snprintf(customIconPath, sizeof(customIconPath), "%s:/_nds/TWiLightMenu/icons/%s.png", sys().isRunFromSD() ? "sd" : "fat", name);
-			customIcon[num] = (access(customIconPath, F_OK) == 0);
+			customIcon[num] = (folderIndexExists(customIconPath));
 			if (customIcon[num]) {
 				std::vector<unsigned char> image;
 				uint imageWidth, imageHeight;
@@ -469,7 +471,11 @@ void getGameInfo(int num, bool isDir, const char* name, bool fromArgv)
 		bool isSlot1 = (strcmp(name, "slot1") == 0);
 
 		if (isSlot1) {
-			cardRead(0, &ndsHeader, sizeof(ndsHeader));
+			if (cardServiceHeader()) {
+				tonccpy(&ndsHeader, cardServiceHeader(), sizeof(ndsHeader));
+			} else {
+				toncset(&ndsHeader, 0, sizeof(ndsHeader));
+			}
 		} else {
 			// open file for reading info
 			fp = fopen(name, "rb");
@@ -596,8 +602,8 @@ void getGameInfo(int num, bool isDir, const char* name, bool fromArgv)
 			return;
 		}
 		if (isSlot1) {
-			if ((ndsCardHeader.bannerOffset > 0) && cardInited) {
-				cardRead(ndsCardHeader.bannerOffset, &ndsBanner, NDS_BANNER_SIZE_DSi);
+			if (cardServiceBanner()) {
+				tonccpy(&ndsBanner, cardServiceBanner(), NDS_BANNER_SIZE_DSi);
 			} else {
 				FILE* bannerFile = fopen("nitro:/noinfo.bnr", "rb");
 				fread(&ndsBanner, 1, NDS_BANNER_SIZE_ZH_KO, bannerFile);
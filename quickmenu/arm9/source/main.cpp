@@ -8,6 +8,7 @@
 #include <stdio.h>
 #include <fat.h>
 #include "fat_ext.h"
+#include "folderIndex.h"
 #include <sys/stat.h>
 #include <limits.h>
 
@@ -27,6 +28,9 @@
 
 #include "myDSiMode.h"
 #include "common/bootstrapsettings.h"
+#include "common/blockRom.h"
+#include "common/discCache.h"
+#include "common/dsiWareStaging.h"
 #include "common/fatHeader.h"
 #include "common/flashcard.h"
 #include "common/inifile.h"
@@ -37,7 +41,9 @@
 #include "common/systemdetails.h"
 #include "common/tonccpy.h"
 #include "common/twlmenusettings.h"
+#include "common/warmSwitch.h"
 #include "read_card.h"
+#include "cardService.h"
 #include "ndsheaderbanner.h"
 #include "gbaswitch.h"
 #include "perGameSettings.h"
@@ -80,7 +86,6 @@ extern bool showProgressBar;
 extern int progressBarLength;
 
 bool cardEjected = false;
-static bool cardRefreshed = false;
 
 extern void ClearBrightness();
 extern int boxArtType[2];
@@ -314,6 +319,7 @@ void unlaunchRomBoot(std::string_view rom) {
 	}
 	*(u16*)(0x0200080E) = swiCRC16(0xFFFF, (void*)0x02000810, 0x3F0);		// Unlaunch CRC16
 
+	discCacheFlushAll();
 	DC_FlushAll();						// Make reboot not fail
 	fifoSendValue32(FIFO_USER_02, 1);	// Reboot into DSiWare title, booted via Unlaunch
 	stop();
@@ -346,6 +352,7 @@ void ntrStartSdGame(void) {
 		unlaunchRomBoot("sd:/_nds/TWiLightMenu/main.srldr");
 	} else {
 		tonccpy((u32 *)0x02000300, autoboot_bin, 0x20);
+		discCacheFlushAll();
 		DC_FlushAll();						// Make reboot not fail
 		fifoSendValue32(FIFO_USER_02, 1);
 		stop();
@@ -365,6 +372,7 @@ void dsCardLaunch() {
 
 	unlaunchSetHiyaBoot();
 
+	discCacheFlushAll();
 	DC_FlushAll();						// Make reboot not fail
 	fifoSendValue32(FIFO_USER_02, 1);	// Reboot into DSiWare title, booted via Launcher
 	stop();
@@ -398,29 +406,34 @@ void SetWidescreen(const char *filename) {
 	char wideBinPath[256];
 	if (ms().launchType[ms().secondaryDevice] == 1) {
 		snprintf(wideBinPath, sizeof(wideBinPath), "sd:/_nds/TWiLightMenu/extras/widescreen/%s.bin", filename);
-		wideCheatFound = (access(wideBinPath, F_OK) == 0);
+		wideCheatFound = folderIndexExists(wideBinPath);
 	}
 
 	char s1GameTid[5];
 
 	if (ms().slot1Launched) {
-		// Reset Slot-1 to allow reading card header
-		sysSetCardOwner (BUS_OWNER_ARM9);
-		disableSlot1();
-		for (int i = 0; i < 25; i++) { swiWaitForVBlank(); }
-		enableSlot1();
-		for (int i = 0; i < 15; i++) { swiWaitForVBlank(); }
-
-		cardReadHeader((uint8*)&ndsCardHeader);
+		if (cardServiceState() == CardState::Ready && cardServiceHeader()) {
+			// Already read when the card was inserted
+			tonccpy(&ndsCardHeader, cardServiceHeader(), sizeof(sNDSHeaderExt));
+		} else {
+			// Reset Slot-1 to allow reading card header
+			sysSetCardOwner (BUS_OWNER_ARM9);
+			disableSlot1();
+			for (int i = 0; i < 25; i++) { swiWaitForVBlank(); }
+			enableSlot1();
+			for (int i = 0; i < 15; i++) { swiWaitForVBlank(); }
+
+			cardReadHeader((uint8*)&ndsCardHeader);
+		}
 
 		tonccpy(s1GameTid, ndsCardHeader.gameCode, 4);
 		s1GameTid[4] = 0;
 
 		snprintf(wideBinPath, sizeof(wideBinPath), "sd:/_nds/TWiLightMenu/extras/widescreen/%s-%X.bin", s1GameTid, ndsCardHeader.headerCRC16);
-		wideCheatFound = (access(wideBinPath, F_OK) == 0);
+		wideCheatFound = folderIndexExists(wideBinPath);
 	} else if (!wideCheatFound) {
 		snprintf(wideBinPath, sizeof(wideBinPath), "sd:/_nds/TWiLightMenu/extras/widescreen/%s-%X.bin", gameTid[ms().secondaryDevice], headerCRC[ms().secondaryDevice]);
-		wideCheatFound = (access(wideBinPath, F_OK) == 0);
+		wideCheatFound = folderIndexExists(wideBinPath);
 	}
 
 	if (isHomebrew[ms().secondaryDevice]) {
@@ -537,7 +550,7 @@ void SetWidescreen(const char *filename) {
 std::string getGameManual(const char *filename) {
 	char manualPath[256];
 	snprintf(manualPath, sizeof(manualPath), "%s:/_nds/TWiLightMenu/extras/manuals/%s.txt", sys().isRunFromSD() ? "sd" : "fat", filename);
-	if (access(manualPath, F_OK) == 0)
+	if (folderIndexExists(manualPath))
 		return manualPath;
 
 	FILE *f_nds_file = fopen(filename, "rb");
@@ -549,11 +562,11 @@ std::string getGameManual(const char *filename) {
 		game_TID[4] = 0;
 
 		snprintf(manualPath, sizeof(manualPath), "%s:/_nds/TWiLightMenu/extras/manuals/%s.txt", sys().isRunFromSD() ? "sd" : "fat", game_TID);
-		if (access(manualPath, F_OK) == 0)
+		if (folderIndexExists(manualPath))
 			return manualPath;
 
 		snprintf(manualPath, sizeof(manualPath), "%s:/_nds/TWiLightMenu/extras/manuals/%.3s.txt", sys().isRunFromSD() ? "sd" : "fat", game_TID);
-		if (access(manualPath, F_OK) == 0)
+		if (folderIndexExists(manualPath))
 			return manualPath;
 	}
 
@@ -993,36 +1006,21 @@ void printLastPlayedText(int num) {
 	printSmall(false, BOX_PX, iconYpos[num] + BOX_PY - (calcSmallFontHeight(STR_LAST_PLAYED_HERE) / 2), STR_LAST_PLAYED_HERE, Alignment::center);
 }
 
-void refreshNdsCard(bool refreshBoxArt) {
-	if (cardRefreshed) return;
+/**
+ * Poll the card service, and load the card's icon and title once it has been read.
+ * Returns true if the card's banner text needs to be redrawn.
+ */
+bool refreshNdsCard(void) {
+	if (!cardServiceUpdate()) return false;
 
-	if (sys().arm7SCFGLocked() && refreshBoxArt) {
-		//loadBoxArt("nitro:/graphics/boxart_unknown.png", true);
-	} else {
-		my_cardReset(true);
-		cardInit();
-		/* if ((cardInit() == 0) && refreshBoxArt) {
-			char game_TID[5] = {0};
-			tonccpy(&game_TID, ndsCardHeader.gameCode, 4);
-
-			char boxArtPath[256];
-			sprintf (boxArtPath, (sys().isRunFromSD() ? "sd:/_nds/TWiLightMenu/boxart/%s.png" : "fat:/_nds/TWiLightMenu/boxart/%s.png"), game_TID);
-			//loadBoxArt(boxArtPath, true);	// Load box art
-		} else if (refreshBoxArt) {
-			//loadBoxArt("nitro:/graphics/boxart_unknown.png", true);
-		} */
-	}
-
-	getGameInfo(1, false, "slot1", false);
-	iconUpdate (1, false, "slot1");
-	bnrRomType[1] = ROM_TYPE_NDS;
-	boxArtType[1] = 0;
-
-	// Power off after done retrieving info
-	disableSlot1();
-
-	cardRefreshed = true;
-	cardEjected = false;
+	cardEjected = (cardServiceState() != CardState::Ready);
+	if (!cardEjected) {
+		getGameInfo(1, false, "slot1", false);
+		iconUpdate (1, false, "slot1");
+		bnrRomType[1] = ROM_TYPE_NDS;
+		boxArtType[1] = 0;
+	}
+	return true;
 }
 
 void printNdsCartBannerText() {
@@ -1321,6 +1319,7 @@ int dsClassicMenu(void) {
 	ms().loadSettings();
 	bs().loadSettings();
 	logInit();
+	logPrint("Warm switch: %lu sector reads saved\n", (unsigned long)warmSwitchReadsSaved());
 	//widescreenEffects = (ms().consoleModel >= 2 && ms().wideScreen && access("sd:/luma/sysmodules/TwlBg.cxi", F_OK) == 0);
 	if (sdFound() && ms().consoleModel >= 2 && !sys().arm7SCFGLocked()) {
 		CIniFile lumaConfig("sd:/luma/config.ini");
@@ -1401,14 +1400,20 @@ int dsClassicMenu(void) {
 		printSmall(false, 0, 86, STR_NOW_COPYING_DATA, Alignment::center);
 		printSmall(false, 0, 100, STR_DO_NOT_TURN_OFF_POWER, Alignment::center);
 		for (int i = 0; i < 30; i++) swiWaitForVBlank();
+		DSiWareStagingStats stagingStats = {0, 0};
 		if (access(ms().dsiWarePubPath.c_str(), F_OK) == 0) {
-			fcopy("sd:/_nds/TWiLightMenu/tempDSiWare.pub", ms().dsiWarePubPath.c_str());
-			rename("sd:/_nds/TWiLightMenu/tempDSiWare.pub", "sd:/_nds/TWiLightMenu/tempDSiWare.pub.bak");
+			// Kept for a relaunch, or copied back again next time if this failed
+			if (dsiWareSyncFile("sd:/_nds/TWiLightMenu/tempDSiWare.pub", ms().dsiWarePubPath.c_str(), &stagingStats)) {
+				rename("sd:/_nds/TWiLightMenu/tempDSiWare.pub", "sd:/_nds/TWiLightMenu/tempDSiWare.pub.bak");
+			}
 		}
 		if (access(ms().dsiWarePrvPath.c_str(), F_OK) == 0) {
-			fcopy("sd:/_nds/TWiLightMenu/tempDSiWare.prv", ms().dsiWarePrvPath.c_str());
-			rename("sd:/_nds/TWiLightMenu/tempDSiWare.prv", "sd:/_nds/TWiLightMenu/tempDSiWare.prv.bak");
+			// Kept for a relaunch, or copied back again next time if this failed
+			if (dsiWareSyncFile("sd:/_nds/TWiLightMenu/tempDSiWare.prv", ms().dsiWarePrvPath.c_str(), &stagingStats)) {
+				rename("sd:/_nds/TWiLightMenu/tempDSiWare.prv", "sd:/_nds/TWiLightMenu/tempDSiWare.prv.bak");
+			}
 		}
+		logPrint("Copied DSiWare save back to flashcard (%lu bytes written)\n", stagingStats.bytesWritten);
 		fadeType = false;	// Fade to white
 		for (int i = 0; i < 30; i++) swiWaitForVBlank();
 		clearText(false);
@@ -1458,12 +1463,9 @@ int dsClassicMenu(void) {
 	//}
 
 	if (isDSiMode() && !flashcardFound()) {
-		if (REG_SCFG_MC == 0x11) {
-			cardEjected = true;
-			//if (ms().showBoxArt && ms().slot1Launched) loadBoxArt("nitro:/graphics/boxart_unknown.png", true);
-		} else {
-			refreshNdsCard(ms().showBoxArt && ms().slot1Launched);
-		}
+		// The card is read while fading in
+		cardEjected = true;
+		refreshNdsCard();
 	}
 
 	topBarLoad();
@@ -1486,6 +1488,9 @@ int dsClassicMenu(void) {
 		// if (preloadNds(filename[ms().secondaryDevice].c_str())) {
 			swiWaitForVBlank();
 		// }
+		if (isDSiMode() && !flashcardFound()) {
+			refreshNdsCard();
+		}
 	}
 
 	startMenu = true;	// Show bottom screen graphics
@@ -1534,18 +1539,8 @@ int dsClassicMenu(void) {
 					batteryIconDraw(true);
 				}
 
-				if (isDSiMode() && !flashcardFound()) {
-					if (REG_SCFG_MC == 0x11) {
-						//if (cardRefreshed && ms().showBoxArt) {
-						//	loadBoxArt(ms().slot1Launched ? "nitro:/graphics/boxart_unknown.png" : boxArtPath[ms().previousUsedDevice], ms().slot1Launched ? true : ms().previousUsedDevice);
-						//}
-						cardRefreshed = false;
-						cardEjected = true;
-						updateMenuText = true;
-					} else if (cardEjected) {
-						refreshNdsCard(ms().showBoxArt);
-						updateMenuText = true;
-					}
+				if (isDSiMode() && !flashcardFound() && refreshNdsCard()) {
+					updateMenuText = true;
 				}
 
 				if (updateMenuText) {
@@ -1865,6 +1860,7 @@ int dsClassicMenu(void) {
 									unlaunchSetHiyaBoot();
 								}
 
+								discCacheFlushAll();
 								DC_FlushAll();						// Make reboot not fail
 								fifoSendValue32(FIFO_USER_02, 1); // Reboot into DSiWare title, booted via Launcher
 								for (int i = 0; i < 15; i++) swiWaitForVBlank();
@@ -1952,6 +1948,7 @@ int dsClassicMenu(void) {
 									unlaunchSetHiyaBoot();
 								}
 
+								discCacheFlushAll();
 								DC_FlushAll();						// Make reboot not fail
 								fifoSendValue32(FIFO_USER_02, 1); // Reboot into DSiWare title, booted via Launcher
 								for (int i = 0; i < 15; i++) swiWaitForVBlank();
@@ -2132,6 +2129,7 @@ int dsClassicMenu(void) {
 				} else {
 					unlaunchRomBoot(launcherPath);
 				}
+				discCacheFlushAll();
 				fifoSendValue32(FIFO_USER_02, 1);	// ReturntoDSiMenu
 			}
 
@@ -2141,22 +2139,15 @@ int dsClassicMenu(void) {
 		// Launch the item
 
 		if (applaunch) {
-			// Delete previously launched DSiWare copied from flashcard to SD
-			if (access("sd:/_nds/TWiLightMenu/tempDSiWare.dsi", F_OK) == 0) {
-				remove("sd:/_nds/TWiLightMenu/tempDSiWare.dsi");
-			}
-			if (access("sd:/_nds/TWiLightMenu/tempDSiWare.pub.bak", F_OK) == 0) {
-				remove("sd:/_nds/TWiLightMenu/tempDSiWare.pub.bak");
-			}
-			if (access("sd:/_nds/TWiLightMenu/tempDSiWare.prv.bak", F_OK) == 0) {
-				remove("sd:/_nds/TWiLightMenu/tempDSiWare.prv.bak");
-			}
-			if (access("sd:/_nds/nds-bootstrap/patchOffsetCache/tempDSiWare.bin", F_OK) == 0) {
+			chdir(romfolder[ms().secondaryDevice].c_str());
+
+			// Drop what was copied from flashcard to SD for the last DSiWare launch,
+			// unless the same DSiWare is being launched again
+			if (!dsiWareStagedFrom(filename[ms().secondaryDevice].c_str(), "sd:/_nds/TWiLightMenu/tempDSiWare.dsi")) {
+				dsiWareUnstage("sd:/_nds/TWiLightMenu/tempDSiWare.dsi");
 				remove("sd:/_nds/nds-bootstrap/patchOffsetCache/tempDSiWare.bin");
 			}
 
-			chdir(romfolder[ms().secondaryDevice].c_str());
-
 			// Construct a command line
 			getcwd (filePath, PATH_MAX);
 			int pathLen = strlen(filePath);
@@ -2329,13 +2320,20 @@ int dsClassicMenu(void) {
 					printSmall(false, 0, 100, STR_DO_NOT_TURN_OFF_POWER, Alignment::center);
 					fadeType = true;	// Fade in from white
 					for (int i = 0; i < 35; i++) swiWaitForVBlank();
-					fcopy(ms().dsiWareSrlPath.c_str(), "sd:/_nds/TWiLightMenu/tempDSiWare.dsi");
+					DSiWareStagingStats stagingStats = {0, 0};
+					if (dsiWareStageSrl(ms().dsiWareSrlPath.c_str(), "sd:/_nds/TWiLightMenu/tempDSiWare.dsi", &stagingStats) == EStageCopied) {
+						// Cached patch offsets belong to the previously staged DSiWare
+						remove("sd:/_nds/nds-bootstrap/patchOffsetCache/tempDSiWare.bin");
+					}
 					if ((access(ms().dsiWarePubPath.c_str(), F_OK) == 0) && (NDSHeader.pubSavSize > 0)) {
-						fcopy(ms().dsiWarePubPath.c_str(), "sd:/_nds/TWiLightMenu/tempDSiWare.pub");
+						dsiWareRestoreSave("sd:/_nds/TWiLightMenu/tempDSiWare.pub");
+						dsiWareSyncFile(ms().dsiWarePubPath.c_str(), "sd:/_nds/TWiLightMenu/tempDSiWare.pub", &stagingStats);
 					}
 					if ((access(ms().dsiWarePrvPath.c_str(), F_OK) == 0) && (NDSHeader.prvSavSize > 0)) {
-						fcopy(ms().dsiWarePrvPath.c_str(), "sd:/_nds/TWiLightMenu/tempDSiWare.prv");
+						dsiWareRestoreSave("sd:/_nds/TWiLightMenu/tempDSiWare.prv");
+						dsiWareSyncFile(ms().dsiWarePrvPath.c_str(), "sd:/_nds/TWiLightMenu/tempDSiWare.prv", &stagingStats);
 					}
+					logPrint("Staged DSiWare on SD (%lu bytes read, %lu bytes written)\n", stagingStats.bytesRead, stagingStats.bytesWritten);
 					fadeType = false;	// Fade to white
 
 					if ((access(ms().dsiWarePubPath.c_str(), F_OK) == 0 && (NDSHeader.pubSavSize > 0))
@@ -2882,6 +2880,7 @@ int dsClassicMenu(void) {
 				bool boostCpu = true;
 				bool boostVram = false;
 				bool tscTgds = false;
+				bool romUnreadable = false; // Block ROM which can't be read, or isn't going to the native GBA path
 				int romToRamDisk = -1;
 
 				std::string romfolderNoSlash = romfolder[ms().secondaryDevice];
@@ -2959,16 +2958,18 @@ int dsClassicMenu(void) {
 						progressBarLength = 0;
 
 						u32 ptr = 0x08000000;
-						u32 romSize = getFileSize(filename[ms().secondaryDevice].c_str());
 						char titleID[4];
 						FILE* gbaFile = fopen(filename[ms().secondaryDevice].c_str(), "rb");
+						BlockRom gbaRom;
+						romUnreadable = !blockRomOpen(&gbaRom, gbaFile); // Block ROMs are read as if uncompressed
+						u32 romSize = gbaRom.romSize;
 						fseek(gbaFile, 0xAC, SEEK_SET);
 						fread(&titleID, 1, 4, gbaFile);
 						if (strncmp(titleID, "AGBJ", 4) == 0 && romSize <= 0x40000) {
 							ptr += 0x400;
 						}
 						u32 curPtr = ptr;
-						fseek(gbaFile, 0, SEEK_SET);
+						blockRomSeek(&gbaRom, 0);
 
 						extern char copyBuf[0x8000];
 						if (romSize > 0x2000000) romSize = 0x2000000;
@@ -2993,7 +2994,7 @@ int dsClassicMenu(void) {
 						updateText(false);
 
 						for (u32 len = romSize; len > 0; len -= 0x8000) {
-							if (fread(&copyBuf, 1, (len>0x8000 ? 0x8000 : len), gbaFile) > 0) {
+							if (blockRomRead(&gbaRom, &copyBuf, (len>0x8000 ? 0x8000 : len)) > 0) {
 								s2RamAccess(true);
 								if (nor) {
 									expansion().WriteNorFlash(curPtr-ptr, (u8*)copyBuf, (len>0x8000 ? 0x8000 : len));
@@ -3007,7 +3008,8 @@ int dsClassicMenu(void) {
 								break;
 							}
 						}
-						fclose(gbaFile);
+						blockRomClose(&gbaRom);
+						if (gbaFile) fclose(gbaFile);
 
 						ptr = 0x0A000000;
 
@@ -3015,7 +3017,7 @@ int dsClassicMenu(void) {
 						u32 savesize = getFileSize(savename.c_str());
 						if (savesize > 0x10000) savesize = 0x10000;
 
-						if (savesize > 0) {
+						if (savesize > 0 && !romUnreadable) {
 							FILE* savFile = fopen(savename.c_str(), "rb");
 							for (u32 len = savesize; len > 0; len -= 0x8000) {
 								if (fread(&copyBuf, 1, (len>0x8000 ? 0x8000 : len), savFile) > 0) {
@@ -3350,8 +3352,14 @@ int dsClassicMenu(void) {
 				}
 				argarray.at(0) = (char *)(tgdsMode ? tgdsNdsPath : ndsToBoot);
 
+				// GBARunner2 and the emulators open the ROM themselves, and can't read block ROMs
+				if (ms().launchType[ms().secondaryDevice] != TWLSettings::EGBANativeLaunch && blockRomIsPacked(ROMpath)) {
+					romUnreadable = true;
+				}
 				int err = 0;
-				if (ms().btsrpBootloaderDirect && useNDSB) {
+				if (romUnreadable) {
+					err = BLOCK_ROM_START_ERROR;
+				} else if (ms().btsrpBootloaderDirect && useNDSB) {
 					if (access(ms().bootstrapFile ? "sd:/_nds/nds-bootstrap-hb-nightly.nds" : "sd:/_nds/nds-bootstrap-hb-release.nds", F_OK) == 0) {
 						bool romIsCompressed = false;
 						if (romToRamDisk == 0) {
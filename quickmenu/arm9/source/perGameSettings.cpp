@@ -15,6 +15,7 @@
 #include "common/inifile.h"
 #include "common/flashcard.h"
 #include "common/nds_loader_arm9.h"
+#include "folderIndex.h"
 
 int perGameSettings_cursorPosition = 0;
 bool perGameSettings_directBoot = false;	// Homebrew only
@@ -38,7 +39,10 @@ char pergamefilepath[256];
 
 void loadPerGameSettings (std::string filename) {
 	snprintf(pergamefilepath, sizeof(pergamefilepath), "%s/_nds/TWiLightMenu/gamesettings/%s.ini", (ms().secondaryDevice ? "fat:" : "sd:"), filename.c_str());
-	CIniFile pergameini(pergamefilepath);
+	CIniFile pergameini;
+	if (folderIndexExists(pergamefilepath)) {
+		pergameini.LoadIniFile(pergamefilepath);
+	}
 	perGameSettings_directBoot = pergameini.GetInt("GAMESETTINGS", "DIRECT_BOOT", (isModernHomebrew[ms().secondaryDevice] || ms().secondaryDevice));	// Homebrew only
 	if (isHomebrew[ms().secondaryDevice]) {
 		perGameSettings_dsiMode = pergameini.GetInt("GAMESETTINGS", "DSI_MODE", (isModernHomebrew[ms().secondaryDevice] ? true : false));
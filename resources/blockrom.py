@@ -0,0 +1,171 @@
+#!/usr/bin/env python
+
+# Packs a ROM into a block ROM for TWiLight Menu++, or unpacks one.
+#
+# The ROM is split into chunks which are compressed on their own with the
+# DS BIOS' LZ77 format, so the menu can start reading anywhere and only
+# has to decompress the chunks it needs. See universal/include/common/blockRom.h
+# for the layout.
+
+import argparse
+import struct
+
+MAGIC = b"BLZR"
+VERSION = 1
+CODEC_LZ77 = 0x10
+FLAG_CRC = 1 << 0
+STORED = 1 << 31
+HEADER_SIZE = 0xC0
+
+MIN_MATCH = 3
+MAX_MATCH = 18
+WINDOW = 0x1000
+MAX_CHAIN = 32
+
+
+def crc16(data):
+	# CRC-16/MODBUS, as swiCRC16 with an initial value of 0xFFFF
+	crc = 0xFFFF
+	for byte in data:
+		crc ^= byte
+		for _ in range(8):
+			crc = (crc >> 1) ^ 0xA001 if crc & 1 else crc >> 1
+	return crc
+
+
+def lz77_compress(data):
+	out = bytearray(struct.pack("<I", CODEC_LZ77 | (len(data) << 8)))
+	heads = {}
+	chain = [0] * len(data)
+	pos = 0
+	while pos < len(data):
+		flag_pos = len(out)
+		out.append(0)
+		flags = 0
+		for bit in range(8):
+			if pos >= len(data):
+				break
+
+			best_len = 0
+			best_dist = 0
+			if pos + MIN_MATCH <= len(data):
+				key = data[pos:pos + MIN_MATCH]
+				candidate = heads.get(key, -1)
+				max_len = min(MAX_MATCH, len(data) - pos)
+				tries = 0
+				while candidate >= 0 and pos - candidate <= WINDOW and tries < MAX_CHAIN:
+					length = MIN_MATCH
+					while length < max_len and data[candidate + length] == data[pos + length]:
+						length += 1
+					if length > best_len:
+						best_len = length
+						best_dist = pos - candidate
+						if length == max_len:
+							break
+					candidate = chain[candidate]
+					tries += 1
+
+			step = best_len if best_len >= MIN_MATCH else 1
+			for i in range(pos, min(pos + step, len(data) - MIN_MATCH + 1)):
+				key = data[i:i + MIN_MATCH]
+				chain[i] = heads.get(key, -1)
+				heads[key] = i
+
+			if best_len >= MIN_MATCH:
+				flags |= 0x80 >> bit
+				disp = best_dist - 1
+				out.append(((best_len - MIN_MATCH) << 4) | (disp >> 8))
+				out.append(disp & 0xFF)
+			else:
+				out.append(data[pos])
+			pos += step
+		out[flag_pos] = flags
+
+	while len(out) % 4:
+		out.append(0)
+	return bytes(out)
+
+
+def lz77_decompress(data):
+	length = struct.unpack_from("<I", data)[0] >> 8
+	out = bytearray()
+	pos = 4
+	while len(out) < length:
+		flags = data[pos]
+		pos += 1
+		for bit in range(8):
+			if len(out) >= length:
+				break
+			if flags & (0x80 >> bit):
+				a, b = data[pos], data[pos + 1]
+				pos += 2
+				dist = (((a & 0xF) << 8) | b) + 1
+				for _ in range((a >> 4) + MIN_MATCH):
+					out.append(out[-dist])
+			else:
+				out.append(data[pos])
+				pos += 1
+	return bytes(out[:length])
+
+
+def pack(rom, chunk_size, use_crc):
+	chunks = [rom[i:i + chunk_size] for i in range(0, len(rom), chunk_size)]
+	index_offset = HEADER_SIZE
+	offset = index_offset + len(chunks) * 12
+
+	index = bytearray()
+	body = bytearray()
+	for chunk in chunks:
+		packed = lz77_compress(chunk)
+		if len(packed) >= len(chunk):
+			packed = chunk
+			size = len(chunk) | STORED
+		else:
+			size = len(packed)
+		index += struct.pack("<III", offset + len(body), size, crc16(chunk) if use_crc else 0)
+		body += packed
+		while len(body) % 4:
+			body.append(0)
+
+	header = bytearray(HEADER_SIZE)
+	struct.pack_into("<4sHBBIIII", header, 0, MAGIC, VERSION, CODEC_LZ77, FLAG_CRC if use_crc else 0, chunk_size, len(rom), len(chunks), index_offset)
+	header[0xA0:0xC0] = rom[0xA0:0xC0].ljust(0x20, b"\0")
+	return bytes(header + index + body)
+
+
+def unpack(data):
+	magic, version, codec, flags, chunk_size, rom_size, count, index_offset = struct.unpack_from("<4sHBBIIII", data)
+	if magic != MAGIC or version != VERSION or codec != CODEC_LZ77:
+		raise ValueError("not a block ROM")
+
+	rom = bytearray()
+	for i in range(count):
+		offset, size, crc = struct.unpack_from("<III", data, index_offset + i * 12)
+		if size & STORED:
+			chunk = data[offset:offset + (size & ~STORED)]
+		else:
+			chunk = lz77_decompress(data[offset:offset + size])
+		if flags & FLAG_CRC and crc16(chunk) != crc:
+			raise ValueError("CRC mismatch in chunk %d" % i)
+		rom += chunk
+	if len(rom) != rom_size:
+		raise ValueError("size mismatch")
+	return bytes(rom)
+
+
+if __name__ == "__main__":
+	parser = argparse.ArgumentParser(description="Packs a ROM into a block ROM for TWiLight Menu++, or unpacks one")
+	parser.add_argument("input", type=str, help="ROM to pack, or block ROM to unpack")
+	parser.add_argument("-o", "--output", type=str, required=True, help="file to output to")
+	parser.add_argument("-u", "--unpack", action="store_true", help="unpack instead of packing")
+	parser.add_argument("-c", "--chunk-size", type=int, default=128, choices=[64, 128, 256], help="chunk size in KB (default: 128)")
+	parser.add_argument("--no-crc", action="store_true", help="don't store a CRC16 of each chunk")
+	args = parser.parse_args()
+
+	with open(args.input, "rb") as f:
+		data = f.read()
+
+	output = unpack(data) if args.unpack else pack(data, args.chunk_size * 1024, not args.no_crc)
+
+	with open(args.output, "wb") as f:
+		f.write(output)
@@ -0,0 +1,80 @@
+#!/usr/bin/env python
+
+# Converts ESRB.ini into a sorted, fixed-record database for TWiLight Menu++,
+# so a title's rating can be found with a binary search instead of loading
+# and tokenizing the whole INI.
+#
+# Output format (little endian):
+#   Header:  "ESRB", u32 record count, u32 string table offset, u32 string table size
+#   Records: char tid[3], u8 flags (bit 0: online, bit 1: starts sideways),
+#            char rating[4] (zero padded), u32 descriptors offset (0: none)
+#            Sorted by TID.
+#   Strings: zero terminated descriptor lists, relative to the string table
+
+import argparse
+import io
+import struct
+
+parser = argparse.ArgumentParser(description="Converts ESRB.ini into a binary database for TWiLight Menu++")
+parser.add_argument("input", metavar="ESRB.ini", type=str, help="INI file to convert")
+parser.add_argument("-o", "--output", metavar="ESRB.bin", type=str, required=True, help="file to output to")
+
+args = parser.parse_args()
+
+FLAG_ONLINE = 1 << 0
+FLAG_SIDEWAYS = 1 << 1
+
+sections = {}
+order = []
+section = None
+with io.open(args.input, "r", encoding="utf-8-sig") as f:
+	for line in f:
+		line = line.strip()
+		if not line or line[0] in ";/!":
+			continue
+		if line[0] == "[" and "]" in line:
+			section = line[1:line.index("]")]
+			if section in sections:
+				section = None  # Only the first section of a TID is used, as with CIniFile
+			else:
+				sections[section] = {}
+				order.append(section)
+		elif section is not None and "=" in line:
+			key, value = line.split("=", 1)
+			key = key.strip()
+			if key not in sections[section]:
+				sections[section][key] = value.strip()
+
+records = []
+strings = b"\x00"  # Offset 0 means no descriptors
+for tid in order:
+	keys = sections[tid]
+	rating = keys.get("Rating", "")
+	if len(tid) != 3 or rating == "":
+		continue
+	if len(rating) > 4:
+		raise SystemExit("[%s]: rating '%s' is too long" % (tid, rating))
+
+	flags = 0
+	if int(keys.get("Online", "0"), 0):
+		flags |= FLAG_ONLINE
+	if int(keys.get("Sideways", "0"), 0):
+		flags |= FLAG_SIDEWAYS
+
+	descriptorsOffset = 0
+	descriptors = keys.get("Descriptors en", "")
+	if descriptors:
+		descriptorsOffset = len(strings)
+		strings += descriptors.encode("utf-8") + b"\x00"
+
+	records.append((tid.encode("ascii"), flags, rating.encode("ascii"), descriptorsOffset))
+
+records.sort(key=lambda x: x[0])
+
+with open(args.output, "wb") as f:
+	stringsOffset = 16 + len(records) * 12
+	f.write(b"ESRB")
+	f.write(struct.pack("<LLL", len(records), stringsOffset, len(strings)))
+	for tid, flags, rating, descriptorsOffset in records:
+		f.write(struct.pack("<3sB4sL", tid, flags, rating, descriptorsOffset))
+	f.write(strings)
@@ -0,0 +1,216 @@
+#!/usr/bin/env python
+
+# Picks which functions of a module to put in ITCM, from the PC samples of a
+# profiling build (make PROFILE=1) and that build's linker map.
+#
+# The profiling build is built with -ffunction-sections, so the map has an
+# input section for each function. Samples are added up per function, and
+# the functions with the most samples per byte are picked until the free
+# ITCM runs out. The list is written for the module's arm9 Makefile, which
+# moves the picked sections to ITCM. See universal/include/common/pcProfiler.h.
+
+import argparse
+import re
+
+BUCKET_SIZE = 16
+
+OUTPUT_SECTION = re.compile(r"^(\.\S+)(?:\s+0x([0-9a-f]+)\s+0x([0-9a-f]+))?")
+INPUT_SECTION = re.compile(r"^ (\.\S+)(?:\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(.+))?$")
+SECTION_ADDRESS = re.compile(r"^\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(.+)$")
+SYMBOL = re.compile(r"^\s+0x([0-9a-f]+)\s+([^=]+)$")
+MEMORY = re.compile(r"^(\w+)\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)")
+
+
+class Function:
+	def __init__(self, section, output, address, size, obj):
+		self.section = section
+		self.output = output
+		self.address = address
+		self.size = size
+		self.obj = obj
+		self.name = None
+		self.samples = 0
+
+	def movable(self):
+		# Only the module's own objects are rewritten, not library members
+		return (self.output == ".text" and self.section.startswith(".text.")
+				and not self.section.startswith(".text.unlikely") and "(" not in self.obj)
+
+
+def read_map(path):
+	memory = {}
+	outputs = {}
+	functions = []
+	in_memory = False
+	in_map = False
+	output = None
+	pending = None
+	current = None
+
+	with open(path) as f:
+		for line in f:
+			line = line.rstrip("\n")
+			if line.startswith("Memory Configuration"):
+				in_memory = True
+				continue
+			if line.startswith("Linker script and memory map"):
+				in_memory = False
+				in_map = True
+				continue
+			if in_memory:
+				m = MEMORY.match(line)
+				if m and m.group(1) != "Name":
+					memory[m.group(1)] = (int(m.group(2), 16), int(m.group(3), 16))
+				continue
+			if not in_map or not line.strip():
+				continue
+
+			if not line.startswith(" "):
+				m = OUTPUT_SECTION.match(line)
+				if m:
+					output = m.group(1)
+					if m.group(2):
+						outputs[output] = (int(m.group(2), 16), int(m.group(3), 16))
+					else:
+						pending = ("output", output)
+					current = None
+				continue
+
+			if pending:
+				m = SECTION_ADDRESS.match(line) if pending[0] == "input" else re.match(r"^\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)", line)
+				kind, name = pending
+				pending = None
+				if m:
+					if kind == "output":
+						outputs[name] = (int(m.group(1), 16), int(m.group(2), 16))
+					else:
+						current = add_section(functions, name, output, int(m.group(1), 16), int(m.group(2), 16), m.group(3))
+					continue
+
+			m = INPUT_SECTION.match(line)
+			if m:
+				if m.group(2):
+					current = add_section(functions, m.group(1), output, int(m.group(2), 16), int(m.group(3), 16), m.group(4))
+				else:
+					pending = ("input", m.group(1))
+					current = None
+				continue
+
+			m = SYMBOL.match(line)
+			if m and current and not m.group(2).startswith("0x"):
+				add_symbol(functions, current, int(m.group(1), 16), m.group(2).strip())
+
+	return memory, outputs, functions
+
+
+def add_section(functions, section, output, address, size, obj):
+	if size == 0 or not section.startswith((".text", ".itcm")) or output not in (".text", ".itcm"):
+		return None
+	function = Function(section, output, address, size, obj.strip())
+	functions.append(function)
+	return function
+
+
+def add_symbol(functions, current, address, name):
+	if current.name is None and address == current.address:
+		current.name = name
+		return
+	# Sections holding several functions (hand placed ITCM code, objects
+	# without -ffunction-sections) are split at their symbols
+	if current.address < address < current.address + current.size:
+		end = current.address + current.size
+		current.size = address - current.address
+		split = Function(current.section, current.output, address, end - address, current.obj)
+		split.name = name
+		functions.insert(functions.index(current) + 1, split)
+
+
+def read_samples(paths):
+	samples = {}
+	for path in paths:
+		with open(path) as f:
+			for line in f:
+				fields = line.split()
+				if len(fields) != 2 or line.startswith("#"):
+					continue
+				address = int(fields[0], 16)
+				samples[address] = samples.get(address, 0) + int(fields[1], 16)
+	return samples
+
+
+def assign(functions, samples):
+	ordered = sorted(functions, key=lambda function: function.address)
+	starts = [function.address for function in ordered]
+	unknown = 0
+	for address, count in samples.items():
+		# Attribute the bucket to the function its middle falls in
+		pc = address + BUCKET_SIZE // 2
+		lo, hi = 0, len(starts)
+		while lo < hi:
+			mid = (lo + hi) // 2
+			if starts[mid] <= pc:
+				lo = mid + 1
+			else:
+				hi = mid
+		if lo and pc < ordered[lo - 1].address + ordered[lo - 1].size:
+			ordered[lo - 1].samples += count
+		else:
+			unknown += count
+	return unknown
+
+
+def pick(functions, budget, min_samples):
+	candidates = [f for f in functions if f.movable() and f.samples >= min_samples]
+	candidates.sort(key=lambda f: f.samples / float(f.size), reverse=True)
+	picked = []
+	for function in candidates:
+		# 4 byte alignment, as the linker places them
+		size = (function.size + 3) & ~3
+		if size <= budget:
+			picked.append(function)
+			budget -= size
+	return picked, budget
+
+
+if __name__ == "__main__":
+	parser = argparse.ArgumentParser(description="Picks functions to put in ITCM from PC samples and a linker map")
+	parser.add_argument("samples", type=str, nargs="+", help="sample files written by the profiling build")
+	parser.add_argument("-m", "--map", type=str, required=True, help="linker map of the profiling build")
+	parser.add_argument("-o", "--output", type=str, help="ITCM list to write (e.g. arm9/itcm.list)")
+	parser.add_argument("-r", "--reserve", type=int, default=1024, help="ITCM bytes to leave free, for long branch veneers (default: 1024)")
+	parser.add_argument("-s", "--min-share", type=float, default=0.1, help="skip functions with less than this %% of the samples (default: 0.1)")
+	parser.add_argument("-t", "--top", type=int, default=30, help="hot functions to list (default: 30)")
+	args = parser.parse_args()
+
+	memory, outputs, functions = read_map(args.map)
+	samples = read_samples(args.samples)
+	total = sum(samples.values())
+	if total == 0:
+		raise SystemExit("no samples")
+	unknown = assign(functions, samples)
+
+	itcm_size = memory.get("itcm", (0, 0x8000))[1]
+	itcm_used = outputs.get(".itcm", (0, 0))[1]
+	budget = itcm_size - itcm_used - args.reserve
+	picked, left = pick(functions, max(budget, 0), total * args.min_share / 100.0)
+
+	print("%d samples, %d (%.1f%%) outside the map" % (total, unknown, unknown * 100.0 / total))
+	print("")
+	print("%8s %6s %6s  %-5s %s" % ("samples", "share", "bytes", "where", "function"))
+	for function in sorted(functions, key=lambda f: f.samples, reverse=True)[:args.top]:
+		if function.samples == 0:
+			break
+		where = "ITCM" if function.output == ".itcm" else ("+ITCM" if function in picked else "RAM")
+		print("%8d %5.1f%% %6d  %-5s %s" % (function.samples, function.samples * 100.0 / total, function.size, where, function.name or function.section))
+	print("")
+	print("ITCM: %d of %d bytes in use, %d bytes picked, %d bytes left" % (itcm_used, itcm_size, itcm_size - itcm_used - args.reserve - left, left))
+	print("Picked functions cover %.1f%% of the samples" % (sum(f.samples for f in picked) * 100.0 / total))
+	if "dtcm" in memory:
+		dtcm_used = outputs.get(".dtcm", (0, 0))[1] + outputs.get(".sbss", (0, 0))[1]
+		print("DTCM: %d of %d bytes hold data, the rest is stack" % (dtcm_used, memory["dtcm"][1]))
+
+	if args.output:
+		with open(args.output, "w") as f:
+			f.write("# Functions to put in ITCM, picked by resources/itcmplace.py\n")
+			for function in sorted(picked, key=lambda f: f.section):
+				f.write("%s  # %d samples, %d bytes, %s\n" % (function.section, function.samples, function.size, function.name or "?"))
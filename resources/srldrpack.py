@@ -0,0 +1,207 @@
+#!/usr/bin/env python
+
+# Packs the ARM9 and ARM7 binaries of a TWiLight Menu++ module (.srldr), or
+# unpacks them.
+#
+# Each binary is compressed with the DS BIOS' LZ77 format, up to the point
+# where the bootloader can still decompress it in place, and the rest is
+# stored as is. Binaries that don't get smaller are left alone. The rest of
+# the file keeps its layout, so NitroFS offsets stay valid. See
+# universal/include/common/srldrPack.h for the layout.
+
+import argparse
+import struct
+
+MAGIC = 0x5A4C5253  # 'SRLZ'
+MAGIC_OFFSET = 0x160
+ARM9_OFFSET = 0x164
+ARM7_OFFSET = 0x168
+
+MIN_MATCH = 3
+MAX_MATCH = 18
+WINDOW = 0x1000
+MAX_CHAIN = 32
+
+
+def tokenize(data):
+	# Greedy LZ77 parse, as (length, distance) for matches and (byte, 0) for literals
+	tokens = []
+	heads = {}
+	chain = [0] * len(data)
+	pos = 0
+	while pos < len(data):
+		best_len = 0
+		best_dist = 0
+		if pos + MIN_MATCH <= len(data):
+			key = data[pos:pos + MIN_MATCH]
+			candidate = heads.get(key, -1)
+			max_len = min(MAX_MATCH, len(data) - pos)
+			tries = 0
+			while candidate >= 0 and pos - candidate <= WINDOW and tries < MAX_CHAIN:
+				length = MIN_MATCH
+				while length < max_len and data[candidate + length] == data[pos + length]:
+					length += 1
+				if length > best_len:
+					best_len = length
+					best_dist = pos - candidate
+					if length == max_len:
+						break
+				candidate = chain[candidate]
+				tries += 1
+
+		step = best_len if best_len >= MIN_MATCH else 1
+		for i in range(pos, min(pos + step, len(data) - MIN_MATCH + 1)):
+			key = data[i:i + MIN_MATCH]
+			chain[i] = heads.get(key, -1)
+			heads[key] = i
+
+		if best_len >= MIN_MATCH:
+			tokens.append((best_len, best_dist))
+		else:
+			tokens.append((data[pos], 0))
+		pos += step
+	return tokens
+
+
+def find_cut(tokens):
+	# Decompressing in place is safe as long as output never gets further
+	# ahead of input than it is when the stream ends, so end the stream
+	# where output is furthest ahead
+	produced = 0
+	consumed = 0
+	best = (0, 0, 0)  # (lead, token count, bytes produced)
+	for i, (value, dist) in enumerate(tokens):
+		if i % 8 == 0:
+			consumed += 1
+		if dist:
+			produced += value
+			consumed += 2
+		else:
+			produced += 1
+			consumed += 1
+		if produced - consumed >= best[0]:
+			best = (produced - consumed, i + 1, produced)
+	return best[1], best[2]
+
+
+def encode(tokens):
+	out = bytearray()
+	for i in range(0, len(tokens), 8):
+		flag_pos = len(out)
+		out.append(0)
+		flags = 0
+		for bit, (value, dist) in enumerate(tokens[i:i + 8]):
+			if dist:
+				flags |= 0x80 >> bit
+				disp = dist - 1
+				out.append(((value - MIN_MATCH) << 4) | (disp >> 8))
+				out.append(disp & 0xFF)
+			else:
+				out.append(value)
+		out[flag_pos] = flags
+	return bytes(out)
+
+
+def pack_binary(data):
+	tokens = tokenize(data)
+	count, produced = find_cut(tokens)
+	stream = encode(tokens[:count])
+	tail = data[produced:]
+	# Pad so the packed binary ends up word aligned when read to the end of the binary
+	padding = (len(data) - 4 - len(stream) - len(tail)) % 4
+	packed = struct.pack("<I", len(stream) | (padding << 24)) + bytes(padding) + stream + tail
+	if len(stream) >= 1 << 24 or len(packed) >= len(data):
+		return None
+	return packed
+
+
+def unpack_binary(packed, size):
+	info = struct.unpack_from("<I", packed)[0]
+	pos = 4 + (info >> 24)
+	end = pos + (info & 0xFFFFFF)
+	out = bytearray()
+	while pos < end:
+		flags = packed[pos]
+		pos += 1
+		for bit in range(8):
+			if pos >= end:
+				break
+			if flags & (0x80 >> bit):
+				a, b = packed[pos], packed[pos + 1]
+				pos += 2
+				dist = (((a & 0xF) << 8) | b) + 1
+				for _ in range((a >> 4) + MIN_MATCH):
+					out.append(out[-dist])
+			else:
+				out.append(packed[pos])
+				pos += 1
+			# The bootloader decompresses in place, so check output never overtakes input
+			if len(out) > size - len(packed) + pos:
+				raise ValueError("packed binary can't be decompressed in place")
+	out += packed[end:]
+	if len(out) != size:
+		raise ValueError("size mismatch")
+	return bytes(out)
+
+
+def binaries(rom):
+	arm9_offset, _, _, arm9_size, arm7_offset, _, _, arm7_size = struct.unpack_from("<IIIIIIII", rom, 0x20)
+	return ((arm9_offset, arm9_size, ARM9_OFFSET), (arm7_offset, arm7_size, ARM7_OFFSET))
+
+
+def pack(rom):
+	rom = bytearray(rom)
+	if struct.unpack_from("<I", rom, MAGIC_OFFSET)[0] == MAGIC:
+		raise ValueError("already packed")
+	if any(rom[MAGIC_OFFSET:MAGIC_OFFSET + 0xC]):
+		raise ValueError("header debug fields are in use")
+
+	packed_any = False
+	for offset, size, field in binaries(rom):
+		packed = pack_binary(bytes(rom[offset:offset + size]))
+		if packed is None:
+			continue
+		# Keep the file's layout, only the packed size is read
+		rom[offset:offset + size] = packed + bytes(size - len(packed))
+		struct.pack_into("<I", rom, field, len(packed))
+		print("%s: %d -> %d bytes" % ("ARM9" if field == ARM9_OFFSET else "ARM7", size, len(packed)))
+		packed_any = True
+
+	if packed_any:
+		struct.pack_into("<I", rom, MAGIC_OFFSET, MAGIC)
+	return bytes(rom)
+
+
+def unpack(rom):
+	rom = bytearray(rom)
+	if struct.unpack_from("<I", rom, MAGIC_OFFSET)[0] != MAGIC:
+		raise ValueError("not a packed module")
+
+	for offset, size, field in binaries(rom):
+		packed_size = struct.unpack_from("<I", rom, field)[0]
+		if packed_size:
+			rom[offset:offset + size] = unpack_binary(bytes(rom[offset:offset + packed_size]), size)
+	rom[MAGIC_OFFSET:MAGIC_OFFSET + 0xC] = bytes(0xC)
+	return bytes(rom)
+
+
+if __name__ == "__main__":
+	parser = argparse.ArgumentParser(description="Packs the ARM9 and ARM7 binaries of a TWiLight Menu++ module, or unpacks them")
+	parser.add_argument("input", type=str, help="module to pack or unpack")
+	parser.add_argument("-o", "--output", type=str, required=True, help="file to output to")
+	parser.add_argument("-u", "--unpack", action="store_true", help="unpack instead of packing")
+	args = parser.parse_args()
+
+	with open(args.input, "rb") as f:
+		data = f.read()
+
+	if args.unpack:
+		output = unpack(data)
+	else:
+		output = pack(data)
+		# Make sure the bootloader will get the same binaries back
+		if output != data and unpack(output) != data:
+			raise ValueError("packed module doesn't unpack to the original")
+
+	with open(args.output, "wb") as f:
+		f.write(output)
@@ -31,6 +31,7 @@
 #include <string.h>
 #include "common/isPhatCheck.h"
 #include "common/arm7status.h"
+#include "common/discCache.h"
 
 void my_touchInit();
 void my_installSystemFIFO(void);
@@ -284,5 +285,7 @@ int main() {
 		}
 		swiWaitForVBlank();
 	}
+
+	discCacheRequestFlush();
 	return 0;
 }
\ No newline at end of file
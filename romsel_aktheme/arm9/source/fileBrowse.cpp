@@ -38,9 +38,12 @@
 #include "date.h"
 
 #include "ndsheaderbanner.h"
+#include "folderIndex.h"
 #include "common/twlmenusettings.h"
 #include "common/bootstrapsettings.h"
+#include "common/discCache.h"
 #include "common/flashcard.h"
+#include "common/gameOrder.h"
 #include "common/systemdetails.h"
 #include "common/tonccpy.h"
 #include "iconTitle.h"
@@ -338,18 +341,14 @@ void getDirectoryContents(std::vector<DirEntry> &dirContents, const std::vector<
 				});
 			logPrint("File type");
 		} else if (ms().sortMethod == TWLSettings::ESortCustom) { // Custom
-			CIniFile gameOrderIni(gameOrderIniPath);
-			std::vector<std::string> gameOrder;
 			getcwd(path, PATH_MAX);
-			gameOrderIni.GetStringVector("ORDER", path, gameOrder, ':');
+			gameOrderLoad(path);
 
-			for (uint i = 0; i < gameOrder.size(); i++) {
-				for (DirEntry &dirEntry : dirContents) {
-					if (gameOrder[i] == dirEntry.name) {
-						dirEntry.position = i;
-						dirEntry.customPos = true;
-						break;
-					}
+			for (DirEntry &dirEntry : dirContents) {
+				u32 rank;
+				if (gameOrderRank(dirEntry.name, &rank)) {
+					dirEntry.position = rank;
+					dirEntry.customPos = true;
 				}
 			}
 			sort(dirContents.begin(), dirContents.end(), dirEntryPredicate);
@@ -1422,6 +1421,7 @@ bool dsiWareCompatibleB4DS(void) {
 
 std::string browseForFile(const std::vector<std::string_view> extensionList) {
 	gameOrderIniPath = std::string(sys().isRunFromSD() ? "sd" : "fat") + ":/_nds/TWiLightMenu/extras/gameorder.ini";
+	gameOrderInit(gameOrderIniPath);
 	recentlyPlayedIniPath = std::string(sys().isRunFromSD() ? "sd" : "fat") + ":/_nds/TWiLightMenu/extras/recentlyplayed.ini";
 	timesPlayedIniPath = std::string(sys().isRunFromSD() ? "sd" : "fat") + ":/_nds/TWiLightMenu/extras/timesplayed.ini";
 
@@ -2136,14 +2136,18 @@ std::string browseForFile(const std::vector<std::string_view> extensionList) {
 					if (pressed & KEY_A && !isDirectory[cursorPosOnScreen]) {
 						displayDiskIcon(ms().secondaryDevice);
 						remove(dirContents.at(fileOffset).name.c_str());
+						folderIndexNoteRemoved(dirContents.at(fileOffset).name.c_str());
 						displayDiskIcon(false);
 					} else if (pressed & KEY_Y) {
 						displayDiskIcon(ms().secondaryDevice);
 						// Remove leading . if it exists
 						if ((strncmp(entry->name.c_str(), ".", 1) == 0 && entry->name != "..")) {
 							rename(entry->name.c_str(), entry->name.substr(1).c_str());
+							folderIndexNoteRemoved(entry->name.c_str());
+							folderIndexNoteAdded(entry->name.substr(1).c_str());
 						} else { // Otherwise toggle the hidden attribute bit
 							FAT_setAttr(entry->name.c_str(), FAT_getAttr(entry->name.c_str()) ^ ATTR_HIDDEN);
+							discCacheFlushAll();
 						}
 						displayDiskIcon(false);
 					}
@@ -22,6 +22,9 @@
 #include "graphics/graphics.h"
 
 #include "myDSiMode.h"
+#include "common/blockRom.h"
+#include "common/discCache.h"
+#include "common/dsiWareStaging.h"
 #include "common/tonccpy.h"
 #include "common/fatHeader.h"
 #include "common/flashcard.h"
@@ -42,6 +45,7 @@
 #include "common/stringtool.h"
 #include "common/systemdetails.h"
 #include "common/twlmenusettings.h"
+#include "common/warmSwitch.h"
 
 #include "language.h"
 
@@ -379,6 +383,7 @@ void unlaunchRomBoot(std::string_view rom) {
 	}
 	*(u16*)(0x0200080E) = swiCRC16(0xFFFF, (void*)0x02000810, 0x3F0);		// Unlaunch CRC16
 
+	discCacheFlushAll();
 	DC_FlushAll();						// Make reboot not fail
 	fifoSendValue32(FIFO_USER_02, 1);	// Reboot into DSiWare title, booted via Unlaunch
 	stop();
@@ -411,6 +416,7 @@ void ntrStartSdGame(void) {
 		unlaunchRomBoot("sd:/_nds/TWiLightMenu/main.srldr");
 	} else {
 		tonccpy((u32 *)0x02000300, autoboot_bin, 0x20);
+		discCacheFlushAll();
 		DC_FlushAll();						// Make reboot not fail
 		fifoSendValue32(FIFO_USER_02, 1);
 		stop();
@@ -430,6 +436,7 @@ void dsCardLaunch() {
 
 	unlaunchSetHiyaBoot();
 
+	discCacheFlushAll();
 	DC_FlushAll();						// Make reboot not fail
 	fifoSendValue32(FIFO_USER_02, 1);	// Reboot into DSiWare title, booted via Launcher
 	stop();
@@ -954,6 +961,7 @@ int akTheme(void) {
 	ms().loadSettings();
 	bs().loadSettings();
 	logInit();
+	logPrint("Warm switch: %lu sector reads saved\n", (unsigned long)warmSwitchReadsSaved());
 
 	graphicsInit();
 	langInit();
@@ -1157,15 +1165,20 @@ int akTheme(void) {
 		printSmall(false, 0, 90, "Now copying data...", Alignment::center, FontPalette::formText);
 		printSmall(false, 0, 102, "Do not turn off the power.", Alignment::center, FontPalette::formText);
 		updateText(false);
+		DSiWareStagingStats stagingStats = {0, 0};
 		if (access(ms().dsiWarePubPath.c_str(), F_OK) == 0) {
-			fcopy("sd:/_nds/TWiLightMenu/tempDSiWare.pub", ms().dsiWarePubPath.c_str());
-			rename("sd:/_nds/TWiLightMenu/tempDSiWare.pub", "sd:/_nds/TWiLightMenu/tempDSiWare.pub.bak");
+			// Kept for a relaunch, or copied back again next time if this failed
+			if (dsiWareSyncFile("sd:/_nds/TWiLightMenu/tempDSiWare.pub", ms().dsiWarePubPath.c_str(), &stagingStats)) {
+				rename("sd:/_nds/TWiLightMenu/tempDSiWare.pub", "sd:/_nds/TWiLightMenu/tempDSiWare.pub.bak");
+			}
 		}
 		if (access(ms().dsiWarePrvPath.c_str(), F_OK) == 0) {
-			fcopy("sd:/_nds/TWiLightMenu/tempDSiWare.prv", ms().dsiWarePrvPath.c_str());
-			rename("sd:/_nds/TWiLightMenu/tempDSiWare.prv", "sd:/_nds/TWiLightMenu/tempDSiWare.prv.bak");
+			// Kept for a relaunch, or copied back again next time if this failed
+			if (dsiWareSyncFile("sd:/_nds/TWiLightMenu/tempDSiWare.prv", ms().dsiWarePrvPath.c_str(), &stagingStats)) {
+				rename("sd:/_nds/TWiLightMenu/tempDSiWare.prv", "sd:/_nds/TWiLightMenu/tempDSiWare.prv.bak");
+			}
 		}
-		logPrint("Copied DSiWare save back to flashcard\n");
+		logPrint("Copied DSiWare save back to flashcard (%lu bytes written)\n", stagingStats.bytesWritten);
 		clearText(false);
 		showdialogbox = true;
 		dialogboxHeight = 0;
@@ -1284,17 +1297,10 @@ int akTheme(void) {
 		// Launch the item
 
 		if (applaunch) {
-			// Delete previously used DSiWare of flashcard from SD
-			if (access("sd:/_nds/TWiLightMenu/tempDSiWare.dsi", F_OK) == 0) {
-				remove("sd:/_nds/TWiLightMenu/tempDSiWare.dsi");
-			}
-			if (access("sd:/_nds/TWiLightMenu/tempDSiWare.pub.bak", F_OK) == 0) {
-				remove("sd:/_nds/TWiLightMenu/tempDSiWare.pub.bak");
-			}
-			if (access("sd:/_nds/TWiLightMenu/tempDSiWare.prv.bak", F_OK) == 0) {
-				remove("sd:/_nds/TWiLightMenu/tempDSiWare.prv.bak");
-			}
-			if (access("sd:/_nds/nds-bootstrap/patchOffsetCache/tempDSiWare.bin", F_OK) == 0) {
+			// Drop what was copied from flashcard to SD for the last DSiWare launch,
+			// unless the same DSiWare is being launched again
+			if (!dsiWareStagedFrom(filename.c_str(), "sd:/_nds/TWiLightMenu/tempDSiWare.dsi")) {
+				dsiWareUnstage("sd:/_nds/TWiLightMenu/tempDSiWare.dsi");
 				remove("sd:/_nds/nds-bootstrap/patchOffsetCache/tempDSiWare.bin");
 			}
 
@@ -1458,13 +1464,20 @@ int akTheme(void) {
 					printSmall(false, 0, 98, "Now copying data...", Alignment::center, FontPalette::formText);
 					printSmall(false, 0, 110, "Do not turn off the power.", Alignment::center, FontPalette::formText);
 					updateText(false);
-					fcopy(ms().dsiWareSrlPath.c_str(), "sd:/_nds/TWiLightMenu/tempDSiWare.dsi");
+					DSiWareStagingStats stagingStats = {0, 0};
+					if (dsiWareStageSrl(ms().dsiWareSrlPath.c_str(), "sd:/_nds/TWiLightMenu/tempDSiWare.dsi", &stagingStats) == EStageCopied) {
+						// Cached patch offsets belong to the previously staged DSiWare
+						remove("sd:/_nds/nds-bootstrap/patchOffsetCache/tempDSiWare.bin");
+					}
 					if ((access(ms().dsiWarePubPath.c_str(), F_OK) == 0) && (NDSHeader.pubSavSize > 0)) {
-						fcopy(ms().dsiWarePubPath.c_str(), "sd:/_nds/TWiLightMenu/tempDSiWare.pub");
+						dsiWareRestoreSave("sd:/_nds/TWiLightMenu/tempDSiWare.pub");
+						dsiWareSyncFile(ms().dsiWarePubPath.c_str(), "sd:/_nds/TWiLightMenu/tempDSiWare.pub", &stagingStats);
 					}
 					if ((access(ms().dsiWarePrvPath.c_str(), F_OK) == 0) && (NDSHeader.prvSavSize > 0)) {
-						fcopy(ms().dsiWarePrvPath.c_str(), "sd:/_nds/TWiLightMenu/tempDSiWare.prv");
+						dsiWareRestoreSave("sd:/_nds/TWiLightMenu/tempDSiWare.prv");
+						dsiWareSyncFile(ms().dsiWarePrvPath.c_str(), "sd:/_nds/TWiLightMenu/tempDSiWare.prv", &stagingStats);
 					}
+					logPrint("Staged DSiWare on SD (%lu bytes read, %lu bytes written)\n", stagingStats.bytesRead, stagingStats.bytesWritten);
 
 					if ((access(ms().dsiWarePubPath.c_str(), F_OK) == 0 && (NDSHeader.pubSavSize > 0))
 					 || (access(ms().dsiWarePrvPath.c_str(), F_OK) == 0 && (NDSHeader.prvSavSize > 0))) {
@@ -2005,6 +2018,7 @@ int akTheme(void) {
 				bool boostCpu = true;
 				bool boostVram = false;
 				bool tscTgds = false;
+				bool romUnreadable = false; // Block ROM which can't be read, or isn't going to the native GBA path
 
 				std::string romfolderNoSlash = ms().romfolder[ms().secondaryDevice];
 				RemoveTrailingSlashes(romfolderNoSlash);
@@ -2073,8 +2087,10 @@ int akTheme(void) {
 						displayDiskIcon(true);
 
 						u32 ptr = 0x08000000;
-						u32 romSize = getFileSize(filename.c_str());
 						FILE* gbaFile = fopen(filename.c_str(), "rb");
+						BlockRom gbaRom;
+						romUnreadable = !blockRomOpen(&gbaRom, gbaFile); // Block ROMs are read as if uncompressed
+						u32 romSize = gbaRom.romSize;
 						if (strncmp(gameTid[cursorPosOnScreen], "AGBJ", 4) == 0 && romSize <= 0x40000) {
 							ptr += 0x400;
 						}
@@ -2097,7 +2113,7 @@ int akTheme(void) {
 						}
 
 						for (u32 len = romSize; len > 0; len -= 0x8000) {
-							if (fread(&copyBuf, 1, (len>0x8000 ? 0x8000 : len), gbaFile) > 0) {
+							if (blockRomRead(&gbaRom, &copyBuf, (len>0x8000 ? 0x8000 : len)) > 0) {
 								s2RamAccess(true);
 								if (nor) {
 									expansion().WriteNorFlash(ptr-0x08000000, (u8*)copyBuf, (len>0x8000 ? 0x8000 : len));
@@ -2110,7 +2126,8 @@ int akTheme(void) {
 								break;
 							}
 						}
-						fclose(gbaFile);
+						blockRomClose(&gbaRom);
+						if (gbaFile) fclose(gbaFile);
 
 						ptr = 0x0A000000;
 
@@ -2118,7 +2135,7 @@ int akTheme(void) {
 						u32 savesize = getFileSize(savename.c_str());
 						if (savesize > 0x10000) savesize = 0x10000;
 
-						if (savesize > 0) {
+						if (savesize > 0 && !romUnreadable) {
 							FILE* savFile = fopen(savename.c_str(), "rb");
 							for (u32 len = savesize; len > 0; len -= 0x8000) {
 								if (fread(&copyBuf, 1, (len>0x8000 ? 0x8000 : len), savFile) > 0) {
@@ -2432,7 +2449,11 @@ int akTheme(void) {
 				argarray.push_back(ROMpath);
 				argarray.at(0) = (char *)(tgdsMode ? tgdsNdsPath : ndsToBoot);
 
-				int err = runNdsFile (ndsToBoot, argarray.size(), (const char **)&argarray[0], sys().isRunFromSD(), !useNDSB, true, dsModeSwitch, boostCpu, boostVram, tscTgds, -1);	// Pass ROM to emulator as argument
+				// GBARunner2 and the emulators open the ROM themselves, and can't read block ROMs
+				if (ms().launchType[ms().secondaryDevice] != TWLSettings::EGBANativeLaunch && blockRomIsPacked(ROMpath)) {
+					romUnreadable = true;
+				}
+				int err = romUnreadable ? BLOCK_ROM_START_ERROR : runNdsFile (ndsToBoot, argarray.size(), (const char **)&argarray[0], sys().isRunFromSD(), !useNDSB, true, dsModeSwitch, boostCpu, boostVram, tscTgds, -1);	// Pass ROM to emulator as argument
 				char text[32];
 				snprintf (text, sizeof(text), "Start failed. Error %i", err);
 				clearText(false);
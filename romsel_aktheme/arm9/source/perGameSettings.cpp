@@ -36,6 +36,7 @@
 #include "twlClockExcludeMap.h"
 #include "dmaExcludeMap.h"
 #include "asyncReadExcludeMap.h"
+#include "folderIndex.h"
 
 extern bool useTwlCfg;
 
@@ -97,7 +98,10 @@ bool blacklisted_asyncCardRead = false;
 
 void loadPerGameSettings (std::string filename) {
 	snprintf(pergamefilepath, sizeof(pergamefilepath), "%s/_nds/TWiLightMenu/gamesettings/%s.ini", (ms().secondaryDevice ? "fat:" : "sd:"), filename.c_str());
-	CIniFile pergameini( pergamefilepath );
+	CIniFile pergameini;
+	if (folderIndexExists(pergamefilepath)) {
+		pergameini.LoadIniFile(pergamefilepath);
+	}
 	perGameSettings_directBoot = pergameini.GetInt("GAMESETTINGS", "DIRECT_BOOT", (isModernHomebrew[cursorPosOnScreen] || ms().previousUsedDevice));	// Homebrew only
 	if (isHomebrew[cursorPosOnScreen]) {
 		perGameSettings_dsiMode = pergameini.GetInt("GAMESETTINGS", "DSI_MODE", (isModernHomebrew[cursorPosOnScreen] ? true : false));
@@ -181,6 +185,7 @@ void savePerGameSettings (std::string filename) {
 		pergameini.SetInt("GAMESETTINGS", "SAVE_RELOCATION", perGameSettings_saveRelocation);
 	}
 	pergameini.SaveIniFile( pergamefilepath );
+	folderIndexNoteAdded(pergamefilepath);
 }
 
 bool checkIfShowAPMsg (std::string filename) {
@@ -194,6 +199,7 @@ void dontShowAPMsgAgain (std::string filename) {
 	CIniFile pergameini(pergamefilepath);
 	pergameini.SetInt("GAMESETTINGS", "NO_SHOW_AP_MSG", 1);
 	pergameini.SaveIniFile(pergamefilepath);
+	folderIndexNoteAdded(pergamefilepath);
 }
 
 bool checkIfShowRAMLimitMsg (std::string filename) {
@@ -207,6 +213,7 @@ void dontShowRAMLimitMsgAgain (std::string filename) {
 	CIniFile pergameini(pergamefilepath);
 	pergameini.SetInt("GAMESETTINGS", "NO_SHOW_RAM_LIMIT_MSG", 1);
 	pergameini.SaveIniFile(pergamefilepath);
+	folderIndexNoteAdded(pergamefilepath);
 }
 
 bool checkIfDSiMode (std::string filename) {
@@ -32,6 +32,7 @@
 #include <maxmod7.h>
 #include "common/isPhatCheck.h"
 #include "common/arm7status.h"
+#include "common/discCache.h"
 
 void my_touchInit();
 void my_installSystemFIFO(void);
@@ -253,5 +254,7 @@ int main() {
 		}
 		swiWaitForVBlank();
 	}
+
+	discCacheRequestFlush();
 	return 0;
 }
\ No newline at end of file
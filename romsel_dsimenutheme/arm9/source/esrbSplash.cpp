@@ -5,7 +5,8 @@
 #include "common/systemdetails.h"
 #include "common/flashcard.h"
 #include "common/tonccpy.h"
-#include "common/inifile.h"
+#include "common/esrbDatabase.h"
+#include "common/scratchArena.h"
 #include "common/logging.h"
 #include "fileBrowse.h"
 #include "graphics/fontHandler.h"
@@ -14,8 +15,6 @@
 #include "ndsheaderbanner.h"
 #include "language.h"
 
-#include "dsGameInfoMap.h"
-
 void createEsrbSplash(void) {
 	if (!ms().esrbRatingScreen || isHomebrew[CURPOS] || (gameTid[CURPOS][3] != 'E' && gameTid[CURPOS][3] != 'O' && gameTid[CURPOS][3] != 'T' && gameTid[CURPOS][3] != 'W')) {
 		remove(sys().isRunFromSD() ? "sd:/_nds/nds-bootstrap/esrb.bin" : "fat:/_nds/nds-bootstrap/esrb.bin");
@@ -27,28 +26,18 @@ void createEsrbSplash(void) {
 		gameTid3[i] = gameTid[CURPOS][i];
 	}
 
-	CIniFile esrbInfo("nitro:/ESRB.ini");
-	std::string rating = esrbInfo.GetString(gameTid3, "Rating", "");
-	if (rating == "") {
+	EsrbInfo esrbInfo;
+	if (!esrbLookup("nitro:/ESRB.bin", gameTid3, esrbInfo)) {
 		remove(sys().isRunFromSD() ? "sd:/_nds/nds-bootstrap/esrb.bin" : "fat:/_nds/nds-bootstrap/esrb.bin");
 		return;
 	}
 
-	std::string descriptors = esrbInfo.GetString(gameTid3, "Descriptors en", "");
-	const bool onlineNotice = esrbInfo.GetInt(gameTid3, "Online", 0);
-
-	bool sideways = false;
-	if ((rating == "E" || rating == "EC" || rating == "RP") && descriptors == "") {
-		// Search for games starting sideways
-		// TODO: If the list gets large enough, switch to bsearch().
-		for (unsigned int i = 0; i < sizeof(sidewaysGameList)/sizeof(sidewaysGameList[0]); i++) {
-			if (memcmp(gameTid[CURPOS], sidewaysGameList[i], 3) == 0) {
-				// Found match
-				sideways = true;
-				break;
-			}
-		}
-	}
+	const std::string rating = esrbInfo.rating;
+	const std::string &descriptors = esrbInfo.descriptors;
+	const bool onlineNotice = esrbInfo.online;
+
+	// Only games starting sideways without descriptors have a sideways splash
+	const bool sideways = ((rating == "E" || rating == "EC" || rating == "RP") && descriptors == "" && esrbInfo.sideways);
 
 	char esrbImagePath[64];
 	if (rating == "E" && descriptors == "") {
@@ -68,7 +57,9 @@ void createEsrbSplash(void) {
 	lodepng::decode(image, imageWidth, imageHeight, esrbImagePath);
 	if (imageWidth > 256 || imageHeight > 192) return;
 
-	u16* bmpImageBuffer = new u16[256 * 192];
+	ScratchBuffer bmpImage(256 * 192 * sizeof(u16));
+	if (!bmpImage) return;
+	u16* bmpImageBuffer = bmpImage.as<u16>();
 
 	for (uint i=0;i<image.size()/4;i++) {
 		bmpImageBuffer[i] = image[i*4]>>3 | (image[(i*4)+1]>>3)<<5 | (image[(i*4)+2]>>3)<<10 | BIT(15);
@@ -127,6 +118,4 @@ void createEsrbSplash(void) {
 	}
 	fwrite(bmpImageBuffer, sizeof(u16), 256*192, file);
 	fclose(file);
-
-	delete[] bmpImageBuffer;
 }
@@ -1,5 +1,6 @@
 #include "fileBrowse.h"
 #include <algorithm>
+#include <deque>
 #include <dirent.h>
 #include <math.h>
 #include <sstream>
@@ -14,6 +15,7 @@
 #include <nds/arm9/dldi.h>
 #include <fat.h>
 #include "fat_ext.h"
+#include "folderIndex.h"
 
 #include "date.h"
 
@@ -30,10 +32,13 @@
 #include "incompatibleGameMap.h"
 #include "compatibleDSiWareMap.h"
 #include "gbaswitch.h"
+#include "idleGovernor.h"
 
 #include "common/twlmenusettings.h"
 #include "common/bootstrapsettings.h"
+#include "common/discCache.h"
 #include "common/flashcard.h"
+#include "common/gameOrder.h"
 #include "common/inifile.h"
 #include "common/logging.h"
 #include "common/nds_loader_arm9.h"
@@ -270,6 +275,7 @@ void updateDirectoryContents(vector<DirEntry> &dirContents) {
 
 void getDirectoryContents(std::vector<DirEntry> &dirContents, const std::vector<std::string_view> extensionList = {}) {
 	dirContents.clear();
+	clearSlotRecords();
 
 	file_count = 0;
 	fileStartPos = 0;
@@ -375,6 +381,7 @@ void getDirectoryContents(std::vector<DirEntry> &dirContents, const std::vector<
 		}
 		recalculateBoxesCount();
 
+		idleGovernorBeginWork();
 		if (ms().sortMethod == TWLSettings::ESortAlphabetical) { // Alphabetical
 			std::sort(dirContents.begin(), dirContents.end(), dirEntryPredicate);
 			logPrint("Alphabetical");
@@ -433,23 +440,20 @@ void getDirectoryContents(std::vector<DirEntry> &dirContents, const std::vector<
 				});
 			logPrint("File type");
 		} else if (ms().sortMethod == TWLSettings::ESortCustom) { // Custom
-			CIniFile gameOrderIni(gameOrderIniPath);
-			std::vector<std::string> gameOrder;
 			getcwd(path, PATH_MAX);
-			gameOrderIni.GetStringVector("ORDER", path, gameOrder, ':');
+			gameOrderLoad(path);
 
-			for (uint i = 0; i < gameOrder.size(); i++) {
-				for (DirEntry &dirEntry : dirContents) {
-					if (gameOrder[i] == dirEntry.name) {
-						dirEntry.position = i;
-						dirEntry.customPos = true;
-						break;
-					}
+			for (DirEntry &dirEntry : dirContents) {
+				u32 rank;
+				if (gameOrderRank(dirEntry.name, &rank)) {
+					dirEntry.position = rank;
+					dirEntry.customPos = true;
 				}
 			}
 			sort(dirContents.begin(), dirContents.end(), dirEntryPredicate);
 			logPrint("Custom");
 		}
+		idleGovernorEndWork();
 		logPrint("\n\n");
 		if (backFound) {
 			dirContents.insert(dirContents.begin(), {"..", true, backPos, false});
@@ -482,7 +486,59 @@ void displayNowLoading(void) {
 	showProgressIcon = true;
 }
 
-void moveCursor(bool right, const std::vector<DirEntry> dirContents, int maxEntry = 0xFFFF) {
+/**
+ * Work left over from moving the cursor, done one item per frame so the
+ * boxes start moving on the frame the button is pressed. Icons are for the
+ * box coming into view, and are dropped if the cursor has already moved
+ * too far past it.
+ */
+static struct {
+	bool title = false;
+	std::deque<int> icons;
+} cursorWork;
+
+static bool runCursorWork(const std::vector<DirEntry> &dirContents) {
+	if (cursorWork.title) {
+		cursorWork.title = false;
+		clearText(false);
+		if (CURPOS + PAGENUM * 40 < (int)dirContents.size()) {
+			titleUpdate(dirContents[CURPOS + PAGENUM * 40].isDirectory,
+						dirContents[CURPOS + PAGENUM * 40].name,
+						CURPOS);
+		}
+		if (ms().theme == TWLSettings::EThemeHBL) {
+			printLarge(false, 0, 142, "^", Alignment::center, FontPalette::overlay);
+			printSmall(false, 4, 174, (showLshoulder ? STR_L_PREV : STR_L), Alignment::left, FontPalette::overlay);
+			printSmall(false, 256-4, 174, (showRshoulder ? STR_NEXT_R : STR_R), Alignment::right, FontPalette::overlay);
+		} else if (ms().macroMode && ms().theme != TWLSettings::EThemeSaturn) {
+			printSmall(false, 4, 152, (showLshoulder ? STR_L_PREV : STR_L), Alignment::left, FontPalette::overlay);
+			printSmall(false, 256-4, 152, (showRshoulder ? STR_NEXT_R : STR_R), Alignment::right, FontPalette::overlay);
+		}
+		updateText(false);
+		return true;
+	}
+
+	while (!cursorWork.icons.empty()) {
+		const int pos = cursorWork.icons.front();
+		cursorWork.icons.pop_front();
+		if (abs(pos - CURPOS) > 2) {
+			continue;
+		}
+		iconUpdate(dirContents[pos + PAGENUM * 40].isDirectory,
+					dirContents[pos + PAGENUM * 40].name.c_str(),
+					pos);
+		return true;
+	}
+
+	return false;
+}
+
+static void cursorWorkFrame(const std::vector<DirEntry> &dirContents) {
+	runCursorWork(dirContents);
+	bgOperations(true);
+}
+
+void moveCursor(bool right, const std::vector<DirEntry> &dirContents, int maxEntry = 0xFFFF) {
 	if ((right && CURPOS >= last_used_box) || (!right && CURPOS <= 0)) {
 		if (ms().theme != TWLSettings::EThemeSaturn && !edgeBumpSoundPlayed)
 			snd().playWrong();
@@ -505,41 +561,21 @@ void moveCursor(bool right, const std::vector<DirEntry> dirContents, int maxEntr
 			if (ms().theme != TWLSettings::EThemeSaturn && !edgeBumpSoundPlayed)
 				snd().playWrong();
 			edgeBumpSoundPlayed = true;
+			while (runCursorWork(dirContents));
 			return;
 		}
 
 		if (movingApp == -1) {
-			clearText(false);
-			if (CURPOS + PAGENUM * 40 < (int)dirContents.size()) {
-				if (ms().theme != TWLSettings::EThemeSaturn)
-					currentBg = 1;
-				titleUpdate(dirContents[CURPOS + PAGENUM * 40].isDirectory,
-							dirContents[CURPOS + PAGENUM * 40].name,
-							CURPOS);
-			} else {
-				if (ms().theme != TWLSettings::EThemeSaturn)
-					currentBg = 0;
-			}
-			if (ms().theme == TWLSettings::EThemeHBL) {
-				printLarge(false, 0, 142, "^", Alignment::center, FontPalette::overlay);
-				printSmall(false, 4, 174, (showLshoulder ? STR_L_PREV : STR_L), Alignment::left, FontPalette::overlay);
-				printSmall(false, 256-4, 174, (showRshoulder ? STR_NEXT_R : STR_R), Alignment::right, FontPalette::overlay);
-			} else if (ms().macroMode && ms().theme != TWLSettings::EThemeSaturn) {
-				printSmall(false, 4, 152, (showLshoulder ? STR_L_PREV : STR_L), Alignment::left, FontPalette::overlay);
-				printSmall(false, 256-4, 152, (showRshoulder ? STR_NEXT_R : STR_R), Alignment::right, FontPalette::overlay);
-			}
-			updateText(false);
+			if (ms().theme != TWLSettings::EThemeSaturn)
+				currentBg = (CURPOS + PAGENUM * 40 < (int)dirContents.size()) ? 1 : 0;
+			cursorWork.title = true;
 		}
 
 		int pos = CURPOS + (right ? 2 : -2);
 		if (pos >= 0 && pos + PAGENUM * 40 < (int)dirContents.size()) {
-			iconUpdate(dirContents[pos + PAGENUM * 40].isDirectory,
-						dirContents[pos + PAGENUM * 40].name.c_str(),
-						pos);
+			cursorWork.icons.push_back(pos);
 		}
 
-		bgOperations(false);
-
 		snd().playSelect();
 
 		if (ms().theme != TWLSettings::EThemeSaturn) {
@@ -553,10 +589,10 @@ void moveCursor(bool right, const std::vector<DirEntry> dirContents, int maxEntr
 					if (i % 3)
 						titlewindowXdest[ms().secondaryDevice]--;
 				}
-				swiWaitForVBlank();
+				cursorWorkFrame(dirContents);
 			}
 			titleboxXdest[ms().secondaryDevice] = CURPOS * titleboxXspacing;
-			swiWaitForVBlank();
+			cursorWorkFrame(dirContents);
 		} else {
 			if (right) {
 				titleboxXdest[ms().secondaryDevice] += titleboxXspacing;
@@ -567,7 +603,7 @@ void moveCursor(bool right, const std::vector<DirEntry> dirContents, int maxEntr
 			}
 
 			for (int i = 0; i < 4; i++)
-				swiWaitForVBlank();
+				cursorWorkFrame(dirContents);
 		}
 
 		// Bit of delay the first time to give time to release the button
@@ -581,13 +617,13 @@ void moveCursor(bool right, const std::vector<DirEntry> dirContents, int maxEntr
 				boxArtLoaded = false;
 				if (ms().theme == TWLSettings::EThemeSaturn) {
 					for (int i = 0; i < 10; i++)
-						swiWaitForVBlank();
+						cursorWorkFrame(dirContents);
 				}
 			} else if (ms().theme == TWLSettings::ETheme3DS) {
-				swiWaitForVBlank();
+				cursorWorkFrame(dirContents);
 			} else {
 				for (int i = 0; i < (ms().theme == TWLSettings::EThemeSaturn ? 15 : 4); i++)
-					swiWaitForVBlank();
+					cursorWorkFrame(dirContents);
 			}
 		} else {
 			if (ms().theme != TWLSettings::ETheme3DS)
@@ -601,7 +637,10 @@ void moveCursor(bool right, const std::vector<DirEntry> dirContents, int maxEntr
 
 	// Wait for movement to finish before showing START boarder and such
 	while ((ms().theme != TWLSettings::ETheme3DS) && (titleboxXdest[ms().secondaryDevice] != titleboxXpos[ms().secondaryDevice]) && !(keysHeld() & KEY_TOUCH))
-		swiWaitForVBlank();
+		cursorWorkFrame(dirContents);
+
+	// Anything not done while the boxes were moving
+	while (runCursorWork(dirContents));
 
 	if (movingApp == -1 && CURPOS + PAGENUM * 40 < (int)dirContents.size())
 		showSTARTborder = true;
@@ -628,7 +667,7 @@ void updateBoxArt(void) {
 		}
 	} else {
 		sprintf(boxArtPath, "%s:/_nds/TWiLightMenu/boxart/%s.png", sys().isRunFromSD() ? "sd" : "fat", boxArtFilename);
-		if ((bnrRomType[CURPOS] == 0) && (access(boxArtPath, F_OK) != 0)) {
+		if ((bnrRomType[CURPOS] == 0) && !folderIndexExists(boxArtPath)) {
 			sprintf(boxArtPath, "%s:/_nds/TWiLightMenu/boxart/%s.png", sys().isRunFromSD() ? "sd" : "fat", gameTid[CURPOS]);
 		}
 		tex().drawBoxArt(boxArtPath, (dsiFeatures() && ms().showBoxArt == 2)); // Load box art
@@ -940,6 +979,7 @@ void launchDownloadPlay(const vector<DirEntry>& dirContents) {
 			unlaunchSetHiyaBoot();
 		}
 
+		discCacheFlushAll();
 		DC_FlushAll();						// Make reboot not fail
 		fifoSendValue32(FIFO_USER_02, 1); // Reboot into DSiWare title, booted via Launcher
 		for (int i = 0; i < 15; i++) swiWaitForVBlank();
@@ -1341,6 +1381,7 @@ void exitToSystemMenu(void) {
 		extern char launcherPath[256];
 		unlaunchRomBoot(launcherPath);
 	}
+	discCacheFlushAll();
 	fifoSendValue32(FIFO_USER_02, 1); // ReturntoDSiMenu
 }
 
@@ -1488,6 +1529,31 @@ void launchGba(void) {
 	//}
 }
 
+/**
+ * Lay out the messages shown by the dialogs below while the menu is idle,
+ * so opening a dialog only has to draw the glyphs.
+ */
+void queueDialogLayouts(void) {
+	for (const std::string *str : {
+		&STR_A_OK, &STR_B_BACK, &STR_Y_DS_MODE_B_BACK, &STR_B_A_OK_X_DONT_SHOW, &STR_A_IGNORE_B_DONT_LAUNCH,
+		&STR_MD_ROM_TOO_BIG, &STR_RAM_DISK_REQUIRED, &STR_DSIBINARIES_MISSING, &STR_GAME_INCOMPATIBLE_MSG,
+		&STR_DSIWARE_DS_MODE_P1, &STR_DSIWARE_DS_MODE_P2,
+		&STR_DONOR_ROM_MSG_SDK20, &STR_DONOR_ROM_MSG_SDK5, &STR_DONOR_ROM_MSG_SDK5TWL, &STR_DONOR_ROM_MSG_SDK50TWL,
+		&STR_DONOR_ROM_MSG_SDK5TWLONLY, &STR_DONOR_ROM_MSG_SDK50TWLONLY, &STR_DONOR_ROM_MSG_SDK5TWLONLY_DSI_MODE,
+		&STR_HOW_TO_SET_DONOR_ROM_SDK20, &STR_HOW_TO_SET_DONOR_ROM_SDK5, &STR_HOW_TO_SET_DONOR_ROM_VRAM_WIFI_SDK5,
+		&STR_HOW_TO_SET_DONOR_ROM_SDK5TWL, &STR_HOW_TO_SET_DONOR_ROM_SDK50TWL,
+		&STR_HOW_TO_SET_DONOR_ROM_SDK5TWLONLY, &STR_HOW_TO_SET_DONOR_ROM_SDK50TWLONLY,
+		&STR_RAM_LIMIT_GAME_PART_ONLY, &STR_RAM_LIMIT_NO_AUDIO, &STR_RAM_LIMIT_NO_MUSIC, &STR_RAM_LIMIT_NO_FMV,
+		&STR_RAM_LIMIT_SPECIFIC_AREA, &STR_RAM_LIMIT_CERTAIN_POINT, &STR_RAM_LIMIT_STATE,
+		&STR_RAM_LIMIT_NO_SAVE_STATE, &STR_RAM_LIMIT_NO_SOUND_FX,
+		&STR_CANNOT_LAUNCH_WITHOUT_SD, &STR_CANNOT_LAUNCH_IN_DS_MODE, &STR_CANNOT_LAUNCH_HB_ON_3DS,
+		&STR_CANNOT_LAUNCH_WITH_UI, &STR_CANNOT_LAUNCH_CORRUPT_TITLE_SD, &STR_CANNOT_LAUNCH_CORRUPT_TITLE_MICRO_SD,
+		&STR_RELAUNCH_3DS_HOME, &STR_RELAUNCH_UNLAUNCH, &STR_RELAUNCH_DSIWARE_3DS_HOME, &STR_RELAUNCH_DSIWARE_UNLAUNCH,
+	}) {
+		queueTextLayout(false, *str);
+	}
+}
+
 void mdRomTooBig(void) {
 	// int bottomBright = 0;
 
@@ -2638,7 +2704,7 @@ bool selectMenu(void) {
 	return false;
 }
 
-void getFileInfo(SwitchState scrn, vector<vector<DirEntry>> dirContents, bool reSpawnBoxes) {
+void getFileInfo(SwitchState scrn, const vector<vector<DirEntry>>& dirContents, bool reSpawnBoxes) {
 	if (nowLoadingDisplaying) {
 		clearText();
 		showProgressBar = true;
@@ -2649,89 +2715,92 @@ void getFileInfo(SwitchState scrn, vector<vector<DirEntry>> dirContents, bool re
 		spawnedtitleboxes = 0;
 	for (int i = 0; i < 40; i++) {
 		if (i + PAGENUM * 40 < file_count) {
-			isDirectory[i] = dirContents[scrn][i + PAGENUM * 40].isDirectory;
 			const std::string &std_romsel_filename = dirContents[scrn][i + PAGENUM * 40].name;
-			getGameInfo(isDirectory[i], std_romsel_filename.c_str(), i);
+			if (!restoreSlotRecord(i + PAGENUM * 40, std_romsel_filename, i)) {
+				isDirectory[i] = dirContents[scrn][i + PAGENUM * 40].isDirectory;
+				getGameInfo(isDirectory[i], std_romsel_filename.c_str(), i);
 
-			if (isDirectory[i]) {
-				bnrWirelessIcon[i] = 0;
-			} else {
-				if (extension(std_romsel_filename, {".nds", ".dsi", ".ids", ".srl", ".app", ".argv"})) {
-					bnrRomType[i] = 0;
-				} else if (extension(std_romsel_filename, {".xex", ".atr", ".a26", ".a52", ".a78"})) {
-					bnrRomType[i] = 10;
-				} else if (extension(std_romsel_filename, {".msx"})) {
-					bnrRomType[i] = 21;
-				} else if (extension(std_romsel_filename, {".col"})) {
-					bnrRomType[i] = 13;
-				} else if (extension(std_romsel_filename, {".m5"})) {
-					bnrRomType[i] = 14;
-				} else if (extension(std_romsel_filename, {".int"})) {
-					bnrRomType[i] = 12;
-				} else if (extension(std_romsel_filename, {".plg"})) {
-					bnrRomType[i] = 9;
-				} else if (extension(std_romsel_filename, {".avi", ".rvid", ".fv"})) {
-					bnrRomType[i] = 19;
-				} else if (extension(std_romsel_filename, {".gif", ".bmp", ".png"})) {
-					bnrRomType[i] = 20;
-				} else if (extension(std_romsel_filename, {".agb", ".gba", ".mb"})) {
-					bnrRomType[i] = 1;
-				} else if (extension(std_romsel_filename, {".gb", ".sgb"})) {
-					bnrRomType[i] = 2;
-				} else if (extension(std_romsel_filename, {".gbc"})) {
-					bnrRomType[i] = 3;
-				} else if (extension(std_romsel_filename, {".nes"})) {
-					bnrRomType[i] = 4;
-				} else if (extension(std_romsel_filename, {".fds"})) {
-					bnrRomType[i] = 4;
-				} else if (extension(std_romsel_filename, {".sg", ".sc"})) {
-					bnrRomType[i] = 15;
-				} else if (extension(std_romsel_filename, {".sms"})) {
-					bnrRomType[i] = 5;
-				} else if (extension(std_romsel_filename, {".gg"})) {
-					bnrRomType[i] = 6;
-				} else if (extension(std_romsel_filename, {".gen", ".md"})) {
-					bnrRomType[i] = 7;
-				} else if (extension(std_romsel_filename, {".smc"})) {
-					bnrRomType[i] = 8;
-				} else if (extension(std_romsel_filename, {".sfc"})) {
-					bnrRomType[i] = 8;
-				} else if (extension(std_romsel_filename, {".pce"})) {
-					bnrRomType[i] = 11;
-				} else if (extension(std_romsel_filename, {".ws", ".wsc"})) {
-					bnrRomType[i] = 16;
-				} else if (extension(std_romsel_filename, {".ngp", ".ngc"})) {
-					bnrRomType[i] = 17;
-				} else if (extension(std_romsel_filename, {".dsk"})) {
-					bnrRomType[i] = 18;
-				} else if (extension(std_romsel_filename, {".min"})) {
-					bnrRomType[i] = 22;
-				} else if (extension(std_romsel_filename, {".ntrb"})) {
-					bnrRomType[i] = 23;
+				if (isDirectory[i]) {
+					bnrWirelessIcon[i] = 0;
 				} else {
-					bnrRomType[i] = 9;
-				}
+					if (extension(std_romsel_filename, {".nds", ".dsi", ".ids", ".srl", ".app", ".argv"})) {
+						bnrRomType[i] = 0;
+					} else if (extension(std_romsel_filename, {".xex", ".atr", ".a26", ".a52", ".a78"})) {
+						bnrRomType[i] = 10;
+					} else if (extension(std_romsel_filename, {".msx"})) {
+						bnrRomType[i] = 21;
+					} else if (extension(std_romsel_filename, {".col"})) {
+						bnrRomType[i] = 13;
+					} else if (extension(std_romsel_filename, {".m5"})) {
+						bnrRomType[i] = 14;
+					} else if (extension(std_romsel_filename, {".int"})) {
+						bnrRomType[i] = 12;
+					} else if (extension(std_romsel_filename, {".plg"})) {
+						bnrRomType[i] = 9;
+					} else if (extension(std_romsel_filename, {".avi", ".rvid", ".fv"})) {
+						bnrRomType[i] = 19;
+					} else if (extension(std_romsel_filename, {".gif", ".bmp", ".png"})) {
+						bnrRomType[i] = 20;
+					} else if (extension(std_romsel_filename, {".agb", ".gba", ".mb"})) {
+						bnrRomType[i] = 1;
+					} else if (extension(std_romsel_filename, {".gb", ".sgb"})) {
+						bnrRomType[i] = 2;
+					} else if (extension(std_romsel_filename, {".gbc"})) {
+						bnrRomType[i] = 3;
+					} else if (extension(std_romsel_filename, {".nes"})) {
+						bnrRomType[i] = 4;
+					} else if (extension(std_romsel_filename, {".fds"})) {
+						bnrRomType[i] = 4;
+					} else if (extension(std_romsel_filename, {".sg", ".sc"})) {
+						bnrRomType[i] = 15;
+					} else if (extension(std_romsel_filename, {".sms"})) {
+						bnrRomType[i] = 5;
+					} else if (extension(std_romsel_filename, {".gg"})) {
+						bnrRomType[i] = 6;
+					} else if (extension(std_romsel_filename, {".gen", ".md"})) {
+						bnrRomType[i] = 7;
+					} else if (extension(std_romsel_filename, {".smc"})) {
+						bnrRomType[i] = 8;
+					} else if (extension(std_romsel_filename, {".sfc"})) {
+						bnrRomType[i] = 8;
+					} else if (extension(std_romsel_filename, {".pce"})) {
+						bnrRomType[i] = 11;
+					} else if (extension(std_romsel_filename, {".ws", ".wsc"})) {
+						bnrRomType[i] = 16;
+					} else if (extension(std_romsel_filename, {".ngp", ".ngc"})) {
+						bnrRomType[i] = 17;
+					} else if (extension(std_romsel_filename, {".dsk"})) {
+						bnrRomType[i] = 18;
+					} else if (extension(std_romsel_filename, {".min"})) {
+						bnrRomType[i] = 22;
+					} else if (extension(std_romsel_filename, {".ntrb"})) {
+						bnrRomType[i] = 23;
+					} else {
+						bnrRomType[i] = 9;
+					}
 
-				if (bnrRomType[i] != 0) {
-					bnrWirelessIcon[i] = 0;
-					bnrSysSettings[i] = false;
-					isValid[i] = true;
-					isTwlm[i] = false;
-					isDSiWare[i] = false;
-					isHomebrew[i] = 0;
+					if (bnrRomType[i] != 0) {
+						bnrWirelessIcon[i] = 0;
+						bnrSysSettings[i] = false;
+						isValid[i] = true;
+						isTwlm[i] = false;
+						isDSiWare[i] = false;
+						isHomebrew[i] = 0;
+					}
 				}
+				saveSlotRecord(i + PAGENUM * 40, std_romsel_filename, i);
+			}
 
-				if (dsiFeatures() && !ms().macroMode && ms().showBoxArt == 2 && ms().theme != TWLSettings::EThemeHBL && !isDirectory[i]) {
+			if (dsiFeatures() && !ms().macroMode && ms().showBoxArt == 2 && ms().theme != TWLSettings::EThemeHBL && !isDirectory[i]) {
+				snprintf(boxArtPath, sizeof(boxArtPath), "%s:/_nds/TWiLightMenu/boxart/%s.png",
+						 sys().isRunFromSD() ? "sd" : "fat",
+						 dirContents[scrn][i + PAGENUM * 40].name.c_str());
+				if ((bnrRomType[i] == 0) && !folderIndexExists(boxArtPath)) {
 					snprintf(boxArtPath, sizeof(boxArtPath), "%s:/_nds/TWiLightMenu/boxart/%s.png",
-							 sys().isRunFromSD() ? "sd" : "fat",
-							 dirContents[scrn][i + PAGENUM * 40].name.c_str());
-					if ((bnrRomType[i] == 0) && (access(boxArtPath, F_OK) != 0)) {
-						snprintf(boxArtPath, sizeof(boxArtPath), "%s:/_nds/TWiLightMenu/boxart/%s.png",
-								 (sys().isRunFromSD() ? "sd" : "fat"),
-								 gameTid[i]);
-					}
-					tex().loadBoxArtToMem(boxArtPath, i);
+							 (sys().isRunFromSD() ? "sd" : "fat"),
+							 gameTid[i]);
 				}
+				tex().loadBoxArtToMem(boxArtPath, i);
 			}
 			if (reSpawnBoxes)
 				spawnedtitleboxes++;
@@ -2776,7 +2845,7 @@ void getFileInfo(SwitchState scrn, vector<vector<DirEntry>> dirContents, bool re
 	}
 }
 
-static bool previousPage(SwitchState scrn, vector<vector<DirEntry>> dirContents) {
+static bool previousPage(SwitchState scrn, const vector<vector<DirEntry>>& dirContents) {
 	if (CURPOS == 0 && !showLshoulder) {
 		snd().playWrong();
 		return false;
@@ -2847,7 +2916,7 @@ static bool previousPage(SwitchState scrn, vector<vector<DirEntry>> dirContents)
 	return showLshoulder;
 }
 
-static bool nextPage(SwitchState scrn, vector<vector<DirEntry>> dirContents) {
+static bool nextPage(SwitchState scrn, const vector<vector<DirEntry>>& dirContents) {
 	if (CURPOS == (file_count - 1) - PAGENUM * 40 && !showRshoulder) {
 		snd().playWrong();
 		return false;
@@ -3055,6 +3124,7 @@ bool setDefaultDirectory(std::string_view directory_path)
 std::string browseForFile(const std::vector<std::string_view> extensionList) {
 	displayNowLoading();
 	gameOrderIniPath = std::string(sys().isRunFromSD() ? "sd" : "fat") + ":/_nds/TWiLightMenu/extras/gameorder.ini";
+	gameOrderInit(gameOrderIniPath);
 	recentlyPlayedIniPath = std::string(sys().isRunFromSD() ? "sd" : "fat") + ":/_nds/TWiLightMenu/extras/recentlyplayed.ini";
 	timesPlayedIniPath = std::string(sys().isRunFromSD() ? "sd" : "fat") + ":/_nds/TWiLightMenu/extras/timesplayed.ini";
 
@@ -3221,6 +3291,7 @@ std::string browseForFile(const std::vector<std::string_view> extensionList) {
 				updateText(false);
 				buttonArrowTouched[0] = ((keysHeld() & KEY_TOUCH) && touch.py > 171 && touch.px < 19);
 				buttonArrowTouched[1] = ((keysHeld() & KEY_TOUCH) && touch.py > 171 && touch.px > 236);
+				layoutQueuedText();
 				bgOperations(true);
 				/*if (REG_SCFG_MC != current_SCFG_MC) {
 					break;
@@ -3392,12 +3463,13 @@ std::string browseForFile(const std::vector<std::string_view> extensionList) {
 						dirNames[i] = dirContents[scrn][i].name;
 					}
 
-					CIniFile gameOrderIni(gameOrderIniPath);
 					getcwd(path, PATH_MAX);
-					gameOrderIni.SetStringVector("ORDER", path, dirNames, ':');
-					gameOrderIni.SaveIniFile(gameOrderIniPath);
-
-					if (ms().sortMethod != TWLSettings::ESortCustom) {
+					gameOrderLoad(path);
+					if (ms().sortMethod == TWLSettings::ESortCustom) {
+						gameOrderMove(dirNames, dest);
+					} else {
+						// The stored ranks don't match the order shown, so place every file as shown
+						gameOrderRankAll(dirNames);
 						ms().sortMethod = TWLSettings::ESortCustom;
 						ms().saveSettings();
 					}
@@ -4355,6 +4427,7 @@ std::string browseForFile(const std::vector<std::string_view> extensionList) {
 						remove(dirContents[scrn]
 							   .at(CURPOS + PAGENUM * 40)
 							   .name.c_str()); // Remove game/folder
+						folderIndexNoteRemoved(dirContents[scrn].at(CURPOS + PAGENUM * 40).name.c_str());
 						if (ms().showBoxArt)
 							clearBoxArt(); // Clear box art
 						boxArtLoaded = false;
@@ -4391,8 +4464,11 @@ std::string browseForFile(const std::vector<std::string_view> extensionList) {
 						// Remove leading . if it exists
 						if ((strncmp(entry->name.c_str(), ".", 1) == 0 && entry->name != "..")) {
 							rename(entry->name.c_str(), entry->name.substr(1).c_str());
+							folderIndexNoteRemoved(entry->name.c_str());
+							folderIndexNoteAdded(entry->name.substr(1).c_str());
 						} else { // Otherwise toggle the hidden attribute bit
 							FAT_setAttr(entry->name.c_str(), FAT_getAttr(entry->name.c_str()) ^ ATTR_HIDDEN);
+							discCacheFlushAll();
 						}
 
 						if (ms().showBoxArt)
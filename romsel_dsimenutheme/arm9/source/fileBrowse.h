@@ -32,6 +32,8 @@
 
 bool extension(const std::string_view filename, const std::vector<std::string_view> extensions);
 
+void queueDialogLayouts(void);
+
 std::string browseForFile(const std::vector<std::string_view> extensionList);
 
 #endif //FILE_BROWSE_H
@@ -1,6 +1,8 @@
 #include "common/nds_loader_arm9.h"
 #include "common/twlmenusettings.h"
 #include "common/tonccpy.h"
+#include "common/slot2Cache.h"
+#include "common/scratchArena.h"
 #include "graphics/ThemeTextures.h"
 #include "common/lodepng.h"
 #include "gbaswitch.h"
@@ -11,7 +13,9 @@ void loadGbaBorder(const char* filename) {
 	lodepng::decode(image, imageWidth, imageHeight, filename);
 	bool alternatePixel = false;
 
-	u16* bmpImageBuffer = new u16[256 * 192];
+	ScratchBuffer bmpImage(256 * 192 * sizeof(u16));
+	if (!bmpImage) return;
+	u16* bmpImageBuffer = bmpImage.as<u16>();
 
 	for (uint i = 0; i < image.size()/4; i++) {
 		image[(i*4)+3] = 0;
@@ -65,11 +69,10 @@ void loadGbaBorder(const char* filename) {
 	}
 	DC_FlushRange(bmpImageBuffer,SCREEN_WIDTH*SCREEN_HEIGHT*2);
 	dmaCopy(bmpImageBuffer,(void*)BG_BMP_RAM(8),SCREEN_WIDTH*SCREEN_HEIGHT*2);
-
-	delete[] bmpImageBuffer;
 }
 
 void gbaSwitch(void) {
+	slot2CacheRelease();
 	irqDisable(IRQ_VBLANK);
 
 	videoSetMode(MODE_5_2D | DISPLAY_BG3_ACTIVE);
@@ -244,7 +244,7 @@ int FontGraphic::calcWidth(std::u16string_view text) {
 	return x;
 }
 
-ITCM_CODE void FontGraphic::print(int x, int y, bool top, std::u16string_view text, Alignment align, FontPalette palette, bool rtl) {
+ITCM_CODE void FontGraphic::layout(int x, int y, std::u16string_view text, Alignment align, bool rtl, std::vector<Glyph> &out) {
 	// If RTL isn't forced, check for RTL text
 	if (!rtl) {
 		for (const auto c : text) {
@@ -263,7 +263,7 @@ ITCM_CODE void FontGraphic::print(int x, int y, bool top, std::u16string_view te
 		} case Alignment::center: {
 			size_t newline = text.find('\n');
 			while (newline != text.npos) {
-				print(x, y, top, text.substr(0, newline), align, palette, rtl);
+				layout(x, y, text.substr(0, newline), align, rtl, out);
 				text = text.substr(newline + 1);
 				newline = text.find('\n');
 				y += tileHeight;
@@ -274,7 +274,7 @@ ITCM_CODE void FontGraphic::print(int x, int y, bool top, std::u16string_view te
 		} case Alignment::right: {
 			size_t newline = text.find('\n');
 			while (newline != text.npos) {
-				print(x - calcWidth(text.substr(0, newline)), y, top, text.substr(0, newline), Alignment::left, palette, rtl);
+				layout(x - calcWidth(text.substr(0, newline)), y, text.substr(0, newline), Alignment::left, rtl, out);
 				text = text.substr(newline + 1);
 				newline = text.find('\n');
 				y += tileHeight;
@@ -401,64 +401,104 @@ ITCM_CODE void FontGraphic::print(int x, int y, bool top, std::u16string_view te
 			index = getCharIndex(*it);
 		}
 
-		if (useTileCache) {
-			bool found = false;
-			bool overwrite = true;
-			u8 cachePos = 0;
-			for (u8 i = 0; i < tileCacheCount; i++) {
-				if (!cacheAllocated[i]) {
-					indexCache[i] = index;
-					cachePos = i;
-					cacheAllocated[i] = true;
-					overwrite = false;
-					break;
-				} else if (indexCache[i] == index) {
-					cachePos = i;
-					found = true;
-					overwrite = false;
-					break;
-				}
-			}
+		out.push_back({(s16)x, (s16)y, index});
 
-			if (overwrite) {
-				nextCachePos++;
-				if (nextCachePos == tileCacheCount) {
-					nextCachePos = 0;
-				}
-				cachePos = nextCachePos;
-				indexCache[cachePos] = index;
+		x += fontWidths[(index * 3) + 2];
+	}
+}
+
+ITCM_CODE void FontGraphic::drawGlyph(int x, int y, bool top, u16 index, FontPalette palette) {
+	if (useTileCache) {
+		bool found = false;
+		bool overwrite = true;
+		u8 cachePos = 0;
+		for (u8 i = 0; i < tileCacheCount; i++) {
+			if (!cacheAllocated[i]) {
+				indexCache[i] = index;
+				cachePos = i;
+				cacheAllocated[i] = true;
+				overwrite = false;
+				break;
+			} else if (indexCache[i] == index) {
+				cachePos = i;
+				found = true;
+				overwrite = false;
+				break;
 			}
+		}
 
-			if (!found && file) {
-				fseek(file, tileOffset+(index * tileSize), SEEK_SET);
-				fread(fontTiles+(cachePos * tileSize), tileSize, 1, file);
+		if (overwrite) {
+			nextCachePos++;
+			if (nextCachePos == tileCacheCount) {
+				nextCachePos = 0;
 			}
+			cachePos = nextCachePos;
+			indexCache[cachePos] = index;
+		}
 
-			// Don't draw off screen chars
-			if (x >= 0 && x + fontWidths[(index * 3) + 2] < 256 && y >= 0 && y + tileHeight < 192) {
-				u8 *dst = textBuf[top] + x + fontWidths[(index * 3)];
-				for (int i = 0; i < tileHeight; i++) {
-					for (int j = 0; j < tileWidth; j++) {
-						u8 px = fontTiles[(cachePos * tileSize) + (i * tileWidth + j) / 4] >> ((3 - ((i * tileWidth + j) % 4)) * 2) & 3;
-						if (px)
-							dst[(y + i) * 256 + j] = 4 * ((int)palette) + px;
-					}
+		if (!found && file) {
+			fseek(file, tileOffset+(index * tileSize), SEEK_SET);
+			fread(fontTiles+(cachePos * tileSize), tileSize, 1, file);
+		}
+
+		// Don't draw off screen chars
+		if (x >= 0 && x + fontWidths[(index * 3) + 2] < 256 && y >= 0 && y + tileHeight < 192) {
+			u8 *dst = textBuf[top] + x + fontWidths[(index * 3)];
+			for (int i = 0; i < tileHeight; i++) {
+				for (int j = 0; j < tileWidth; j++) {
+					u8 px = fontTiles[(cachePos * tileSize) + (i * tileWidth + j) / 4] >> ((3 - ((i * tileWidth + j) % 4)) * 2) & 3;
+					if (px)
+						dst[(y + i) * 256 + j] = 4 * ((int)palette) + px;
 				}
 			}
-		} else {
-			// Don't draw off screen chars
-			if (x >= 0 && x + fontWidths[(index * 3) + 2] < 256 && y >= 0 && y + tileHeight < 192) {
-				u8 *dst = textBuf[top] + x + fontWidths[(index * 3)];
-				for (int i = 0; i < tileHeight; i++) {
-					for (int j = 0; j < tileWidth; j++) {
-						u8 px = fontTiles[(index * tileSize) + (i * tileWidth + j) / 4] >> ((3 - ((i * tileWidth + j) % 4)) * 2) & 3;
-						if (px)
-							dst[(y + i) * 256 + j] = 4 * ((int)palette) + px;
-					}
+		}
+	} else {
+		// Don't draw off screen chars
+		if (x >= 0 && x + fontWidths[(index * 3) + 2] < 256 && y >= 0 && y + tileHeight < 192) {
+			u8 *dst = textBuf[top] + x + fontWidths[(index * 3)];
+			for (int i = 0; i < tileHeight; i++) {
+				for (int j = 0; j < tileWidth; j++) {
+					u8 px = fontTiles[(index * tileSize) + (i * tileWidth + j) / 4] >> ((3 - ((i * tileWidth + j) % 4)) * 2) & 3;
+					if (px)
+						dst[(y + i) * 256 + j] = 4 * ((int)palette) + px;
 				}
 			}
 		}
+	}
+}
 
-		x += fontWidths[(index * 3) + 2];
+static std::u16string layoutKey(std::u16string_view text, Alignment align) {
+	std::u16string key(text);
+	key += (char16_t)align;
+	return key;
+}
+
+void FontGraphic::cacheLayout(std::u16string_view text, Alignment align) {
+	std::u16string key = layoutKey(text, align);
+	if (layoutCache.find(key) != layoutCache.end())
+		return;
+
+	std::vector<Glyph> glyphs;
+	layout(0, 0, text, align, false, glyphs);
+	layoutCache.emplace(std::move(key), std::move(glyphs));
+}
+
+ITCM_CODE void FontGraphic::print(int x, int y, bool top, std::u16string_view text, Alignment align, FontPalette palette, bool rtl) {
+	// Strings laid out ahead of time only need their glyphs drawn
+	if (!rtl && !layoutCache.empty()) {
+		auto cached = layoutCache.find(layoutKey(text, align));
+		if (cached != layoutCache.end()) {
+			for (const Glyph &glyph : cached->second) {
+				drawGlyph(x + glyph.x, y + glyph.y, top, glyph.index, palette);
+			}
+			return;
+		}
+	}
+
+	static std::vector<Glyph> glyphs;
+	glyphs.clear();
+	layout(x, y, text, align, rtl, glyphs);
+	for (const Glyph &glyph : glyphs) {
+		drawGlyph(glyph.x, glyph.y, top, glyph.index, palette);
 	}
 }
@@ -5,6 +5,7 @@
 #include <nds.h>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <vector>
 
 #define tileCacheCount 128
@@ -49,8 +50,20 @@ private:
 	u8 *fontWidths = nullptr;
 	u16 *fontMap = nullptr;
 
+	// A glyph placed by layout(), before clipping
+	struct Glyph {
+		s16 x, y;
+		u16 index;
+	};
+
+	// Laid out strings, relative to where they're printed. Keyed by the text and alignment.
+	std::unordered_map<std::u16string, std::vector<Glyph>> layoutCache;
+
 	u16 getCharIndex(char16_t c);
 
+	void layout(int x, int y, std::u16string_view text, Alignment align, bool rtl, std::vector<Glyph> &out);
+	void drawGlyph(int x, int y, bool top, u16 index, FontPalette palette);
+
 public:
 	static u8 textBuf[2][256 * 192];
 
@@ -66,6 +79,9 @@ public:
 	int calcWidth(std::string_view text) { return calcWidth(utf8to16(text)); }
 	int calcWidth(std::u16string_view text);
 
+	// Lay out text ahead of time, so printing it later only draws the glyphs
+	void cacheLayout(std::u16string_view text, Alignment align);
+
 	void print(int x, int y, bool top, int value, Alignment align, FontPalette palette, bool rtl = false) { print(x, y, top, std::to_string(value), align, palette, rtl); }
 	void print(int x, int y, bool top, std::string_view text, Alignment align, FontPalette palette, bool rtl = false) { print(x, y, top, utf8to16(text), align, palette, rtl); }
 	void print(int x, int y, bool top, std::u16string_view text, Alignment align, FontPalette palette, bool rtl = false);
@@ -1,6 +1,7 @@
 #include "Texture.h"
 #include "paletteEffects.h"
 #include "common/tonccpy.h"
+#include "idleGovernor.h"
 #include "common/twlmenusettings.h"
 #include "common/lodepng.h"
 // #include "common/ColorLut.h"
@@ -165,7 +166,9 @@ void Texture::loadBitmap(FILE *file) noexcept {
 void Texture::loadPNG(const std::string &path) {
 	std::vector<unsigned char> buffer;
 	unsigned width, height;
+	idleGovernorBeginWork();
 	lodepng::decode(buffer, width, height, path);
+	idleGovernorEndWork();
 	_texWidth = width;
 	_texHeight = height;
 	_texLength = _texWidth * _texHeight;
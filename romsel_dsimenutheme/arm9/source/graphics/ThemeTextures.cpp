@@ -7,6 +7,8 @@
 #include "common/twlmenusettings.h"
 #include "common/systemdetails.h"
 #include "common/logging.h"
+#include "common/slot2Cache.h"
+#include "common/scratchArena.h"
 #include "myDSiMode.h"
 
 #include "paletteEffects.h"
@@ -20,6 +22,7 @@
 #include "errorScreen.h"
 #include "fileBrowse.h"
 #include "fileCopy.h"
+#include "idleGovernor.h"
 #include "common/lzss.h"
 #include "common/tonccpy.h"
 #include "common/lodepng.h"
@@ -777,97 +780,105 @@ void ThemeTextures::loadIconUnknownTexture() {
 	}
 	logPrint("Loaded iconUnknownTexture\n");
 }
-u16 *ThemeTextures::beginBgSubModify() {
-	if (ms().macroMode)
-		return _bgSubBuffer;
+// The top screen is composed in _bgSubBuffer (and _bgSubBuffer2), which always
+// hold what's shown, and copied out once on the next vblank
+static volatile bool bgSubCommitPending = false;
+static volatile bool bgSubModifying = false; // Don't show half-drawn changes
+static bool bgPresentRunning = false; // vBlankHandler has been set up
 
-	u16* bgLoc = BG_GFX_SUB;
-	if (boxArtColorDeband) {
-		bgLoc = _frameBufferBot[0];
-	}
-	dmaCopyWords(0, bgLoc, _bgSubBuffer, sizeof(u16) * BG_BUFFER_PIXELCOUNT);
+// Bottom backgrounds stay in main BG VRAM, on either side of BG2's bitmap,
+// and are switched between by moving BG3's bitmap base
+#define BOTTOM_BG_SLOTS 2
+static const int bottomBgBase[BOTTOM_BG_SLOTS] = {0, 10}; // 0x06000000, 0x06028000
+static int bottomBgInSlot[BOTTOM_BG_SLOTS] = {-1, -1}; // -1 once drawn over
+static int bottomBgSlot = 0; // Shown
+static int bottomBgId = 3;
+
+static ThemeTextures::BgCopyStats bgCopyStats;
+
+static inline u16 *bottomBgVram(int slot) { return BG_GFX + bottomBgBase[slot] * (0x4000 / sizeof(u16)); }
+
+static void copyBgSub(void) {
 	if (boxArtColorDeband) {
-		dmaCopyWords(0, _frameBufferBot[1], _bgSubBuffer2, sizeof(u16) * BG_BUFFER_PIXELCOUNT);
+		// Handed to VRAM by vBlankHandler
+		dmaCopyWords(2, _bgSubBuffer, _frameBufferBot[0], sizeof(u16) * BG_BUFFER_PIXELCOUNT);
+		dmaCopyWords(2, _bgSubBuffer2, _frameBufferBot[1], sizeof(u16) * BG_BUFFER_PIXELCOUNT);
+	} else if (rocketVideo_playVideo) {
+		// Leave the rotating cubes' current frame alone
+		extern u8 rocketVideo_height;
+		extern int rocketVideo_videoYpos;
+		const int videoEnd = std::min(rocketVideo_videoYpos + rocketVideo_height, SCREEN_HEIGHT);
+		if (rocketVideo_videoYpos > 0) {
+			dmaCopyWords(2, _bgSubBuffer, BG_GFX_SUB, sizeof(u16) * SCREEN_WIDTH * rocketVideo_videoYpos);
+		}
+		if (videoEnd < SCREEN_HEIGHT) {
+			dmaCopyWords(2, _bgSubBuffer + SCREEN_WIDTH * videoEnd, BG_GFX_SUB + SCREEN_WIDTH * videoEnd, sizeof(u16) * SCREEN_WIDTH * (SCREEN_HEIGHT - videoEnd));
+		}
+	} else {
+		dmaCopyWords(2, _bgSubBuffer, BG_GFX_SUB, sizeof(u16) * BG_BUFFER_PIXELCOUNT);
 	}
+	bgCopyStats.vramWrites++;
+}
+
+u16 *ThemeTextures::beginBgSubModify() {
+	bgSubModifying = true;
 	return _bgSubBuffer;
 }
 
 void ThemeTextures::commitBgSubModify() {
+	bgSubModifying = false;
 	if (ms().macroMode)
 		return;
 
-	u16* bgLoc = BG_GFX_SUB;
-	if (boxArtColorDeband) {
-		bgLoc = _frameBufferBot[0];
-	}
 	DC_FlushRange(_bgSubBuffer, sizeof(u16) * BG_BUFFER_PIXELCOUNT);
 	if (boxArtColorDeband) {
 		DC_FlushRange(_bgSubBuffer2, sizeof(u16) * BG_BUFFER_PIXELCOUNT);
 	}
-	while (REG_VCOUNT != 191); // Fix screen tearing
-	dmaCopyWords(2, _bgSubBuffer, bgLoc, sizeof(u16) * BG_BUFFER_PIXELCOUNT);
-	if (boxArtColorDeband) {
-		dmaCopyWords(2, _bgSubBuffer2, _frameBufferBot[1], sizeof(u16) * BG_BUFFER_PIXELCOUNT);
+	if (!bgPresentRunning || !(REG_IE & IRQ_VBLANK)) {
+		// vBlankHandler isn't running
+		while (REG_VCOUNT != 191); // Fix screen tearing
+		copyBgSub();
+		bgSubCommitPending = false;
+		return;
 	}
+	if (bgSubCommitPending) {
+		bgCopyStats.commitsMerged++;
+	}
+	bgSubCommitPending = true;
 }
 
 void ThemeTextures::commitBgSubModifyAsync() {
-	if (ms().macroMode)
-		return;
+	commitBgSubModify();
+}
 
-	u16* bgLoc = BG_GFX_SUB;
-	if (boxArtColorDeband) {
-		bgLoc = _frameBufferBot[0];
-	}
-	DC_FlushRange(_bgSubBuffer, sizeof(u16) * BG_BUFFER_PIXELCOUNT);
-	if (boxArtColorDeband && ndmaEnabled()) {
-		DC_FlushRange(_bgSubBuffer2, sizeof(u16) * BG_BUFFER_PIXELCOUNT);
-	}
-	while (REG_VCOUNT != 191); // Fix screen tearing
-	dmaCopyWordsAsynch(2, _bgSubBuffer, bgLoc, sizeof(u16) * BG_BUFFER_PIXELCOUNT);
-	if (boxArtColorDeband) {
-		if (ndmaEnabled()) {
-			ndmaCopyWordsAsynch(2, _bgSubBuffer2, _frameBufferBot[1], sizeof(u16) * BG_BUFFER_PIXELCOUNT);
-		} else {
-			tonccpy(_frameBufferBot[1], _bgSubBuffer2, sizeof(u16) * BG_BUFFER_PIXELCOUNT);
-		}
+void ThemeTextures::presentBg() {
+	bgPresentRunning = true;
+	if (bgSubCommitPending && !bgSubModifying) {
+		copyBgSub();
+		bgSubCommitPending = false;
 	}
 }
 
+const ThemeTextures::BgCopyStats &ThemeTextures::bgStats() { return bgCopyStats; }
+
 u16 *ThemeTextures::beginBgMainModify() {
-	u16* bgLoc = BG_GFX;
-	/*if (boxArtColorDeband) {
-		bgLoc = _frameBufferBot[0];
-	}*/
-	dmaCopyWords(0, bgLoc, _bgMainBuffer, sizeof(u16) * BG_BUFFER_PIXELCOUNT);
-	/*if (ndmaEnabled()) {
-		dmaCopyWords(0, _frameBuffer[1], _bgMainBuffer, sizeof(u16) * BG_BUFFER_PIXELCOUNT);
-	}*/
+	// What's drawn over the shown background stays until it's drawn again
+	bottomBgInSlot[bottomBgSlot] = -1;
+	dmaCopyWords(0, bottomBgVram(bottomBgSlot), _bgMainBuffer, sizeof(u16) * BG_BUFFER_PIXELCOUNT);
+	bgCopyStats.vramReads++;
 	return _bgMainBuffer;
 }
 
 void ThemeTextures::commitBgMainModify() {
-	u16* bgLoc = BG_GFX;
-	/*if (boxArtColorDeband) {
-		bgLoc = _frameBufferBot[0];
-	}*/
 	DC_FlushRange(_bgMainBuffer, sizeof(u16) * BG_BUFFER_PIXELCOUNT);
-	dmaCopyWords(2, _bgMainBuffer, bgLoc, sizeof(u16) * BG_BUFFER_PIXELCOUNT);
-	/*if (ndmaEnabled()) {
-		dmaCopyWords(2, _bgMainBuffer, _frameBuffer[1], sizeof(u16) * BG_BUFFER_PIXELCOUNT);
-	}*/
+	dmaCopyWords(2, _bgMainBuffer, bottomBgVram(bottomBgSlot), sizeof(u16) * BG_BUFFER_PIXELCOUNT);
+	bgCopyStats.vramWrites++;
 }
 
 void ThemeTextures::commitBgMainModifyAsync() {
-	u16* bgLoc = BG_GFX;
-	/*if (boxArtColorDeband) {
-		bgLoc = _frameBufferBot[0];
-	}*/
 	DC_FlushRange(_bgMainBuffer, sizeof(u16) * BG_BUFFER_PIXELCOUNT);
-	dmaCopyWordsAsynch(2, _bgMainBuffer, bgLoc, sizeof(u16) * BG_BUFFER_PIXELCOUNT);
-	/*if (boxArtColorDeband) {
-		ndmaCopyWordsAsynch(2, _bgMainBuffer, _frameBuffer[1], sizeof(u16) * BG_BUFFER_PIXELCOUNT);
-	}*/
+	dmaCopyWordsAsynch(2, _bgMainBuffer, bottomBgVram(bottomBgSlot), sizeof(u16) * BG_BUFFER_PIXELCOUNT);
+	bgCopyStats.vramWrites++;
 }
 
 void ThemeTextures::drawTopBg() {
@@ -890,11 +901,23 @@ void ThemeTextures::drawBottomBg(int index) {
 		index = 3;
 	if (index > 2 && ms().theme == TWLSettings::ETheme3DS)
 		index = 2;
-	beginBgMainModify();
 
-	_backgroundTextures[index].copy(_bgMainBuffer, false);
+	int slot = 0;
+	while (slot < BOTTOM_BG_SLOTS && bottomBgInSlot[slot] != index) {
+		slot++;
+	}
+	if (slot == BOTTOM_BG_SLOTS) {
+		// Not resident, so draw it where it isn't shown yet
+		slot = (bottomBgSlot + 1) % BOTTOM_BG_SLOTS;
+		_backgroundTextures[index].copy(bottomBgVram(slot), true);
+		bottomBgInSlot[slot] = index;
+		bgCopyStats.vramWrites++;
+	} else {
+		bgCopyStats.flips++;
+	}
 
-	commitBgMainModify();
+	bottomBgSlot = slot;
+	bgSetMapBase(bottomBgId, bottomBgBase[slot]);
 }
 
 void ThemeTextures::clearTopScreen() {
@@ -986,20 +1009,26 @@ void ThemeTextures::loadBoxArtToMem(const char *filename, int num) {
 void ThemeTextures::drawBoxArt(const char *filename, bool inMem) {
 	if (inMem ? !boxArtFound[CURPOS] : access(filename, F_OK) != 0) return;
 
-	beginBgSubModify();
-
 	std::vector<unsigned char> image;
 	uint imageXpos, imageYpos;
+	idleGovernorBeginWork();
 	if (inMem) {
 		lodepng::decode(image, boxArtWidth, boxArtHeight, (unsigned char*)boxArtCache+(CURPOS*0xB000), 0xB000);
 	} else {
 		lodepng::decode(image, boxArtWidth, boxArtHeight, filename);
 	}
+	idleGovernorEndWork();
 	bool alternatePixel = false;
 	if (boxArtWidth > 256 || boxArtHeight > 192) return;
 
-	u16* bmpImageBuffer = new u16[256 * 192];
-	u16* bmpImageBuffer2 = boxArtColorDeband ? new u16[256 * 192] : NULL;
+	ScratchBuffer bmpImage(256 * 192 * sizeof(u16));
+	ScratchBuffer bmpImage2(boxArtColorDeband ? 256 * 192 * sizeof(u16) : 0);
+	if (!bmpImage || (boxArtColorDeband && !bmpImage2)) return;
+
+	beginBgSubModify();
+
+	u16* bmpImageBuffer = bmpImage.as<u16>();
+	u16* bmpImageBuffer2 = bmpImage2.as<u16>();
 
 	imageXpos = (256-boxArtWidth)/2;
 	imageYpos = (192-boxArtHeight)/2;
@@ -1098,11 +1127,6 @@ void ThemeTextures::drawBoxArt(const char *filename, bool inMem) {
 		}
 	}
 	commitBgSubModify();
-
-	delete[] bmpImageBuffer;
-	if (boxArtColorDeband) {
-		delete[] bmpImageBuffer2;
-	}
 }
 
 #define MAX_PHOTO_WIDTH 208
@@ -1417,6 +1441,10 @@ ITCM_CODE void ThemeTextures::drawDateTime(const char *str, int posX, int posY,
 	dateTimeFont()->print(0, 0, true, str, Alignment::left, FontPalette::dateTime);
 	int width = std::max(dateTimeFont()->calcWidth(str), isDate ? _previousDateWidth : _previousTimeWidth);
 
+	// Don't let a pending commit copy the buffers out halfway through
+	const bool wasModifying = bgSubModifying;
+	bgSubModifying = true;
+
 	// Copy to background
 	for (int y = 0; y < dateTimeFont()->height() && posY + y < SCREEN_HEIGHT; y++) {
 		if (posY + y < 0) continue;
@@ -1427,13 +1455,29 @@ ITCM_CODE void ThemeTextures::drawDateTime(const char *str, int posX, int posY,
 			u16 val = px ? themealphablend(BG_PALETTE[px], bg, (px % 4) < 2 ? 128 : 224) : bg;
 
 			BG_GFX_SUB[(posY + y) * 256 + (posX + x)] = val;
+			_bgSubBuffer[(posY + y) * 256 + (posX + x)] = val;
 			if (boxArtColorDeband) {
+				_bgSubBuffer2[(posY + y) * 256 + (posX + x)] = val;
 				_frameBufferBot[0][(posY + y) * 256 + (posX + x)] = val;
 				_frameBufferBot[1][(posY + y) * 256 + (posX + x)] = val;
 			}
 		}
 	}
 
+	// The buffers are copied out by DMA, so write the drawn rows back from the data cache
+	const int firstRow = std::max(posY, 0);
+	const int rowCount = std::min(posY + dateTimeFont()->height(), SCREEN_HEIGHT) - firstRow;
+	if (rowCount > 0) {
+		const u32 size = sizeof(u16) * 256 * rowCount;
+		DC_FlushRange(_bgSubBuffer + firstRow * 256, size);
+		if (boxArtColorDeband) {
+			DC_FlushRange(_bgSubBuffer2 + firstRow * 256, size);
+			DC_FlushRange(_frameBufferBot[0] + firstRow * 256, size);
+			DC_FlushRange(_frameBufferBot[1] + firstRow * 256, size);
+		}
+	}
+	bgSubModifying = wasModifying;
+
 	if (isDate) {
 		_previousDateWidth = dateTimeFont()->calcWidth(str);
 	} else {
@@ -1454,6 +1498,8 @@ ITCM_CODE void ThemeTextures::drawDateTimeMacro(const char *str, int posX, int p
 	int width = std::max(dateTimeFont()->calcWidth(str), isDate ? _previousDateWidth : _previousTimeWidth);
 
 	// Copy to background
+	u16 *bgLoc = bottomBgVram(bottomBgSlot);
+	bottomBgInSlot[bottomBgSlot] = -1;
 	for (int y = 0; y < dateTimeFont()->height() && posY + y < SCREEN_HEIGHT; y++) {
 		if (posY + y < 0) continue;
 		for (int x = 0; x < width && posX + x < SCREEN_WIDTH; x++) {
@@ -1462,7 +1508,7 @@ ITCM_CODE void ThemeTextures::drawDateTimeMacro(const char *str, int posX, int p
 			u16 bg = _topBorderBuffer[(posY + y) * 256 + (posX + x)];
 			u16 val = px ? themealphablend(BG_PALETTE[px], bg, (px % 4) < 2 ? 128 : 224) : bg;
 
-			BG_GFX[(posY + y) * 256 + (posX + x)] = val;
+			bgLoc[(posY + y) * 256 + (posX + x)] = val;
 		}
 	}
 
@@ -1655,8 +1701,11 @@ void ThemeTextures::videoSetup() {
 	//	vramSetBankH(VRAM_H_SUB_BG_EXT_PALETTE); // Not sure this does anything...
 	lcdMainOnBottom();
 
-	int bg3Main = bgInit(3, BgType_Bmp16, BgSize_B16_256x256, 0, 0);
+	int bg3Main = bgInit(3, BgType_Bmp16, BgSize_B16_256x256, bottomBgBase[0], 0);
 	bgSetPriority(bg3Main, 3);
+	bottomBgId = bg3Main;
+	bottomBgSlot = 0;
+	bottomBgInSlot[0] = bottomBgInSlot[1] = -1;
 
 	int bg2Main = bgInit(2, BgType_Bmp8, BgSize_B8_256x256, 6, 0);
 	nocashMessage(std::to_string(bg2Main).c_str());
@@ -1724,6 +1773,11 @@ void ThemeTextures::videoSetup() {
 		loadRotatingCubes();
 	}
 
+	if (sys().isRegularDS()) {
+		// After the rotating cubes, if they were loaded into Slot-2 RAM
+		slot2CacheInit((rotatingCubesLoaded && rotatingCubesLocation == (u8*)0x09000000) ? 0x700000 : 0);
+	}
+
 	_photoBuffer = new u16[208 * 156];
 
 	boxArtColorDeband = (ms().boxArtColorDeband && !ms().macroMode && (sys().isRegularDS() ? sys().dsDebugRam() : ndmaEnabled()) && !rotatingCubesLoaded && ms().theme != TWLSettings::EThemeHBL);
@@ -1734,4 +1788,7 @@ void ThemeTextures::videoSetup() {
 		_frameBufferBot[0] = new u16[256 * 192];
 		_frameBufferBot[1] = new u16[256 * 192];
 	}
+
+	// Box art is drawn through two screen buffers when debanding, one otherwise
+	scratchArenaInit(256 * 192 * sizeof(u16) * (boxArtColorDeband ? 2 : 1));
 }
\ No newline at end of file
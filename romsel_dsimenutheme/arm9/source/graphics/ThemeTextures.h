@@ -71,6 +71,20 @@ public:
 	static void commitBgMainModify();
 	static void commitBgMainModifyAsync();
 
+	/**
+	 * Copy the top background to VRAM if it was committed since the last
+	 * vblank. Called by vBlankHandler.
+	 */
+	static void presentBg();
+
+	struct BgCopyStats {
+		u32 vramReads;     // Backgrounds read back out of VRAM
+		u32 vramWrites;    // Backgrounds copied into VRAM
+		u32 flips;         // Bottom backgrounds shown without a copy
+		u32 commitsMerged; // Top background commits shown by a later copy
+	};
+	static const BgCopyStats &bgStats();
+
 	void drawTopBg();
 
 	void drawProfileName();
@@ -20,6 +20,7 @@ FontGraphic *largeFont;
 FontGraphic *esrbDescFont;
 
 std::list<TextEntry> topText, bottomText;
+static std::list<TextEntry> layoutQueue;
 
 bool shouldClear[] = {false, false};
 
@@ -189,6 +190,21 @@ FontGraphic *getFont(bool large) {
 	return large ? largeFont : smallFont;
 }
 
+void queueTextLayout(bool large, std::string_view message, Alignment align) {
+	layoutQueue.emplace_back(large, 0, 0, message, align, FontPalette::regular);
+}
+
+void layoutQueuedText(void) {
+	if (layoutQueue.empty())
+		return;
+
+	const TextEntry &entry = layoutQueue.front();
+	FontGraphic *font = getFont(entry.large);
+	if (font)
+		font->cacheLayout(entry.message, entry.align);
+	layoutQueue.pop_front();
+}
+
 void updateText(bool top) {
 	sassert(!top, "Top screen text must be copied\nmanually.");
 
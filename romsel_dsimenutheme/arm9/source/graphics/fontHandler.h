@@ -6,6 +6,10 @@ void fontInit();
 void esrbDescFontInit(bool dsFont);
 void esrbDescFontDeinit();
 
+// Dialog text is laid out ahead of time, one string per call while the menu is idle
+void queueTextLayout(bool large, std::string_view message, Alignment align = Alignment::center);
+void layoutQueuedText(void);
+
 void updateText(bool top);
 void updateTextImg(u16* img, bool top);
 void clearText(bool top);
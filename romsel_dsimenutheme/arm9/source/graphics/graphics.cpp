@@ -36,10 +36,12 @@
 #include "common/systemdetails.h"
 #include "common/my_rumble.h"
 #include "common/logging.h"
+#include "common/scratchArena.h"
 #include "myDSiMode.h"
 #include "date.h"
 #include "iconHandler.h"
 #include "fileBrowse.h"
+#include "idleGovernor.h"
 #include "fontHandler.h"
 #include "graphics/ThemeTextures.h"
 #include "common/lodepng.h"
@@ -399,6 +401,7 @@ void playRotatingCubesVideo(void) {
 }
 
 void vBlankHandler() {
+	tex().presentBg(); // First, while still early in vblank
 	execQueue();		   // Execute any actions queued during last vblank.
 	execDeferredIconUpdates(); // Update any icons queued during last vblank.
 
@@ -805,6 +808,8 @@ void vBlankHandler() {
 	// if (applaunchprep && ms().theme == TWLSettings::EThemeDSi)
 	// 	launchDotDoFrameChange = !launchDotDoFrameChange;
 
+	idleGovernorFrame(updateFrame);
+
 	if (updateFrame) {
 		glBegin2D();
 
@@ -1367,6 +1372,7 @@ void loadPhoto(const std::string &path, const bool bufferOnly) {
 	std::vector<unsigned char> image;
 	bool alternatePixel = false;
 
+	idleGovernorBeginWork();
 	lodepng::decode(image, photoWidth, photoHeight, path);
 
 	if (photoWidth > 208 || photoHeight > 156) {
@@ -1374,6 +1380,7 @@ void loadPhoto(const std::string &path, const bool bufferOnly) {
 		// Image is too big, load the default
 		lodepng::decode(image, photoWidth, photoHeight, "nitro:/graphics/photo_default.png");
 	}
+	idleGovernorEndWork();
 
 	for (uint i=0;i<image.size()/4;i++) {
 		u8 pixelAdjustInfo = 0;
@@ -1498,10 +1505,13 @@ void loadBootstrapScreenshot(FILE *file, const bool bufferOnly) {
 		return;
 
 	fseek(file, 0x40, SEEK_CUR);
-	u16 *buffer = new u16[256 * 192];
+	ScratchBuffer screenshot(256 * 192 * sizeof(u16));
+	if (!screenshot)
+		return;
+	u16 *buffer = screenshot.as<u16>();
 	fread(buffer, 2, 256 * 192, file);
 
-	u16 *bgSubBuffer = tex().beginBgSubModify();
+	u16 *bgSubBuffer = bufferOnly ? NULL : tex().beginBgSubModify();
 	u16* bgSubBuffer2 = tex().bgSubBuffer2();
 
 	if (!bufferOnly) {
@@ -1538,8 +1548,6 @@ void loadBootstrapScreenshot(FILE *file, const bool bufferOnly) {
 	if (!bufferOnly) {
 		tex().commitBgSubModify();
 	}
-
-	delete[] buffer;
 }
 
 static std::string loadedDate;
@@ -15,6 +15,14 @@ static u16 _paletteCache[NDS_ICON_BANK_COUNT][16];
 
 glImage _ndsIcon[NDS_ICON_BANK_COUNT][TWL_ICON_FRAMES];
 
+// ROM type icons stay in VRAM, each shared by every bank showing it
+static int _sharedTexID[SHARED_ICON_COUNT];
+static const u8 *_sharedTiles[SHARED_ICON_COUNT] = {NULL}; // What's in each, NULL if empty
+static u16 _sharedPalette[SHARED_ICON_COUNT][16];
+static u32 _sharedLastUse[SHARED_ICON_COUNT] = {0};
+static u32 _sharedUseCount = 0;
+static int _bankShared[NDS_ICON_BANK_COUNT]; // Shared icon shown by each bank, -1 for its own
+
 static u8 clearTiles[(32 * 256) / 2] = {0};
 static u16 blackPalette[16 * 8] = {0};
 
@@ -56,6 +64,7 @@ void glLoadTileSetIntoSlot(int num, int tile_wid, int tile_hei, int bmp_wid, int
 	glBindTexture(0, textureID);
 	glTexImage2D(0, 0, type, sizeX, sizeY, 0, param, _texture);
 	glColorTableEXT(0, 0, pallette_width, 0, 0, _palette);
+	_bankShared[num] = -1;
 
 	int i = 0;
 	int x, y;
@@ -164,6 +173,73 @@ void reloadIconPalettes() {
 	for (int i = 0; i < NDS_ICON_BANK_COUNT; i++) {
 		glReloadIconPalette(i);
 	}
+	for (int i = 0; i < SHARED_ICON_COUNT; i++) {
+		if (_sharedTiles[i]) {
+			glBindTexture(0, _sharedTexID[i]);
+			glColorTableEXT(0, 0, 16, 0, 0, _sharedPalette[i]);
+		}
+	}
+}
+
+/**
+ * Shows a ROM type icon in a bank, uploading it to VRAM only if it isn't
+ * there already. The least recently used icon not shown by any bank is
+ * replaced, and if they're all shown, the icon is loaded into the bank
+ * itself instead.
+ */
+void glLoadSharedIcon(int num, const u16 *palette, const u8 *tiles) {
+	if (BAD_ICON_IDX(num))
+		return;
+
+	int slot = -1;
+	for (int i = 0; i < SHARED_ICON_COUNT; i++) {
+		if (_sharedTiles[i] == tiles) {
+			slot = i;
+			break;
+		}
+	}
+
+	if (slot == -1) {
+		bool shown[SHARED_ICON_COUNT] = {false};
+		for (int i = 0; i < NDS_ICON_BANK_COUNT; i++) {
+			if (i != num && _bankShared[i] >= 0) {
+				shown[_bankShared[i]] = true;
+			}
+		}
+		for (int i = 0; i < SHARED_ICON_COUNT; i++) {
+			if (!shown[i] && (slot == -1 || _sharedLastUse[i] < _sharedLastUse[slot])) {
+				slot = i;
+			}
+		}
+
+		if (slot != -1) {
+			_sharedTiles[slot] = NULL;
+			glBindTexture(0, _sharedTexID[slot]);
+			if (glTexImage2D(0, 0, GL_RGB16, TEXTURE_SIZE_32, TEXTURE_SIZE_32, 0, TEXGEN_OFF | GL_TEXTURE_COLOR0_TRANSPARENT, tiles)) {
+				swiCopy(palette, _sharedPalette[slot], 4 * sizeof(u16) | COPY_MODE_COPY | COPY_MODE_WORD);
+				glColorTableEXT(0, 0, 16, 0, 0, _sharedPalette[slot]);
+				_sharedTiles[slot] = tiles;
+			} else {
+				slot = -1;
+			}
+		}
+	}
+
+	if (slot == -1) {
+		// No room in VRAM
+		glLoadIcon(num, palette, tiles);
+		return;
+	}
+
+	_sharedLastUse[slot] = ++_sharedUseCount;
+	_bankShared[num] = slot;
+	for (int i = 0; i < TWL_ICON_FRAMES; i++) {
+		_ndsIcon[num][i].width = 32;
+		_ndsIcon[num][i].height = 32;
+		_ndsIcon[num][i].u_off = 0;
+		_ndsIcon[num][i].v_off = 0;
+		_ndsIcon[num][i].textureID = _sharedTexID[slot];
+	}
 }
 /**
  * Loads an icon into one of 6 existing banks, overwritting
@@ -198,6 +274,7 @@ void iconManagerInit() {
 
 	// Allocate texture memory for 6 textures.
 	glGenTextures(NDS_ICON_BANK_COUNT, _iconTexID);
+	glGenTextures(SHARED_ICON_COUNT, _sharedTexID);
 
 	// Initialize empty data for the 6 textures.
 	for (int i = 0; i < NDS_ICON_BANK_COUNT; i++) {
@@ -5,6 +5,7 @@
 #define NDS_ICON_BANK_COUNT 7
 #define TWL_ICON_FRAMES 8
 #define TWL_TEX_HEIGHT 256
+#define SHARED_ICON_COUNT 8
 
 // Checks if the icon is a bad index
 #define BAD_ICON_IDX(i) (i < 0 || i > (NDS_ICON_BANK_COUNT - 1))
@@ -39,6 +40,14 @@ void iconManagerInit();
  */
 void glLoadIcon(int num, const u16 *palette, const u8 *tiles, int texHeight = 32);
 
+/**
+ * Shows a 32x32 ROM type icon in a bank. Up to SHARED_ICON_COUNT of them
+ * are kept in VRAM, least recently used first out, and shared between the
+ * banks, so only an icon which isn't there yet is uploaded.
+ * tiles identifies the icon, so must stay valid.
+ */
+void glLoadSharedIcon(int num, const u16 *palette, const u8 *tiles);
+
 /**
  * Loads an icon's palette into one of 6 existing banks,
  * overwritting the previous data.
@@ -32,6 +32,8 @@
 #include "graphics/iconHandler.h"
 #include "common/lodepng.h"
 #include "common/logging.h"
+#include "common/slot2Cache.h"
+#include "folderIndex.h"
 #include "graphics/paletteEffects.h"
 #include "graphics/queueControl.h"
 #include "graphics/ThemeConfig.h"
@@ -44,6 +46,7 @@
 #include <nds/arm9/dldi.h>
 #include <stdio.h>
 #include <sys/stat.h>
+#include <string>
 #include <vector>
 
 #define ICON_POS_X 112
@@ -120,30 +123,30 @@ void loadIcon(u8 *tilesSrc, u16 *palSrc, int num, bool twl) {
 	}
 }
 
-static inline void loadUnkIcon(int num) { glLoadIcon(num, tex().iconUnknownTexture()->palette(), tex().iconUnknownTexture()->bytes()); }
-static inline void loadGBAIcon(int num) { glLoadIcon(num, tex().iconGBATexture()->palette(), tex().iconGBATexture()->bytes()); }
-static inline void loadGBIcon(int num) { glLoadIcon(num, tex().iconGBTexture()->palette(), tex().iconGBTexture()->bytes()); }
-static inline void loadGBCIcon(int num) { glLoadIcon(num, tex().iconGBTexture()->palette(), tex().iconGBTexture()->bytes()+(32*16)); }
-static inline void loadNESIcon(int num) { glLoadIcon(num, tex().iconNESTexture()->palette(), tex().iconNESTexture()->bytes()); }
-static inline void loadSGIcon(int num) { glLoadIcon(num, tex().iconSGTexture()->palette(), tex().iconSGTexture()->bytes()); }
-static inline void loadSMSIcon(int num) { glLoadIcon(num, tex().iconSMSTexture()->palette(), tex().iconSMSTexture()->bytes()); }
-static inline void loadGGIcon(int num) { glLoadIcon(num, tex().iconGGTexture()->palette(), tex().iconGGTexture()->bytes()); }
-static inline void loadMDIcon(int num) { glLoadIcon(num, tex().iconMDTexture()->palette(), tex().iconMDTexture()->bytes()); }
-static inline void loadSNESIcon(int num) { glLoadIcon(num, tex().iconSNESTexture()->palette(), tex().iconSNESTexture()->bytes()); }
-static inline void loadPLGIcon(int num) { glLoadIcon(num, tex().iconPLGTexture()->palette(), tex().iconPLGTexture()->bytes()); }
-static inline void loadA26Icon(int num) { glLoadIcon(num, tex().iconA26Texture()->palette(), tex().iconA26Texture()->bytes()); }
-static inline void loadCOLIcon(int num) { glLoadIcon(num, tex().iconCOLTexture()->palette(), tex().iconCOLTexture()->bytes()); }
-static inline void loadM5Icon(int num) { glLoadIcon(num, tex().iconM5Texture()->palette(), tex().iconM5Texture()->bytes()); }
-static inline void loadINTIcon(int num) { glLoadIcon(num, tex().iconINTTexture()->palette(), tex().iconINTTexture()->bytes()); }
-static inline void loadPCEIcon(int num) { glLoadIcon(num, tex().iconPCETexture()->palette(), tex().iconPCETexture()->bytes()); }
-static inline void loadWSIcon(int num) { glLoadIcon(num, tex().iconWSTexture()->palette(), tex().iconWSTexture()->bytes()); }
-static inline void loadNGPIcon(int num) { glLoadIcon(num, tex().iconNGPTexture()->palette(), tex().iconNGPTexture()->bytes()); }
-static inline void loadCPCIcon(int num) { glLoadIcon(num, tex().iconCPCTexture()->palette(), tex().iconCPCTexture()->bytes()); }
-static inline void loadVIDIcon(int num) { glLoadIcon(num, tex().iconVIDTexture()->palette(), tex().iconVIDTexture()->bytes()); }
-static inline void loadIMGIcon(int num) { glLoadIcon(num, tex().iconIMGTexture()->palette(), tex().iconIMGTexture()->bytes()); }
-static inline void loadMSXIcon(int num) { glLoadIcon(num, tex().iconMSXTexture()->palette(), tex().iconMSXTexture()->bytes()); }
-static inline void loadMINIcon(int num) { glLoadIcon(num, tex().iconMINITexture()->palette(), tex().iconMINITexture()->bytes()); }
-static inline void loadHBIcon(int num) { glLoadIcon(num, tex().iconHBTexture()->palette(), tex().iconHBTexture()->bytes()); }
+static inline void loadUnkIcon(int num) { glLoadSharedIcon(num, tex().iconUnknownTexture()->palette(), tex().iconUnknownTexture()->bytes()); }
+static inline void loadGBAIcon(int num) { glLoadSharedIcon(num, tex().iconGBATexture()->palette(), tex().iconGBATexture()->bytes()); }
+static inline void loadGBIcon(int num) { glLoadSharedIcon(num, tex().iconGBTexture()->palette(), tex().iconGBTexture()->bytes()); }
+static inline void loadGBCIcon(int num) { glLoadSharedIcon(num, tex().iconGBTexture()->palette(), tex().iconGBTexture()->bytes()+(32*16)); }
+static inline void loadNESIcon(int num) { glLoadSharedIcon(num, tex().iconNESTexture()->palette(), tex().iconNESTexture()->bytes()); }
+static inline void loadSGIcon(int num) { glLoadSharedIcon(num, tex().iconSGTexture()->palette(), tex().iconSGTexture()->bytes()); }
+static inline void loadSMSIcon(int num) { glLoadSharedIcon(num, tex().iconSMSTexture()->palette(), tex().iconSMSTexture()->bytes()); }
+static inline void loadGGIcon(int num) { glLoadSharedIcon(num, tex().iconGGTexture()->palette(), tex().iconGGTexture()->bytes()); }
+static inline void loadMDIcon(int num) { glLoadSharedIcon(num, tex().iconMDTexture()->palette(), tex().iconMDTexture()->bytes()); }
+static inline void loadSNESIcon(int num) { glLoadSharedIcon(num, tex().iconSNESTexture()->palette(), tex().iconSNESTexture()->bytes()); }
+static inline void loadPLGIcon(int num) { glLoadSharedIcon(num, tex().iconPLGTexture()->palette(), tex().iconPLGTexture()->bytes()); }
+static inline void loadA26Icon(int num) { glLoadSharedIcon(num, tex().iconA26Texture()->palette(), tex().iconA26Texture()->bytes()); }
+static inline void loadCOLIcon(int num) { glLoadSharedIcon(num, tex().iconCOLTexture()->palette(), tex().iconCOLTexture()->bytes()); }
+static inline void loadM5Icon(int num) { glLoadSharedIcon(num, tex().iconM5Texture()->palette(), tex().iconM5Texture()->bytes()); }
+static inline void loadINTIcon(int num) { glLoadSharedIcon(num, tex().iconINTTexture()->palette(), tex().iconINTTexture()->bytes()); }
+static inline void loadPCEIcon(int num) { glLoadSharedIcon(num, tex().iconPCETexture()->palette(), tex().iconPCETexture()->bytes()); }
+static inline void loadWSIcon(int num) { glLoadSharedIcon(num, tex().iconWSTexture()->palette(), tex().iconWSTexture()->bytes()); }
+static inline void loadNGPIcon(int num) { glLoadSharedIcon(num, tex().iconNGPTexture()->palette(), tex().iconNGPTexture()->bytes()); }
+static inline void loadCPCIcon(int num) { glLoadSharedIcon(num, tex().iconCPCTexture()->palette(), tex().iconCPCTexture()->bytes()); }
+static inline void loadVIDIcon(int num) { glLoadSharedIcon(num, tex().iconVIDTexture()->palette(), tex().iconVIDTexture()->bytes()); }
+static inline void loadIMGIcon(int num) { glLoadSharedIcon(num, tex().iconIMGTexture()->palette(), tex().iconIMGTexture()->bytes()); }
+static inline void loadMSXIcon(int num) { glLoadSharedIcon(num, tex().iconMSXTexture()->palette(), tex().iconMSXTexture()->bytes()); }
+static inline void loadMINIcon(int num) { glLoadSharedIcon(num, tex().iconMINITexture()->palette(), tex().iconMINITexture()->bytes()); }
+static inline void loadHBIcon(int num) { glLoadSharedIcon(num, tex().iconHBTexture()->palette(), tex().iconHBTexture()->bytes()); }
 
 static inline void clearIcon(int num) { glClearIcon(num); }
 
@@ -216,7 +219,7 @@ void getGameInfo(bool isDir, const char *name, int num, bool fromArgv) {
 
 		// First try banner bin
 		snprintf(customIconPath, sizeof(customIconPath), "%s:/_nds/TWiLightMenu/icons/%s.bin", sys().isRunFromSD() ? "sd" : "fat", name);
-		if (access(customIconPath, F_OK) == 0) {
+		if (folderIndexExists(customIconPath)) {
 			customIcon[num] = 2; // custom icon is a banner bin
 			FILE *file = fopen(customIconPath, "rb");
 			if (file) {
@@ -258,7 +261,7 @@ void getGameInfo(bool isDir, const char *name, int num, bool fromArgv) {
 		} else if (customIcon[num] == 0) {
 			// If no banner bin, try png
 			snprintf(customIconPath, sizeof(customIconPath), "%s:/_nds/TWiLightMenu/icons/%s.png", sys().isRunFromSD() ? "sd" : "fat", name);
-			customIcon[num] = (access(customIconPath, F_OK) == 0);
+			customIcon[num] = (folderIndexExists(customIconPath));
 			if (customIcon[num]) {
 				std::vector<unsigned char> image;
 				uint imageWidth, imageHeight;
@@ -627,6 +630,159 @@ void getGameInfo(bool isDir, const char *name, int num, bool fromArgv) {
 	}
 }
 
+// What getGameInfo found for a directory entry, so revisiting a page
+// restores its slots from memory instead of reading every file again
+struct SlotRecord {
+	int entry = -1;
+	std::string name;
+	sNDSBannerExt *banner = NULL; // NULL if kept in Slot-2 RAM instead
+	bool bannerIsDSi = false;
+	int titleOffset = -1; // Of cachedTitle in the banner, -1 for none
+	bool infoFound;
+	int customIcon;
+	int romType;
+	int wirelessIcon;
+	char gameTid[5];
+	bool isDirectory, isValid, isTwlm, isUnlaunch, isDSiWare, isHomebrew, isModernHomebrew, requiresRamDisk, sysSettings;
+	int requiresDonorRom;
+	u8 romVersion;
+	u8 unitCode;
+	u16 headerCRC;
+	u32 a7mbk6;
+};
+
+#define SLOT_RECORDS 80 // The current page, and the last one visited
+
+static SlotRecord slotRecords[SLOT_RECORDS];
+
+// A DS without the debug RAM expansion keeps the banners in Slot-2 RAM, if there is any
+static inline bool bannersInSlot2(void) { return !dsiFeatures() && !sys().dsDebugRam(); }
+static inline int slotRecordCount(void) { return (!bannersInSlot2() || slot2CacheSize() > 0) ? SLOT_RECORDS : 0; }
+
+void clearSlotRecords(void) {
+	for (int i = 0; i < SLOT_RECORDS; i++) {
+		free(slotRecords[i].banner);
+		slotRecords[i].banner = NULL;
+		slotRecords[i].entry = -1;
+		slotRecords[i].name.clear();
+	}
+}
+
+void saveSlotRecord(int entry, std::string_view name, int num) {
+	// Replace an unused record, or the one furthest from this entry
+	if (slotRecordCount() == 0) {
+		return;
+	}
+	SlotRecord *record = &slotRecords[0];
+	for (int i = 0; i < slotRecordCount(); i++) {
+		if (slotRecords[i].entry == -1 || slotRecords[i].entry == entry) {
+			record = &slotRecords[i];
+			break;
+		}
+		if (abs(slotRecords[i].entry - entry) > abs(record->entry - entry)) {
+			record = &slotRecords[i];
+		}
+	}
+
+	const bool bannerIsDSi = bnriconisDSi[num];
+	const size_t bannerSize = bannerIsDSi ? NDS_BANNER_SIZE_DSi : NDS_BANNER_SIZE_ZH_KO;
+	if (bannersInSlot2()) {
+		if (!slot2CachePut(record - slotRecords, &bnriconTile[num], bannerSize)) {
+			record->entry = -1;
+			return;
+		}
+	} else {
+		if (!record->banner || record->bannerIsDSi != bannerIsDSi) {
+			free(record->banner);
+			record->banner = (sNDSBannerExt *)malloc(bannerSize);
+			if (!record->banner) {
+				record->entry = -1;
+				return;
+			}
+		}
+		tonccpy(record->banner, &bnriconTile[num], bannerSize);
+	}
+
+	record->entry = entry;
+	record->name = name;
+	record->bannerIsDSi = bannerIsDSi;
+	const char16_t *title = cachedTitle[num];
+	const char16_t *titles = (const char16_t *)bnriconTile[num].titles;
+	record->titleOffset = (infoFound[num] && title >= titles && title < titles + (sizeof(bnriconTile[num].titles) / sizeof(char16_t))) ? title - titles : -1;
+	record->infoFound = infoFound[num];
+	record->customIcon = customIcon[num];
+	record->romType = bnrRomType[num];
+	record->wirelessIcon = bnrWirelessIcon[num];
+	tonccpy(record->gameTid, gameTid[num], sizeof(record->gameTid));
+	record->isDirectory = isDirectory[num];
+	record->isValid = isValid[num];
+	record->isTwlm = isTwlm[num];
+	record->isUnlaunch = isUnlaunch[num];
+	record->isDSiWare = isDSiWare[num];
+	record->isHomebrew = isHomebrew[num];
+	record->isModernHomebrew = isModernHomebrew[num];
+	record->requiresRamDisk = requiresRamDisk[num];
+	record->sysSettings = bnrSysSettings[num];
+	record->requiresDonorRom = requiresDonorRom[num];
+	record->romVersion = romVersion[num];
+	record->unitCode = unitCode[num];
+	record->headerCRC = headerCRC[num];
+	record->a7mbk6 = a7mbk6[num];
+}
+
+bool restoreSlotRecord(int entry, std::string_view name, int num) {
+	const SlotRecord *record = NULL;
+	for (int i = 0; i < slotRecordCount(); i++) {
+		if (slotRecords[i].entry == entry && slotRecords[i].name == name) {
+			record = &slotRecords[i];
+			break;
+		}
+	}
+	if (!record) {
+		return false;
+	}
+
+	const size_t bannerSize = record->bannerIsDSi ? NDS_BANNER_SIZE_DSi : NDS_BANNER_SIZE_ZH_KO;
+	if (record->banner) {
+		tonccpy(&bnriconTile[num], record->banner, bannerSize);
+	} else if (!slot2CacheGet(record - slotRecords, &bnriconTile[num], bannerSize)) {
+		// Overwritten in Slot-2 RAM since
+		return false;
+	}
+	bnriconisDSi[num] = record->bannerIsDSi;
+	if (record->bannerIsDSi) {
+		grabBannerSequence(num);
+	} else {
+		clearBannerSequence(num);
+	}
+	bnriconPalLine[num] = 0;
+	bnriconPalLoaded[num] = 0;
+	bnriconframenumY[num] = 0;
+	bannerFlip[num] = GL_FLIP_NONE;
+
+	infoFound[num] = record->infoFound;
+	cachedTitle[num] = (record->titleOffset >= 0) ? (const char16_t *)bnriconTile[num].titles + record->titleOffset : blankTitle;
+	customIcon[num] = record->customIcon;
+	bnrRomType[num] = record->romType;
+	bnrWirelessIcon[num] = record->wirelessIcon;
+	tonccpy(gameTid[num], record->gameTid, sizeof(record->gameTid));
+	isDirectory[num] = record->isDirectory;
+	isValid[num] = record->isValid;
+	isTwlm[num] = record->isTwlm;
+	isUnlaunch[num] = record->isUnlaunch;
+	isDSiWare[num] = record->isDSiWare;
+	isHomebrew[num] = record->isHomebrew;
+	isModernHomebrew[num] = record->isModernHomebrew;
+	requiresRamDisk[num] = record->requiresRamDisk;
+	bnrSysSettings[num] = record->sysSettings;
+	requiresDonorRom[num] = record->requiresDonorRom;
+	romVersion[num] = record->romVersion;
+	unitCode[num] = record->unitCode;
+	headerCRC[num] = record->headerCRC;
+	a7mbk6[num] = record->a7mbk6;
+	return true;
+}
+
 void iconUpdate(bool isDir, const char *name, int num) {
 	logPrint("iconUpdate: ");
 
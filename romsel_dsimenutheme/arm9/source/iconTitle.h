@@ -24,6 +24,9 @@
 #include <string_view>
 
 void getGameInfo(bool isDir, const char* name, int num, bool fromArgv = false);
+void saveSlotRecord(int entry, std::string_view name, int num);
+bool restoreSlotRecord(int entry, std::string_view name, int num);
+void clearSlotRecords(void);
 void iconUpdate(bool isDir, const char* name, int num);
 void titleUpdate(bool isDir, std::string_view name, int num);
 void drawIcon(int Xpos, int Ypos, int num);
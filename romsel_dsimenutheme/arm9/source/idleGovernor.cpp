@@ -0,0 +1,99 @@
+#include "idleGovernor.h"
+
+#include "myDSiMode.h"
+
+#define IDLE_AFTER_FRAMES 180	// 3 seconds
+
+static IdleState state = IdleState::Active;
+static IdleStats stats = {0, 0, 0, 0};
+static int quietFrames = 0;
+static int workDepth = 0;
+
+static bool clockChecked = false;
+static bool canSetClock = false;
+static bool startedFast = false;
+static bool stopped = false;
+
+static void checkClock(void) {
+	if (clockChecked) {
+		return;
+	}
+	canSetClock = (isDSiMode() && REG_SCFG_EXT != 0);
+	startedFast = canSetClock && (REG_SCFG_CLK & BIT(0));
+	clockChecked = true;
+}
+
+static void setArm9Clock(bool fast) {
+	if (!canSetClock || stopped || fast == (bool)(REG_SCFG_CLK & BIT(0))) {
+		return;
+	}
+	if (fast) {
+		REG_SCFG_CLK |= BIT(0);
+	} else {
+		REG_SCFG_CLK &= ~BIT(0);
+	}
+	swiDelay(8);	// Let the new clock settle
+}
+
+void idleGovernorFrame(bool redrawn) {
+	checkClock();
+	stats.frames++;
+	if (state == IdleState::Work) {
+		stats.workFrames++;
+		return;
+	}
+
+	if (redrawn || (keysCurrent() & ~KEY_LID)) {
+		quietFrames = 0;
+		if (state == IdleState::Idle) {
+			state = IdleState::Active;
+			setArm9Clock(startedFast);
+			stats.wakeups++;
+		}
+		return;
+	}
+
+	if (state == IdleState::Idle) {
+		stats.idleFrames++;
+	} else if (++quietFrames >= IDLE_AFTER_FRAMES) {
+		state = IdleState::Idle;
+		setArm9Clock(false);
+	}
+}
+
+void idleGovernorBeginWork(void) {
+	const int oldIME = enterCriticalSection();
+	checkClock();
+	if (workDepth++ == 0) {
+		state = IdleState::Work;
+		setArm9Clock(true);
+	}
+	leaveCriticalSection(oldIME);
+}
+
+void idleGovernorEndWork(void) {
+	const int oldIME = enterCriticalSection();
+	if (workDepth > 0 && --workDepth == 0) {
+		state = IdleState::Active;
+		quietFrames = 0;
+		setArm9Clock(startedFast);
+	}
+	leaveCriticalSection(oldIME);
+}
+
+void idleGovernorStop(void) {
+	const int oldIME = enterCriticalSection();
+	checkClock();
+	setArm9Clock(startedFast);
+	stopped = true;
+	state = IdleState::Active;
+	leaveCriticalSection(oldIME);
+}
+
+IdleState idleGovernorState(void) {
+	return state;
+}
+
+const IdleStats& idleGovernorStats(void) {
+	return stats;
+}
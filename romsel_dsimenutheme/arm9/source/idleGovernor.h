@@ -0,0 +1,41 @@
+#ifndef IDLEGOVERNOR_H
+#define IDLEGOVERNOR_H
+
+#include <nds.h>
+
+enum class IdleState {
+	Active,	// Drawing or handling input, at the clock the menu started with
+	Idle,	// Nothing changed on screen for a while, ARM9 at 67 MHz (DSi only)
+	Work,	// Heavy work in progress, ARM9 at 134 MHz (DSi only)
+};
+
+struct IdleStats {
+	u32 frames;		// Frames counted since start
+	u32 idleFrames;	// Of those, frames spent idle
+	u32 workFrames;	// Of those, frames spent in heavy work
+	u32 wakeups;	// Times input or a redraw ended an idle period
+};
+
+/**
+ * Count one frame, from the vblank handler. Goes idle after a few seconds
+ * with no redraw and no input, and wakes up on the first frame that has
+ * either. The ARM9 clock is only changed in DSi mode with SCFG access.
+ */
+void idleGovernorFrame(bool redrawn);
+
+/**
+ * Run heavy work (image decoding, sorting) at 134 MHz. Calls may be nested.
+ */
+void idleGovernorBeginWork(void);
+void idleGovernorEndWork(void);
+
+/**
+ * Put the ARM9 back to the clock the menu started with and stop changing it,
+ * before launching something else.
+ */
+void idleGovernorStop(void);
+
+IdleState idleGovernorState(void);
+const IdleStats& idleGovernorStats(void);
+
+#endif // IDLEGOVERNOR_H
@@ -7,6 +7,7 @@
 
 #include <fat.h>
 #include "fat_ext.h"
+#include "folderIndex.h"
 #include <limits.h>
 #include <stdio.h>
 #include <sys/stat.h>
@@ -23,12 +24,19 @@
 
 #include "common/twlmenusettings.h"
 #include "common/bootstrapsettings.h"
+#include "common/blockRom.h"
+#include "common/discCache.h"
+#include "common/dsiWareStaging.h"
 #include "common/fatHeader.h"
 #include "common/flashcard.h"
 #include "common/nds_loader_arm9.h"
 #include "common/nds_bootstrap_loader.h"
+#include "common/pcProfiler.h"
+#include "common/scratchArena.h"
 #include "common/systemdetails.h"
+#include "common/warmSwitch.h"
 #include "common/my_rumble.h"
+#include "common/slot2Cache.h"
 #include "myDSiMode.h"
 #include "graphics/ThemeConfig.h"
 #include "graphics/ThemeTextures.h"
@@ -39,6 +47,7 @@
 #include "esrbSplash.h"
 #include "fileBrowse.h"
 #include "gbaswitch.h"
+#include "idleGovernor.h"
 #include "ndsheaderbanner.h"
 #include "perGameSettings.h"
 
@@ -291,6 +300,7 @@ void unlaunchRomBoot(std::string_view rom) {
 	}
 	*(u16*)(0x0200080E) = swiCRC16(0xFFFF, (void*)0x02000810, 0x3F0);		// Unlaunch CRC16
 
+	discCacheFlushAll();
 	DC_FlushAll();						// Make reboot not fail
 	fifoSendValue32(FIFO_USER_02, 1);	// Reboot into DSiWare title, booted via Unlaunch
 	stop();
@@ -323,6 +333,7 @@ void ntrStartSdGame(void) {
 		unlaunchRomBoot("sd:/_nds/TWiLightMenu/main.srldr");
 	} else {
 		tonccpy((u32 *)0x02000300, autoboot_bin, 0x20);
+		discCacheFlushAll();
 		DC_FlushAll();						// Make reboot not fail
 		fifoSendValue32(FIFO_USER_02, 1);
 		stop();
@@ -343,6 +354,7 @@ void dsCardLaunch() {
 
 	unlaunchSetHiyaBoot();
 
+	discCacheFlushAll();
 	DC_FlushAll();						// Make reboot not fail
 	fifoSendValue32(FIFO_USER_02, 1); // Reboot into DSiWare title, booted via Launcher
 	stop();
@@ -378,7 +390,7 @@ void SetWidescreen(const char *filename) {
 	char wideBinPath[256];
 	if (ms().launchType[ms().secondaryDevice] == Launch::ESDFlashcardLaunch) {
 		snprintf(wideBinPath, sizeof(wideBinPath), "sd:/_nds/TWiLightMenu/extras/widescreen/%s.bin", filename);
-		wideCheatFound = (access(wideBinPath, F_OK) == 0);
+		wideCheatFound = folderIndexExists(wideBinPath);
 	}
 
 	char s1GameTid[5];
@@ -397,10 +409,10 @@ void SetWidescreen(const char *filename) {
 		s1GameTid[4] = 0;
 
 		snprintf(wideBinPath, sizeof(wideBinPath), "sd:/_nds/TWiLightMenu/extras/widescreen/%s-%X.bin", s1GameTid, ndsCart.headerCRC16);
-		wideCheatFound = (access(wideBinPath, F_OK) == 0);
+		wideCheatFound = folderIndexExists(wideBinPath);
 	} else if (!wideCheatFound) {
 		snprintf(wideBinPath, sizeof(wideBinPath), "sd:/_nds/TWiLightMenu/extras/widescreen/%s-%X.bin", gameTid[CURPOS], headerCRC[CURPOS]);
-		wideCheatFound = (access(wideBinPath, F_OK) == 0);
+		wideCheatFound = folderIndexExists(wideBinPath);
 	}
 
 	if (isHomebrew[CURPOS]) {
@@ -522,15 +534,15 @@ void SetWidescreen(const char *filename) {
 std::string getGameManual(const char *filename) {
 	char manualPath[256];
 	snprintf(manualPath, sizeof(manualPath), "%s:/_nds/TWiLightMenu/extras/manuals/%s.txt", sys().isRunFromSD() ? "sd" : "fat", filename);
-	if (access(manualPath, F_OK) == 0)
+	if (folderIndexExists(manualPath))
 		return manualPath;
 
 	snprintf(manualPath, sizeof(manualPath), "%s:/_nds/TWiLightMenu/extras/manuals/%s.txt", sys().isRunFromSD() ? "sd" : "fat", gameTid[CURPOS]);
-	if (access(manualPath, F_OK) == 0)
+	if (folderIndexExists(manualPath))
 		return manualPath;
 
 	snprintf(manualPath, sizeof(manualPath), "%s:/_nds/TWiLightMenu/extras/manuals/%.3s.txt", sys().isRunFromSD() ? "sd" : "fat", gameTid[CURPOS]);
-	if (access(manualPath, F_OK) == 0)
+	if (folderIndexExists(manualPath))
 		return manualPath;
 
 	return "";
@@ -986,6 +998,10 @@ int dsiMenuTheme(void) {
 	ms().loadSettings();
 	bs().loadSettings();
 	logInit();
+	logPrint("Warm switch: %lu sector reads saved\n", (unsigned long)warmSwitchReadsSaved());
+#ifdef PC_PROFILER
+	pcProfilerStart(3, 1000);
+#endif
 	if (sdFound() && ms().consoleModel >= 2 && (!isDSiMode() || !sys().arm7SCFGLocked())) {
 		CIniFile lumaConfig("sd:/luma/config.ini");
 		widescreenFound = ((access("sd:/_nds/TWiLightMenu/TwlBg/Widescreen.cxi", F_OK) == 0) && (lumaConfig.GetInt("boot", "enable_external_firm_and_modules", 0) == true));
@@ -1003,6 +1019,7 @@ int dsiMenuTheme(void) {
 	logPrint("\n");
 
 	langInit();
+	queueDialogLayouts();
 
 	if (ms().theme == TWLSettings::EThemeSaturn || ms().theme == TWLSettings::EThemeHBL) {
 		whiteScreen = false;
@@ -1116,16 +1133,21 @@ int dsiMenuTheme(void) {
 			swiWaitForVBlank();
 		}
 		showProgressIcon = true;
+		DSiWareStagingStats stagingStats = {0, 0};
 		if (access(ms().dsiWarePubPath.c_str(), F_OK) == 0) {
-			fcopy("sd:/_nds/TWiLightMenu/tempDSiWare.pub", ms().dsiWarePubPath.c_str());
-			rename("sd:/_nds/TWiLightMenu/tempDSiWare.pub", "sd:/_nds/TWiLightMenu/tempDSiWare.pub.bak");
+			// Kept for a relaunch, or copied back again next time if this failed
+			if (dsiWareSyncFile("sd:/_nds/TWiLightMenu/tempDSiWare.pub", ms().dsiWarePubPath.c_str(), &stagingStats)) {
+				rename("sd:/_nds/TWiLightMenu/tempDSiWare.pub", "sd:/_nds/TWiLightMenu/tempDSiWare.pub.bak");
+			}
 		}
 		if (access(ms().dsiWarePrvPath.c_str(), F_OK) == 0) {
-			fcopy("sd:/_nds/TWiLightMenu/tempDSiWare.prv", ms().dsiWarePrvPath.c_str());
-			rename("sd:/_nds/TWiLightMenu/tempDSiWare.prv", "sd:/_nds/TWiLightMenu/tempDSiWare.prv.bak");
+			// Kept for a relaunch, or copied back again next time if this failed
+			if (dsiWareSyncFile("sd:/_nds/TWiLightMenu/tempDSiWare.prv", ms().dsiWarePrvPath.c_str(), &stagingStats)) {
+				rename("sd:/_nds/TWiLightMenu/tempDSiWare.prv", "sd:/_nds/TWiLightMenu/tempDSiWare.prv.bak");
+			}
 		}
 		showProgressIcon = false;
-		logPrint("Copied DSiWare save back to flashcard\n");
+		logPrint("Copied DSiWare save back to flashcard (%lu bytes written)\n", stagingStats.bytesWritten);
 		if (ms().theme != TWLSettings::EThemeSaturn) {
 			fadeType = false; // Fade to white
 			for (int i = 0; i < 25; i++) {
@@ -1245,17 +1267,30 @@ int dsiMenuTheme(void) {
 		// Launch the item
 
 		if (applaunch) {
-			// Delete previously launched DSiWare copied from flashcard to SD
-			if (access("sd:/_nds/TWiLightMenu/tempDSiWare.dsi", F_OK) == 0) {
-				remove("sd:/_nds/TWiLightMenu/tempDSiWare.dsi");
-			}
-			if (access("sd:/_nds/TWiLightMenu/tempDSiWare.pub.bak", F_OK) == 0) {
-				remove("sd:/_nds/TWiLightMenu/tempDSiWare.pub.bak");
-			}
-			if (access("sd:/_nds/TWiLightMenu/tempDSiWare.prv.bak", F_OK) == 0) {
-				remove("sd:/_nds/TWiLightMenu/tempDSiWare.prv.bak");
-			}
-			if (access("sd:/_nds/nds-bootstrap/patchOffsetCache/tempDSiWare.bin", F_OK) == 0) {
+			// Hand Slot-2 RAM back before a GBA ROM or launcher uses it
+			slot2CacheRelease();
+
+			const ThemeTextures::BgCopyStats &bgStats = tex().bgStats();
+			logPrint("BG copies: %lu from VRAM, %lu to VRAM, %lu flips, %lu commits merged\n",
+				(unsigned long)bgStats.vramReads, (unsigned long)bgStats.vramWrites, (unsigned long)bgStats.flips, (unsigned long)bgStats.commitsMerged);
+
+			// Launch at the clock the menu started with
+			idleGovernorStop();
+			const IdleStats &idleStats = idleGovernorStats();
+			logPrint("Frames: %lu, %lu idle, %lu in heavy work, %lu wakeups\n",
+				(unsigned long)idleStats.frames, (unsigned long)idleStats.idleFrames, (unsigned long)idleStats.workFrames, (unsigned long)idleStats.wakeups);
+			const ScratchArenaStats &scratchStats = scratchArenaStats();
+			logPrint("Scratch arena: %lu of %lu bytes at most, %lu checkouts, %lu from heap, %lu failed\n",
+				(unsigned long)scratchStats.highWater, (unsigned long)scratchStats.size, (unsigned long)scratchStats.checkouts, (unsigned long)scratchStats.heapFallbacks, (unsigned long)scratchStats.failed);
+#ifdef PC_PROFILER
+			pcProfilerStop();
+			pcProfilerDump(sys().isRunFromSD() ? "sd:/_nds/TWiLightMenu/profile/dsimenu.txt" : "fat:/_nds/TWiLightMenu/profile/dsimenu.txt");
+#endif
+
+			// Drop what was copied from flashcard to SD for the last DSiWare launch,
+			// unless the same DSiWare is being launched again
+			if (!dsiWareStagedFrom(filename.c_str(), "sd:/_nds/TWiLightMenu/tempDSiWare.dsi")) {
+				dsiWareUnstage("sd:/_nds/TWiLightMenu/tempDSiWare.dsi");
 				remove("sd:/_nds/nds-bootstrap/patchOffsetCache/tempDSiWare.bin");
 			}
 
@@ -1473,13 +1508,20 @@ int dsiMenuTheme(void) {
 						fadeType = true; // Fade in from white
 					}
 					showProgressIcon = true;
-					fcopy(ms().dsiWareSrlPath.c_str(), "sd:/_nds/TWiLightMenu/tempDSiWare.dsi");
+					DSiWareStagingStats stagingStats = {0, 0};
+					if (dsiWareStageSrl(ms().dsiWareSrlPath.c_str(), "sd:/_nds/TWiLightMenu/tempDSiWare.dsi", &stagingStats) == EStageCopied) {
+						// Cached patch offsets belong to the previously staged DSiWare
+						remove("sd:/_nds/nds-bootstrap/patchOffsetCache/tempDSiWare.bin");
+					}
 					if ((access(ms().dsiWarePubPath.c_str(), F_OK) == 0) && (NDSHeader.pubSavSize > 0)) {
-						fcopy(ms().dsiWarePubPath.c_str(), "sd:/_nds/TWiLightMenu/tempDSiWare.pub");
+						dsiWareRestoreSave("sd:/_nds/TWiLightMenu/tempDSiWare.pub");
+						dsiWareSyncFile(ms().dsiWarePubPath.c_str(), "sd:/_nds/TWiLightMenu/tempDSiWare.pub", &stagingStats);
 					}
 					if ((access(ms().dsiWarePrvPath.c_str(), F_OK) == 0) && (NDSHeader.prvSavSize > 0)) {
-						fcopy(ms().dsiWarePrvPath.c_str(), "sd:/_nds/TWiLightMenu/tempDSiWare.prv");
+						dsiWareRestoreSave("sd:/_nds/TWiLightMenu/tempDSiWare.prv");
+						dsiWareSyncFile(ms().dsiWarePrvPath.c_str(), "sd:/_nds/TWiLightMenu/tempDSiWare.prv", &stagingStats);
 					}
+					logPrint("Staged DSiWare on SD (%lu bytes read, %lu bytes written)\n", stagingStats.bytesRead, stagingStats.bytesWritten);
 					showProgressIcon = false;
 					if (ms().theme != TWLSettings::EThemeSaturn && ms().theme != TWLSettings::EThemeHBL) {
 						fadeType = false; // Fade to white
@@ -2018,6 +2060,7 @@ int dsiMenuTheme(void) {
 				bool boostCpu = true;
 				bool boostVram = false;
 				bool tscTgds = false;
+				bool romUnreadable = false; // Block ROM which can't be read, or isn't going to the native GBA path
 				int romToRamDisk = -1;
 
 				std::string romfolderNoSlash = ms().romfolder[ms().secondaryDevice];
@@ -2105,8 +2148,10 @@ int dsiMenuTheme(void) {
 						progressBarLength = 0;
 
 						u32 ptr = 0x08000000;
-						u32 romSize = getFileSize(filename.c_str());
 						FILE* gbaFile = fopen(filename.c_str(), "rb");
+						BlockRom gbaRom;
+						romUnreadable = !blockRomOpen(&gbaRom, gbaFile); // Block ROMs are read as if uncompressed
+						u32 romSize = gbaRom.romSize;
 						if (strncmp(gameTid[CURPOS], "AGBJ", 4) == 0 && romSize <= 0x40000) {
 							ptr += 0x400;
 						}
@@ -2135,7 +2180,7 @@ int dsiMenuTheme(void) {
 						updateText(false);
 
 						for (u32 len = romSize; len > 0; len -= 0x8000) {
-							if (fread(&copyBuf, 1, (len>0x8000 ? 0x8000 : len), gbaFile) > 0) {
+							if (blockRomRead(&gbaRom, &copyBuf, (len>0x8000 ? 0x8000 : len)) > 0) {
 								s2RamAccess(true);
 								if (nor) {
 									expansion().WriteNorFlash(curPtr-ptr, (u8*)copyBuf, (len>0x8000 ? 0x8000 : len));
@@ -2149,7 +2194,8 @@ int dsiMenuTheme(void) {
 								break;
 							}
 						}
-						fclose(gbaFile);
+						blockRomClose(&gbaRom);
+						if (gbaFile) fclose(gbaFile);
 
 						ptr = 0x0A000000;
 
@@ -2157,7 +2203,7 @@ int dsiMenuTheme(void) {
 						u32 savesize = getFileSize(savename.c_str());
 						if (savesize > 0x10000) savesize = 0x10000;
 
-						if (savesize > 0) {
+						if (savesize > 0 && !romUnreadable) {
 							FILE* savFile = fopen(savename.c_str(), "rb");
 							for (u32 len = savesize; len > 0; len -= 0x8000) {
 								if (fread(&copyBuf, 1, (len>0x8000 ? 0x8000 : len), savFile) > 0) {
@@ -2496,8 +2542,14 @@ int dsiMenuTheme(void) {
 				argarray.at(0) = (char *)(tgdsMode ? tgdsNdsPath : ndsToBoot);
 				snd().stopStream();
 
+				// GBARunner2 and the emulators open the ROM themselves, and can't read block ROMs
+				if (ms().launchType[ms().secondaryDevice] != Launch::EGBANativeLaunch && blockRomIsPacked(ROMpath)) {
+					romUnreadable = true;
+				}
 				int err = 0;
-				if (ms().btsrpBootloaderDirect && useNDSB) {
+				if (romUnreadable) {
+					err = BLOCK_ROM_START_ERROR;
+				} else if (ms().btsrpBootloaderDirect && useNDSB) {
 					if (access(ms().bootstrapFile ? "sd:/_nds/nds-bootstrap-hb-nightly.nds" : "sd:/_nds/nds-bootstrap-hb-release.nds", F_OK) == 0) {
 						bool romIsCompressed = false;
 						if (romToRamDisk == 0) {
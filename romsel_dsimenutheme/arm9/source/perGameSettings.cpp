@@ -41,6 +41,7 @@
 #include "twlClockExcludeMap.h"
 #include "dmaExcludeMap.h"
 #include "asyncReadExcludeMap.h"
+#include "folderIndex.h"
 
 #define SCREEN_COLS 32
 #define ENTRIES_PER_SCREEN 15
@@ -120,7 +121,10 @@ bool extension(const std::string_view filename, const std::vector<std::string_vi
 
 void loadPerGameSettings (std::string filename) {
 	snprintf(pergamefilepath, sizeof(pergamefilepath), "%s/_nds/TWiLightMenu/gamesettings/%s.ini", (ms().secondaryDevice ? "fat:" : "sd:"), filename.c_str());
-	CIniFile pergameini( pergamefilepath );
+	CIniFile pergameini;
+	if (folderIndexExists(pergamefilepath)) {
+		pergameini.LoadIniFile(pergamefilepath);
+	}
 	perGameSettings_directBoot = pergameini.GetInt("GAMESETTINGS", "DIRECT_BOOT", (isModernHomebrew[CURPOS] || ms().secondaryDevice));	// Homebrew only
 	if (isHomebrew[CURPOS]) {
 		perGameSettings_dsiMode = pergameini.GetInt("GAMESETTINGS", "DSI_MODE", (isModernHomebrew[CURPOS] ? true : false));
@@ -242,6 +246,7 @@ void savePerGameSettings (std::string filename) {
 		pergameini.SetInt("GAMESETTINGS", "SAVE_RELOCATION", perGameSettings_saveRelocation);
 	}
 	pergameini.SaveIniFile( pergamefilepath );
+	folderIndexNoteAdded(pergamefilepath);
 }
 
 bool checkIfShowAPMsg (std::string filename) {
@@ -255,6 +260,7 @@ void dontShowAPMsgAgain (std::string filename) {
 	CIniFile pergameini( pergamefilepath );
 	pergameini.SetInt("GAMESETTINGS", "NO_SHOW_AP_MSG", 1);
 	pergameini.SaveIniFile( pergamefilepath );
+	folderIndexNoteAdded(pergamefilepath);
 }
 
 bool checkIfShowRAMLimitMsg (std::string filename) {
@@ -268,6 +274,7 @@ void dontShowRAMLimitMsgAgain (std::string filename) {
 	CIniFile pergameini( pergamefilepath );
 	pergameini.SetInt("GAMESETTINGS", "NO_SHOW_RAM_LIMIT_MSG", 1);
 	pergameini.SaveIniFile( pergamefilepath );
+	folderIndexNoteAdded(pergamefilepath);
 }
 
 bool checkIfDSiMode (std::string filename) {
@@ -32,6 +32,7 @@
 #include <maxmod7.h>
 #include "common/isPhatCheck.h"
 #include "common/arm7status.h"
+#include "common/discCache.h"
 
 void my_touchInit();
 void my_installSystemFIFO(void);
@@ -239,5 +240,7 @@ int main() {
 		}
 		swiWaitForVBlank();
 	}
+
+	discCacheRequestFlush();
 	return 0;
 }
\ No newline at end of file
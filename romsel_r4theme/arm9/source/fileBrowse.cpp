@@ -38,9 +38,12 @@
 #include "date.h"
 
 #include "ndsheaderbanner.h"
+#include "folderIndex.h"
 #include "common/twlmenusettings.h"
 #include "common/bootstrapsettings.h"
+#include "common/discCache.h"
 #include "common/flashcard.h"
+#include "common/gameOrder.h"
 #include "common/systemdetails.h"
 #include "common/tonccpy.h"
 #include "iconTitle.h"
@@ -90,6 +93,16 @@ std::string gameOrderIniPath, recentlyPlayedIniPath, timesPlayedIniPath;
 
 static int fileStartPos = 0; // The position of the first thing that is not a directory.
 
+// What showDirectoryContents last drew, so cursor moves and scrolling by a row only redraw the rows that changed
+static struct {
+	const std::vector<DirEntry>* contents = nullptr;
+	size_t size = 0;
+	int startRow = 0;
+	int fileOffset = 0;
+	bool onStartMenu = false;
+	u32 clearCount = 0;
+} drawnList;
+
 char path[PATH_MAX] = {0};
 
 static void gbnpBottomInfo(void) {
@@ -168,6 +181,8 @@ bool dirEntryPredicate(const DirEntry &lhs, const DirEntry &rhs) {
 }
 
 void getDirectoryContents(std::vector<DirEntry> &dirContents, const std::vector<std::string_view> extensionList = {}) {
+	drawnList.contents = nullptr;
+
 	dirContents.clear();
 	resetPreloadedBannerIcons();
 
@@ -317,18 +332,14 @@ void getDirectoryContents(std::vector<DirEntry> &dirContents, const std::vector<
 				});
 			logPrint("File type");
 		} else if (ms().sortMethod == TWLSettings::ESortCustom) { // Custom
-			CIniFile gameOrderIni(gameOrderIniPath);
-			std::vector<std::string> gameOrder;
 			getcwd(path, PATH_MAX);
-			gameOrderIni.GetStringVector("ORDER", path, gameOrder, ':');
+			gameOrderLoad(path);
 
-			for (uint i = 0; i < gameOrder.size(); i++) {
-				for (DirEntry &dirEntry : dirContents) {
-					if (gameOrder[i] == dirEntry.name) {
-						dirEntry.position = i;
-						dirEntry.customPos = true;
-						break;
-					}
+			for (DirEntry &dirEntry : dirContents) {
+				u32 rank;
+				if (gameOrderRank(dirEntry.name, &rank)) {
+					dirEntry.position = rank;
+					dirEntry.customPos = true;
 				}
 			}
 			sort(dirContents.begin(), dirContents.end(), dirEntryPredicate);
@@ -342,28 +353,95 @@ void getDirectoryContents(std::vector<DirEntry> &dirContents, const std::vector<
 	}
 }
 
+static void printDirectoryRow (const std::vector<DirEntry>& dirContents, const int row, const int startRow, const int fileOffset) {
+	const int xPos = (ms().theme == TWLSettings::EThemeGBC) ? 64 : 1;
+	const int yPos = (ms().theme == TWLSettings::EThemeGBC) ? 47 : 12;
+	const DirEntry* entry = &dirContents.at(row);
+
+	printSmall(true, xPos, yPos+((row - startRow)*12), entry->isDirectory ? ("["+entry->name+"]") : entry->name, Alignment::left, (row == fileOffset) ? FontPalette::user : FontPalette::white);
+}
+
 void showDirectoryContents (const std::vector<DirEntry>& dirContents, const int startRow, const int fileOffset) {
 	getcwd(path, PATH_MAX);
 
+	const int yPos = (ms().theme == TWLSettings::EThemeGBC) ? 47 : 12;
+	const int entriesPerScreen = (ms().theme==TWLSettings::EThemeGBC ? ENTRIES_PER_SCREEN_GBNP : ENTRIES_PER_SCREEN);
+	const int rows = std::min((int)dirContents.size() - startRow, entriesPerScreen);
+	const int scroll = startRow - drawnList.startRow;
+
+	if (drawnList.contents == &dirContents && drawnList.size == dirContents.size() && drawnList.onStartMenu == startMenu
+	 && drawnList.clearCount == textClearCount(true)
+	 && std::abs(scroll) < rows && rows == std::min((int)dirContents.size() - drawnList.startRow, entriesPerScreen)) {
+		if (ms().theme == TWLSettings::EThemeGBC) {
+			// The banner text gets printed again after this
+			clearTextRows(true, 0, yPos);
+			clearTextRows(true, yPos+(rows*12), 192);
+		}
+
+		// Unhighlight the old row while it's still where it was drawn
+		const int oldRow = drawnList.fileOffset - drawnList.startRow;
+		if (oldRow >= 0 && oldRow < rows) {
+			recolorTextRows(true, yPos+(oldRow*12), 12, FontPalette::user, FontPalette::white);
+		}
+
+		int updateY = yPos, updateHeight = rows*12;
+		if (scroll == 0) {
+			// Only the old and new highlighted rows changed
+			const int newRow = fileOffset - startRow;
+			if (newRow >= 0 && newRow < rows) {
+				recolorTextRows(true, yPos+(newRow*12), 12, FontPalette::white, FontPalette::user);
+			}
+			if (oldRow >= 0 && oldRow < rows && newRow >= 0 && newRow < rows) {
+				updateY = yPos+(std::min(oldRow, newRow)*12);
+				updateHeight = (std::abs(newRow - oldRow) + 1)*12;
+				if (updateHeight > 24) {
+					// Two separate rows, don't copy the ones between them
+					updateTextRows(true, yPos+(oldRow*12), 12);
+					updateY = yPos+(newRow*12);
+					updateHeight = 12;
+				}
+			}
+		} else {
+			// Move the rows still on screen, and only draw the ones scrolled in
+			scrollTextRows(true, yPos, rows*12, -scroll*12);
+			const int firstNew = (scroll > 0) ? rows - scroll : 0;
+			clearTextRows(true, yPos+(firstNew*12), std::abs(scroll)*12);
+			for (int i = firstNew; i < firstNew + std::abs(scroll); i++) {
+				printDirectoryRow(dirContents, i + startRow, startRow, fileOffset);
+			}
+			const int newRow = fileOffset - startRow;
+			if (newRow >= 0 && newRow < rows && (newRow < firstNew || newRow >= firstNew + std::abs(scroll))) {
+				recolorTextRows(true, yPos+(newRow*12), 12, FontPalette::white, FontPalette::user);
+			}
+		}
+
+		updateTextRows(true, updateY, updateHeight);
+		drawnList.startRow = startRow;
+		drawnList.fileOffset = fileOffset;
+		return;
+	}
+
 	// Clear the screen
 	clearText(true);
 
-	const int xPos = (ms().theme == TWLSettings::EThemeGBC) ? 64 : 1;
-	const int yPos = (ms().theme == TWLSettings::EThemeGBC) ? 47 : 12;
-
 	// Print the path
 	if (ms().theme != TWLSettings::EThemeGBC) {
-		printSmall(true, xPos, 0, path, Alignment::left, FontPalette::black);
+		printSmall(true, 1, 0, path, Alignment::left, FontPalette::black);
 	}
 
 	// Print directory listing
-	for (int i = 0; i < ((int)dirContents.size() - startRow) && i < (ms().theme==TWLSettings::EThemeGBC ? ENTRIES_PER_SCREEN_GBNP : ENTRIES_PER_SCREEN); i++) {
-		const DirEntry* entry = &dirContents.at(i + startRow);
-		
-		printSmall(true, xPos, yPos+(i*12), entry->isDirectory ? ("["+entry->name+"]") : entry->name, Alignment::left, ((i + startRow) == fileOffset) ? FontPalette::user : FontPalette::white);
+	for (int i = 0; i < rows; i++) {
+		printDirectoryRow(dirContents, i + startRow, startRow, fileOffset);
 	}
 
 	updateText(true);
+
+	drawnList.contents = &dirContents;
+	drawnList.size = dirContents.size();
+	drawnList.startRow = startRow;
+	drawnList.fileOffset = fileOffset;
+	drawnList.onStartMenu = startMenu;
+	drawnList.clearCount = textClearCount(true);
 }
 
 void mdRomTooBig(void) {
@@ -1077,6 +1155,7 @@ std::string browseForFile(const std::vector<std::string_view> extensionList) {
 	}
 
 	gameOrderIniPath = std::string(sys().isRunFromSD() ? "sd" : "fat") + ":/_nds/TWiLightMenu/extras/gameorder.ini";
+	gameOrderInit(gameOrderIniPath);
 	recentlyPlayedIniPath = std::string(sys().isRunFromSD() ? "sd" : "fat") + ":/_nds/TWiLightMenu/extras/recentlyplayed.ini";
 	timesPlayedIniPath = std::string(sys().isRunFromSD() ? "sd" : "fat") + ":/_nds/TWiLightMenu/extras/timesplayed.ini";
 
@@ -1605,12 +1684,16 @@ std::string browseForFile(const std::vector<std::string_view> extensionList) {
 
 					if (pressed & KEY_A && !isDirectory) {
 						remove(dirContents.at(fileOffset).name.c_str());
+						folderIndexNoteRemoved(dirContents.at(fileOffset).name.c_str());
 					} else if (pressed & KEY_Y) {
 						// Remove leading . if it exists
 						if ((strncmp(entry->name.c_str(), ".", 1) == 0 && entry->name != "..")) {
 							rename(entry->name.c_str(), entry->name.substr(1).c_str());
+							folderIndexNoteRemoved(entry->name.c_str());
+							folderIndexNoteAdded(entry->name.substr(1).c_str());
 						} else { // Otherwise toggle the hidden attribute bit
 							FAT_setAttr(entry->name.c_str(), FAT_getAttr(entry->name.c_str()) ^ ATTR_HIDDEN);
+							discCacheFlushAll();
 						}
 					}
 					
@@ -1,6 +1,7 @@
 #include "fontHandler.h"
 
 #include <nds/arm9/dldi.h>
+#include <algorithm>
 #include <list>
 
 #include "common/twlmenusettings.h"
@@ -89,14 +90,9 @@ FontGraphic *getFont(bool large) {
 	return large ? largeFont : smallFont;
 }
 
-void updateText(bool top) {
-	// Clear before redrawing
-	if (shouldClear[top]) {
-		dmaFillWords(0, FontGraphic::textBuf[top], 256 * 192);
-		shouldClear[top] = false;
-	}
+static u32 clearCount[] = {0, 0};
 
-	// Draw text
+static void drawTextQueue(bool top) {
 	auto &text = getTextQueue(top);
 	for (auto it = text.begin(); it != text.end(); ++it) {
 		FontGraphic *font = getFont(it->large);
@@ -104,24 +100,40 @@ void updateText(bool top) {
 			font->print(it->x, it->y, top, it->message, it->align, it->palette);
 	}
 	text.clear();
+}
+
+// Copy rows yStart to yEnd of the buffer to the top screen
+static void copyTopRows(int yStart, int yEnd) {
+	int xStart = 0, xEnd = 256;
+	if (ms().theme == TWLSettings::EThemeGBC) {
+		// Avoid writing to GBC border
+		xStart = 48;
+		xEnd = 256-48;
+		yStart = std::max(yStart, 24);
+		yEnd = std::min(yEnd, 192-24);
+	}
+	for (int y = yStart; y < yEnd; y++) {
+		for (int x = xStart; x < xEnd; x++) {
+			const int i = (y*256)+x;
+			topImageWithText[startMenu][0][i] = (FontGraphic::textBuf[1][i]) ? (BG_PALETTE_SUB[FontGraphic::textBuf[1][i]] | BIT(15)) : topImage[startMenu][0][i];
+			topImageWithText[startMenu][1][i] = (FontGraphic::textBuf[1][i]) ? (BG_PALETTE_SUB[FontGraphic::textBuf[1][i]] | BIT(15)) : topImage[startMenu][1][i];
+		}
+	}
+}
+
+void updateText(bool top) {
+	// Clear before redrawing
+	if (shouldClear[top]) {
+		dmaFillWords(0, FontGraphic::textBuf[top], 256 * 192);
+		shouldClear[top] = false;
+	}
+
+	// Draw text
+	drawTextQueue(top);
 
 	if (top) {
 		// Copy buffer to the top screen
-		if (ms().theme == TWLSettings::EThemeGBC) {
-			// Avoid writing to GBC border
-			for (int y = 24; y < 192-24; y++) {
-				for (int x = 48; x < 256-48; x++) {
-					const int i = (y*256)+x;
-					topImageWithText[startMenu][0][i] = (FontGraphic::textBuf[1][i]) ? (BG_PALETTE_SUB[FontGraphic::textBuf[1][i]] | BIT(15)) : topImage[startMenu][0][i];
-					topImageWithText[startMenu][1][i] = (FontGraphic::textBuf[1][i]) ? (BG_PALETTE_SUB[FontGraphic::textBuf[1][i]] | BIT(15)) : topImage[startMenu][1][i];
-				}
-			}
-		} else {
-			for (int i = 0; i < 256*192; i++) {
-				topImageWithText[startMenu][0][i] = (FontGraphic::textBuf[1][i]) ? (BG_PALETTE_SUB[FontGraphic::textBuf[1][i]] | BIT(15)) : topImage[startMenu][0][i];
-				topImageWithText[startMenu][1][i] = (FontGraphic::textBuf[1][i]) ? (BG_PALETTE_SUB[FontGraphic::textBuf[1][i]] | BIT(15)) : topImage[startMenu][1][i];
-			}
-		}
+		copyTopRows(0, 192);
 		return;
 	}
 
@@ -164,6 +176,7 @@ void updateTextImg(u16* img, bool top) {
 
 void clearText(bool top) {
 	shouldClear[top] = true;
+	clearCount[top]++;
 }
 
 void clearText() {
@@ -171,6 +184,55 @@ void clearText() {
 	clearText(false);
 }
 
+u32 textClearCount(bool top) {
+	return clearCount[top];
+}
+
+void clearTextRows(bool top, int y, int height) {
+	y = std::clamp(y, 0, 192);
+	height = std::clamp(height, 0, 192 - y);
+	toncset(FontGraphic::textBuf[top] + (y * 256), 0, height * 256);
+}
+
+void scrollTextRows(bool top, int y, int height, int dy) {
+	// Rows moved in from outside the area are left as they were
+	if (dy == 0 || std::abs(dy) >= height)
+		return;
+	u8 *area = FontGraphic::textBuf[top] + (y * 256);
+	if (dy > 0) {
+		memmove(area + (dy * 256), area, (height - dy) * 256);
+	} else {
+		memmove(area, area - (dy * 256), (height + dy) * 256);
+	}
+}
+
+void recolorTextRows(bool top, int y, int height, FontPalette from, FontPalette to) {
+	// Glyphs are drawn as 4 * palette + (1 to 3), so this needs no redraw
+	const u8 fromBase = 4 * (u8)from;
+	const s8 diff = 4 * ((s8)to - (s8)from);
+	u8 *px = FontGraphic::textBuf[top] + (y * 256);
+	for (int i = 0; i < height * 256; i++) {
+		if (px[i] > fromBase && px[i] < fromBase + 4)
+			px[i] += diff;
+	}
+}
+
+void updateTextRows(bool top, int y, int height) {
+	if (shouldClear[top]) {
+		updateText(top);
+		return;
+	}
+
+	drawTextQueue(top);
+
+	if (top) {
+		copyTopRows(y, y + height);
+		return;
+	}
+
+	tonccpy((u8*)bgGetGfxPtr(2) + (y * 256), FontGraphic::textBuf[0] + (y * 256), height * 256);
+}
+
 void printSmall(bool top, int x, int y, std::string_view message, Alignment align, FontPalette palette) {
 	getTextQueue(top).emplace_back(false, x, y, message, align, palette);
 }
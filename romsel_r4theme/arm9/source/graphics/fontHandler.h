@@ -11,6 +11,13 @@ void updateTextImg(u16* img, bool top);
 void clearText(bool top);
 void clearText();
 
+// Partial updates, for redrawing a few rows of text without touching the rest
+u32 textClearCount(bool top);
+void clearTextRows(bool top, int y, int height);
+void scrollTextRows(bool top, int y, int height, int dy);
+void recolorTextRows(bool top, int y, int height, FontPalette from, FontPalette to);
+void updateTextRows(bool top, int y, int height);
+
 void printSmall(bool top, int x, int y, std::string_view message, Alignment align = Alignment::left, FontPalette palette = FontPalette::black);
 void printSmall(bool top, int x, int y, std::u16string_view message, Alignment align = Alignment::left, FontPalette palette = FontPalette::black);
 void printLarge(bool top, int x, int y, std::string_view message, Alignment align = Alignment::left, FontPalette palette = FontPalette::black);
@@ -35,6 +35,7 @@
 #include "graphics/fontHandler.h"
 #include "common/lodepng.h"
 #include "common/logging.h"
+#include "folderIndex.h"
 #include "language.h"
 #include "ndsheaderbanner.h"
 #include "myDSiMode.h"
@@ -933,7 +934,7 @@ void getGameInfo(int fileOffset, bool isDir, const char* name, bool fromArgv)
 
 		// First try banner bin
 		snprintf(customIconPath, sizeof(customIconPath), "%s:/_nds/TWiLightMenu/icons/%s.bin", sys().isRunFromSD() ? "sd" : "fat", name);
-		if (access(customIconPath, F_OK) == 0) {
+		if (folderIndexExists(customIconPath)) {
 			customIcon = 2; // custom icon is a banner bin
 			FILE *file = fopen(customIconPath, "rb");
 			if (file) {
@@ -960,7 +961,7 @@ void getGameInfo(int fileOffset, bool isDir, const char* name, bool fromArgv)
 		} else {
 			// If no banner bin, try png
 			snprintf(customIconPath, sizeof(customIconPath), "%s:/_nds/TWiLightMenu/icons/%s.png", sys().isRunFromSD() ? "sd" : "fat", name);
-			customIcon = (access(customIconPath, F_OK) == 0);
+			customIcon = (folderIndexExists(customIconPath));
 			if (customIcon) {
 				std::vector<unsigned char> image;
 				uint imageWidth, imageHeight;
@@ -8,6 +8,7 @@
 #include <stdio.h>
 #include <fat.h>
 #include "fat_ext.h"
+#include "folderIndex.h"
 #include <sys/stat.h>
 #include <limits.h>
 
@@ -22,6 +23,9 @@
 #include "graphics/graphics.h"
 
 #include "myDSiMode.h"
+#include "common/blockRom.h"
+#include "common/discCache.h"
+#include "common/dsiWareStaging.h"
 #include "common/tonccpy.h"
 #include "common/fatHeader.h"
 #include "common/flashcard.h"
@@ -42,6 +46,7 @@
 #include "common/stringtool.h"
 #include "common/systemdetails.h"
 #include "common/twlmenusettings.h"
+#include "common/warmSwitch.h"
 
 #include "sound.h"
 #include "language.h"
@@ -354,6 +359,7 @@ void unlaunchRomBoot(std::string_view rom) {
 	}
 	*(u16*)(0x0200080E) = swiCRC16(0xFFFF, (void*)0x02000810, 0x3F0);		// Unlaunch CRC16
 
+	discCacheFlushAll();
 	DC_FlushAll();						// Make reboot not fail
 	fifoSendValue32(FIFO_USER_02, 1);	// Reboot into DSiWare title, booted via Unlaunch
 	stop();
@@ -386,6 +392,7 @@ void ntrStartSdGame(void) {
 		unlaunchRomBoot("sd:/_nds/TWiLightMenu/main.srldr");
 	} else {
 		tonccpy((u32 *)0x02000300, autoboot_bin, 0x20);
+		discCacheFlushAll();
 		DC_FlushAll();						// Make reboot not fail
 		fifoSendValue32(FIFO_USER_02, 1);
 		stop();
@@ -405,6 +412,7 @@ void dsCardLaunch() {
 
 	unlaunchSetHiyaBoot();
 
+	discCacheFlushAll();
 	DC_FlushAll();						// Make reboot not fail
 	fifoSendValue32(FIFO_USER_02, 1);	// Reboot into DSiWare title, booted via Launcher
 	stop();
@@ -440,7 +448,7 @@ void SetWidescreen(const char *filename) {
 	char wideBinPath[256];
 	if (ms().launchType[ms().secondaryDevice] == TWLSettings::ESDFlashcardLaunch) {
 		snprintf(wideBinPath, sizeof(wideBinPath), "sd:/_nds/TWiLightMenu/extras/widescreen/%s.bin", filename);
-		wideCheatFound = (access(wideBinPath, F_OK) == 0);
+		wideCheatFound = folderIndexExists(wideBinPath);
 	}
 
 	char s1GameTid[5];
@@ -461,7 +469,7 @@ void SetWidescreen(const char *filename) {
 		headerCRC16 = ndsCart.headerCRC16;
 
 		snprintf(wideBinPath, sizeof(wideBinPath), "sd:/_nds/TWiLightMenu/extras/widescreen/%s-%X.bin", s1GameTid, ndsCart.headerCRC16);
-		wideCheatFound = (access(wideBinPath, F_OK) == 0);
+		wideCheatFound = folderIndexExists(wideBinPath);
 	} else if (!wideCheatFound) {
 		FILE *f_nds_file = fopen(filename, "rb");
 		fseek(f_nds_file, offsetof(sNDSHeaderExt, headerCRC16), SEEK_SET);
@@ -469,7 +477,7 @@ void SetWidescreen(const char *filename) {
 		fclose(f_nds_file);
 
 		snprintf(wideBinPath, sizeof(wideBinPath), "sd:/_nds/TWiLightMenu/extras/widescreen/%s-%X.bin", gameTid, headerCRC16);
-		wideCheatFound = (access(wideBinPath, F_OK) == 0);
+		wideCheatFound = folderIndexExists(wideBinPath);
 	}
 
 	if (isHomebrew) {
@@ -594,15 +602,15 @@ void SetWidescreen(const char *filename) {
 std::string getGameManual(const char *filename) {
 	char manualPath[256];
 	snprintf(manualPath, sizeof(manualPath), "%s:/_nds/TWiLightMenu/extras/manuals/%s.txt", sys().isRunFromSD() ? "sd" : "fat", filename);
-	if (access(manualPath, F_OK) == 0)
+	if (folderIndexExists(manualPath))
 		return manualPath;
 
 	snprintf(manualPath, sizeof(manualPath), "%s:/_nds/TWiLightMenu/extras/manuals/%s.txt", sys().isRunFromSD() ? "sd" : "fat", gameTid);
-	if (access(manualPath, F_OK) == 0)
+	if (folderIndexExists(manualPath))
 		return manualPath;
 
 	snprintf(manualPath, sizeof(manualPath), "%s:/_nds/TWiLightMenu/extras/manuals/%.3s.txt", sys().isRunFromSD() ? "sd" : "fat", gameTid);
-	if (access(manualPath, F_OK) == 0)
+	if (folderIndexExists(manualPath))
 		return manualPath;
 
 	return "";
@@ -926,6 +934,7 @@ int r4Theme(void) {
 	ms().loadSettings();
 	bs().loadSettings();
 	logInit();
+	logPrint("Warm switch: %lu sector reads saved\n", (unsigned long)warmSwitchReadsSaved());
 
 	graphicsInit();
 	langInit();
@@ -1049,15 +1058,20 @@ int r4Theme(void) {
 		printSmall(false, 0, 88, "Now copying data...", Alignment::center, FontPalette::white);
 		printSmall(false, 0, 96, "Do not turn off the power.", Alignment::center, FontPalette::white);
 		updateText(false);
+		DSiWareStagingStats stagingStats = {0, 0};
 		if (access(ms().dsiWarePubPath.c_str(), F_OK) == 0) {
-			fcopy("sd:/_nds/TWiLightMenu/tempDSiWare.pub", ms().dsiWarePubPath.c_str());
-			rename("sd:/_nds/TWiLightMenu/tempDSiWare.pub", "sd:/_nds/TWiLightMenu/tempDSiWare.pub.bak");
+			// Kept for a relaunch, or copied back again next time if this failed
+			if (dsiWareSyncFile("sd:/_nds/TWiLightMenu/tempDSiWare.pub", ms().dsiWarePubPath.c_str(), &stagingStats)) {
+				rename("sd:/_nds/TWiLightMenu/tempDSiWare.pub", "sd:/_nds/TWiLightMenu/tempDSiWare.pub.bak");
+			}
 		}
 		if (access(ms().dsiWarePrvPath.c_str(), F_OK) == 0) {
-			fcopy("sd:/_nds/TWiLightMenu/tempDSiWare.prv", ms().dsiWarePrvPath.c_str());
-			rename("sd:/_nds/TWiLightMenu/tempDSiWare.prv", "sd:/_nds/TWiLightMenu/tempDSiWare.prv.bak");
+			// Kept for a relaunch, or copied back again next time if this failed
+			if (dsiWareSyncFile("sd:/_nds/TWiLightMenu/tempDSiWare.prv", ms().dsiWarePrvPath.c_str(), &stagingStats)) {
+				rename("sd:/_nds/TWiLightMenu/tempDSiWare.prv", "sd:/_nds/TWiLightMenu/tempDSiWare.prv.bak");
+			}
 		}
-		logPrint("Copied DSiWare save back to flashcard\n");
+		logPrint("Copied DSiWare save back to flashcard (%lu bytes written)\n", stagingStats.bytesWritten);
 		clearText(false);
 		blackScreen = false;
 	}
@@ -1325,6 +1339,7 @@ int r4Theme(void) {
 				} else {
 					unlaunchRomBoot(launcherPath);
 				}
+				discCacheFlushAll();
 				fifoSendValue32(FIFO_USER_02, 1);	// ReturntoDSiMenu
 			}
 
@@ -1454,17 +1469,10 @@ int r4Theme(void) {
 		// Launch the item
 
 		if (applaunch) {
-			// Delete previously used DSiWare of flashcard from SD
-			if (access("sd:/_nds/TWiLightMenu/tempDSiWare.dsi", F_OK) == 0) {
-				remove("sd:/_nds/TWiLightMenu/tempDSiWare.dsi");
-			}
-			if (access("sd:/_nds/TWiLightMenu/tempDSiWare.pub.bak", F_OK) == 0) {
-				remove("sd:/_nds/TWiLightMenu/tempDSiWare.pub.bak");
-			}
-			if (access("sd:/_nds/TWiLightMenu/tempDSiWare.prv.bak", F_OK) == 0) {
-				remove("sd:/_nds/TWiLightMenu/tempDSiWare.prv.bak");
-			}
-			if (access("sd:/_nds/nds-bootstrap/patchOffsetCache/tempDSiWare.bin", F_OK) == 0) {
+			// Drop what was copied from flashcard to SD for the last DSiWare launch,
+			// unless the same DSiWare is being launched again
+			if (!dsiWareStagedFrom(filename.c_str(), "sd:/_nds/TWiLightMenu/tempDSiWare.dsi")) {
+				dsiWareUnstage("sd:/_nds/TWiLightMenu/tempDSiWare.dsi");
 				remove("sd:/_nds/nds-bootstrap/patchOffsetCache/tempDSiWare.bin");
 			}
 
@@ -1624,13 +1632,20 @@ int r4Theme(void) {
 					printSmall(false, 0, 98, "Now copying data...", Alignment::center);
 					printSmall(false, 0, 110, "Do not turn off the power.", Alignment::center);
 					updateText(false);
-					fcopy(ms().dsiWareSrlPath.c_str(), "sd:/_nds/TWiLightMenu/tempDSiWare.dsi");
+					DSiWareStagingStats stagingStats = {0, 0};
+					if (dsiWareStageSrl(ms().dsiWareSrlPath.c_str(), "sd:/_nds/TWiLightMenu/tempDSiWare.dsi", &stagingStats) == EStageCopied) {
+						// Cached patch offsets belong to the previously staged DSiWare
+						remove("sd:/_nds/nds-bootstrap/patchOffsetCache/tempDSiWare.bin");
+					}
 					if ((access(ms().dsiWarePubPath.c_str(), F_OK) == 0) && (NDSHeader.pubSavSize > 0)) {
-						fcopy(ms().dsiWarePubPath.c_str(), "sd:/_nds/TWiLightMenu/tempDSiWare.pub");
+						dsiWareRestoreSave("sd:/_nds/TWiLightMenu/tempDSiWare.pub");
+						dsiWareSyncFile(ms().dsiWarePubPath.c_str(), "sd:/_nds/TWiLightMenu/tempDSiWare.pub", &stagingStats);
 					}
 					if ((access(ms().dsiWarePrvPath.c_str(), F_OK) == 0) && (NDSHeader.prvSavSize > 0)) {
-						fcopy(ms().dsiWarePrvPath.c_str(), "sd:/_nds/TWiLightMenu/tempDSiWare.prv");
+						dsiWareRestoreSave("sd:/_nds/TWiLightMenu/tempDSiWare.prv");
+						dsiWareSyncFile(ms().dsiWarePrvPath.c_str(), "sd:/_nds/TWiLightMenu/tempDSiWare.prv", &stagingStats);
 					}
+					logPrint("Staged DSiWare on SD (%lu bytes read, %lu bytes written)\n", stagingStats.bytesRead, stagingStats.bytesWritten);
 
 					if ((access(ms().dsiWarePubPath.c_str(), F_OK) == 0 && (NDSHeader.pubSavSize > 0))
 					 || (access(ms().dsiWarePrvPath.c_str(), F_OK) == 0 && (NDSHeader.prvSavSize > 0))) {
@@ -2158,6 +2173,7 @@ int r4Theme(void) {
 				bool boostCpu = true;
 				bool boostVram = false;
 				bool tscTgds = false;
+				bool romUnreadable = false; // Block ROM which can't be read, or isn't going to the native GBA path
 
 				std::string romfolderNoSlash = ms().romfolder[ms().secondaryDevice];
 				RemoveTrailingSlashes(romfolderNoSlash);
@@ -2224,8 +2240,10 @@ int r4Theme(void) {
 						updateText(false);
 
 						u32 ptr = 0x08000000;
-						u32 romSize = getFileSize(filename.c_str());
 						FILE* gbaFile = fopen(filename.c_str(), "rb");
+						BlockRom gbaRom;
+						romUnreadable = !blockRomOpen(&gbaRom, gbaFile); // Block ROMs are read as if uncompressed
+						u32 romSize = gbaRom.romSize;
 						if (strncmp(gameTid, "AGBJ", 4) == 0 && romSize <= 0x40000) {
 							ptr += 0x400;
 						}
@@ -2248,7 +2266,7 @@ int r4Theme(void) {
 						}
 
 						for (u32 len = romSize; len > 0; len -= 0x8000) {
-							if (fread(&copyBuf, 1, (len>0x8000 ? 0x8000 : len), gbaFile) > 0) {
+							if (blockRomRead(&gbaRom, &copyBuf, (len>0x8000 ? 0x8000 : len)) > 0) {
 								s2RamAccess(true);
 								if (nor) {
 									expansion().WriteNorFlash(ptr-0x08000000, (u8*)copyBuf, (len>0x8000 ? 0x8000 : len));
@@ -2261,7 +2279,8 @@ int r4Theme(void) {
 								break;
 							}
 						}
-						fclose(gbaFile);
+						blockRomClose(&gbaRom);
+						if (gbaFile) fclose(gbaFile);
 
 						ptr = 0x0A000000;
 
@@ -2269,7 +2288,7 @@ int r4Theme(void) {
 						u32 savesize = getFileSize(savename.c_str());
 						if (savesize > 0x10000) savesize = 0x10000;
 
-						if (savesize > 0) {
+						if (savesize > 0 && !romUnreadable) {
 							FILE* savFile = fopen(savename.c_str(), "rb");
 							for (u32 len = savesize; len > 0; len -= 0x8000) {
 								if (fread(&copyBuf, 1, (len>0x8000 ? 0x8000 : len), savFile) > 0) {
@@ -2579,7 +2598,11 @@ int r4Theme(void) {
 				argarray.push_back(ROMpath);
 				argarray.at(0) = (char *)(tgdsMode ? tgdsNdsPath : ndsToBoot);
 
-				int err = runNdsFile (ndsToBoot, argarray.size(), (const char **)&argarray[0], sys().isRunFromSD(), !useNDSB, true, dsModeSwitch, boostCpu, boostVram, tscTgds, -1);	// Pass ROM to emulator as argument
+				// GBARunner2 and the emulators open the ROM themselves, and can't read block ROMs
+				if (ms().launchType[ms().secondaryDevice] != TWLSettings::EGBANativeLaunch && blockRomIsPacked(ROMpath)) {
+					romUnreadable = true;
+				}
+				int err = romUnreadable ? BLOCK_ROM_START_ERROR : runNdsFile (ndsToBoot, argarray.size(), (const char **)&argarray[0], sys().isRunFromSD(), !useNDSB, true, dsModeSwitch, boostCpu, boostVram, tscTgds, -1);	// Pass ROM to emulator as argument
 				char text[32];
 				snprintf (text, sizeof(text), "Start failed. Error %i", err);
 				clearText(false);
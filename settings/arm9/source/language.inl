@@ -38,6 +38,7 @@ STRING(UPDATING_NDS_BOOTSTRAP, "Updating nds-bootstrap")
 
 // GUI settings
 STRING(UPDATETWLMENU, "Update TWiLight Menu++")
+STRING(STORAGE_HEALTH, "Storage health")
 STRING(DSCLASSICMENU, "DS Classic Menu on startup")
 STRING(USER_INTERFACE, "User Interface")
 STRING(CUSTOM_THEME, "Custom Theme")
@@ -107,6 +108,7 @@ STRING(REPLACE_BANNER, "Replace Banner")
 STRING(NO_FILETYPES, "No Filetypes")
 
 STRING(DESCRIPTION_UPDATETWLMENU, "Updates TWiLight Menu++ to a new version.")
+STRING(DESCRIPTION_STORAGE_HEALTH, "Measures the read speed of the SD card or flashcard, and finds fragmented ROMs and saves, which load slower.")
 STRING(DESCRIPTION_DSCLASSICMENU, "The menu that is shown by pressing SELECT in the Nintendo DSi UI, can be shown before the ROM select menu.")
 STRING(DESCRIPTION_SELECTBUTTONOPTION, "Choose a menu to show when pressing SELECT in the Nintendo DSi, SEGA Saturn, and Homebrew Launcher UIs.")
 STRING(DESCRIPTION_USER_INTERFACE, "Each UI provides a different look and functionality.")
@@ -416,6 +418,16 @@ STRING(TOUCH, "Touch")
 STRING(HOTKEY_SET, "Hotkey set!")
 STRING(HOTKEY_SETTING_CANCELLED, "Hotkey setting cancelled!")
 
+STRING(CHECKING_STORAGE, "Checking storage...")
+STRING(CLUSTER_SIZE, "Cluster size")
+STRING(SEQUENTIAL_READ, "Sequential read")
+STRING(RANDOM_READS, "Random 4KB reads")
+STRING(FRAGMENTS, "fragments")
+STRING(NO_FRAGMENTED_FILES, "No fragmented ROMs or saves found.")
+STRING(A_MAKE_CONTIGUOUS_B_BACK, "\\A: Make contiguous, \\B: Back")
+STRING(MAKING_CONTIGUOUS, "Making file contiguous...")
+STRING(NO_CONTIGUOUS_SPACE, "Not enough contiguous free space.")
+
 // STRING(SNES_EMULATOR, "Choose a SNES emulator")
 // STRING(DESCRIPTION_SNES_EMULATOR, "Choose whether you would rather use SNEmulDS or lolSNES.")
 
@@ -23,13 +23,16 @@
 #include "common/bootstrapsettings.h"
 #include "common/twlmenusettings.h"
 #include "common/cardlaunch.h"
+#include "common/discCache.h"
 #include "common/flashcard.h"
 #include "common/tonccpy.h"
+#include "common/warmSwitch.h"
 #include "settingspage.h"
 #include "settingsgui.h"
 #include "language.h"
 #include "gbarunner2settings.h"
 #include "twlFlashcard.h"
+#include "storageHealth.h"
 
 #include "soundeffect.h"
 #include "common/systemdetails.h"
@@ -169,6 +172,7 @@ void rebootTWLMenuPP()
 	memcpy((u32 *)0x02000300, autoboot_bin, 0x020);
 	for (int i = 0; i < 10; i++)
 		swiWaitForVBlank();
+	discCacheFlushAll();
 	fifoSendValue32(FIFO_USER_02, 1); // Reboot TWiLight Menu++ for TWL_FIRM changes to take effect
 	for (int i = 0; i < 15; i++)
 		swiWaitForVBlank();
@@ -712,6 +716,94 @@ void opt_update()
 	clearText();
 }
 
+#define STORAGE_LIST_SIZE 6
+
+void opt_storage_health()
+{
+	const int x = ms().rtl() ? 256 - 12 : 12;
+	const Alignment align = ms().rtl() ? Alignment::right : Alignment::left;
+
+	clearText();
+	printLarge(false, ms().rtl() ? 256 - 4 : 4, 0, STR_CHECKING_STORAGE, align);
+	updateText(false);
+
+	const int device = ((ms().secondaryDevice && flashcardFound()) || !sdFound()) ? 1 : 0;
+	StorageStats stats;
+	storageMeasure(device ? "fat:/" : "sd:/", &stats);
+	StorageFile files[STORAGE_LIST_SIZE];
+	int fileCount = storageFindFragmented(ms().romfolder[device].c_str(), files, STORAGE_LIST_SIZE);
+
+	int cursorPosition = 0;
+	bool refreshText = true;
+	std::string message;
+	while (1) {
+		if (refreshText) {
+			clearText();
+			printLarge(false, ms().rtl() ? 256 - 4 : 4, 0, STR_STORAGE_HEALTH, align);
+			printSmall(false, x, 29, STR_CLUSTER_SIZE + ": " + std::to_string(stats.bytesPerCluster / 1024) + " KB", align);
+			printSmall(false, x, 43, STR_SEQUENTIAL_READ + ": " + std::to_string(stats.sequentialKBps) + " KB/s", align);
+			printSmall(false, x, 57, STR_RANDOM_READS + ": " + std::to_string(stats.randomReadsPerSec) + "/s", align);
+			if (fileCount == 0) {
+				printSmall(false, x, 78, STR_NO_FRAGMENTED_FILES, align);
+			}
+			for (int i = 0; i < fileCount; i++) {
+				const char *name = strrchr(files[i].path, '/');
+				printSmall(false, x, 78 + (14 * i), std::string(name ? name + 1 : files[i].path) + " (" + std::to_string(files[i].fragments) + " " + STR_FRAGMENTS + ")", align, (cursorPosition == i && currentTheme != 4) ? FontPalette::user : FontPalette::regular);
+			}
+			if (currentTheme == 4 && fileCount > 0) {
+				printSmall(false, ms().rtl() ? 256 - 4 : 4, 78 + (14 * cursorPosition), ms().rtl() ? "<" : ">", align);
+			}
+			printSmall(false, 0, 170, message.empty() ? STR_A_MAKE_CONTIGUOUS_B_BACK : message, Alignment::center);
+			updateText(false);
+			refreshText = false;
+		}
+
+		if (!gui().isExited()) {
+			snd().playBgMusic(ms().settingsMusic);
+		}
+
+		do
+		{
+			scanKeys();
+			pressed = keysDownRepeat();
+			touchRead(&touch);
+			swiWaitForVBlank();
+		} while (!pressed);
+
+		if ((pressed & KEY_UP) && fileCount > 1) {
+			mmEffectEx(currentTheme==4 ? &snd().snd_saturn_select : &snd().snd_select);
+			cursorPosition--;
+			if (cursorPosition < 0) cursorPosition = fileCount - 1;
+			refreshText = true;
+		} else if ((pressed & KEY_DOWN) && fileCount > 1) {
+			mmEffectEx(currentTheme==4 ? &snd().snd_saturn_select : &snd().snd_select);
+			cursorPosition++;
+			if (cursorPosition >= fileCount) cursorPosition = 0;
+			refreshText = true;
+		} else if ((pressed & KEY_A) && fileCount > 0) {
+			mmEffectEx(currentTheme==4 ? &snd().snd_saturn_launch : &snd().snd_launch);
+			clearText();
+			printLarge(false, ms().rtl() ? 256 - 4 : 4, 0, STR_MAKING_CONTIGUOUS, align);
+			printSmall(false, 0, 170, STR_PLEASE_WAIT_TAKE_WHILE, Alignment::center);
+			updateText(false);
+
+			if (storageRelocate(files[cursorPosition].path)) {
+				message.clear();
+				fileCount--;
+				memmove(&files[cursorPosition], &files[cursorPosition + 1], (fileCount - cursorPosition) * sizeof(StorageFile));
+				if (cursorPosition >= fileCount && cursorPosition > 0) cursorPosition--;
+			} else {
+				message = STR_NO_CONTIGUOUS_SPACE;
+			}
+			refreshText = true;
+		} else if (pressed & KEY_B) {
+			mmEffectEx(currentTheme==4 ? &snd().snd_saturn_back : &snd().snd_back);
+			break;
+		}
+	}
+	clearText();
+}
+
 void opt_set_luma_autoboot()
 {
 	// Commented code is disabled due to saving Luma's .ini file clearing comments, causing the settings to reset
@@ -988,6 +1080,7 @@ int settingsMode(void)
 	gs().loadSettings();
 	bs().loadSettings();
 	logInit();
+	logPrint("Warm switch: %lu sector reads saved\n", (unsigned long)warmSwitchReadsSaved());
 	loadAkThemeList();
 	loadR4ThemeList();
 	load3DSThemeList();
@@ -1495,6 +1588,10 @@ int settingsMode(void)
 
 	miscPage.option(STR_SCREEN_COLOR_FILTER, STR_DESCRIPTION_SCREEN_COLOR_FILTER, Option::Nul(opt_lut_select), {STR_PRESS_A}, {0});
 
+	if (sdFound() || flashcardFound()) {
+		miscPage.option(STR_STORAGE_HEALTH, STR_DESCRIPTION_STORAGE_HEALTH, Option::Nul(opt_storage_health), {STR_PRESS_A}, {0});
+	}
+
 	if (sdFound() && isDSiMode()) {
 		if (!sys().arm7SCFGLocked()) {
 			miscPage
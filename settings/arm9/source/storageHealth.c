@@ -0,0 +1,246 @@
+#include <nds.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <malloc.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "partition.h"
+#include "common/discCache.h"
+#include "storageHealth.h"
+
+#define CLUSTER_FREE	0x00000000
+#define CLUSTER_EOF		0x0FFFFFFF
+#define CLUSTER_FIRST	0x00000002
+
+#define MEASURE_TIMER		2	// Uses timers 2 and 3
+#define SEQUENTIAL_SECTORS	128	// 64KB per read
+#define SEQUENTIAL_READS	32
+#define RANDOM_SECTORS		8	// 4KB per read
+#define RANDOM_READS		64
+#define COPY_BUFFER_SIZE	0x10000
+#define MAX_FOLDER_DEPTH	4
+
+// libfat internal
+extern uint32_t _FAT_fat_nextCluster(PARTITION* partition, uint32_t cluster);
+
+bool storageMeasure(const char* drive, StorageStats* stats) {
+	memset(stats, 0, sizeof(StorageStats));
+	PARTITION* partition = _FAT_partition_getPartitionFromPath(drive);
+	if (!partition || partition->bytesPerSector != 512) {
+		return false;
+	}
+	stats->bytesPerCluster = partition->bytesPerCluster;
+
+	const DISC_INTERFACE* disc = discCacheBase(partition->disc);
+	const u32 dataSectors = (partition->fat.lastCluster - 1) * partition->sectorsPerCluster;
+	if (dataSectors < SEQUENTIAL_SECTORS * SEQUENTIAL_READS) {
+		return false;
+	}
+	u8* buffer = (u8*)memalign(32, SEQUENTIAL_SECTORS * 512);
+	if (!buffer) {
+		return false;
+	}
+
+	bool ok = true;
+	cpuStartTiming(MEASURE_TIMER);
+	for (int i = 0; ok && i < SEQUENTIAL_READS; i++) {
+		ok = disc->readSectors(partition->dataStart + i * SEQUENTIAL_SECTORS, SEQUENTIAL_SECTORS, buffer);
+	}
+	u32 ticks = cpuEndTiming();
+	if (ok && ticks > 0) {
+		stats->sequentialKBps = (u64)(SEQUENTIAL_SECTORS * SEQUENTIAL_READS / 2) * BUS_CLOCK / ticks;
+	}
+
+	u32 seed = 0x2545F491;
+	cpuStartTiming(MEASURE_TIMER);
+	for (int i = 0; ok && i < RANDOM_READS; i++) {
+		seed = seed * 1664525 + 1013904223;
+		const u32 sector = (seed % (dataSectors - RANDOM_SECTORS)) & ~(RANDOM_SECTORS - 1);
+		ok = disc->readSectors(partition->dataStart + sector, RANDOM_SECTORS, buffer);
+	}
+	ticks = cpuEndTiming();
+	if (ok && ticks > 0) {
+		stats->randomReadsPerSec = (u64)RANDOM_READS * BUS_CLOCK / ticks;
+	}
+
+	free(buffer);
+	return ok;
+}
+
+static u32 chainRuns(PARTITION* partition, u32 cluster) {
+	u32 runs = 0, count = 0, prev = 0;
+	while (cluster >= CLUSTER_FIRST && cluster < CLUSTER_EOF && count <= partition->fat.lastCluster) {
+		if (count == 0 || cluster != prev + 1) {
+			runs++;
+		}
+		prev = cluster;
+		count++;
+		cluster = _FAT_fat_nextCluster(partition, cluster);
+	}
+	return runs;
+}
+
+u32 storageFragments(const char* path) {
+	struct stat st;
+	PARTITION* partition = _FAT_partition_getPartitionFromPath(path);
+	if (!partition || stat(path, &st) != 0) {
+		return 0;
+	}
+	// libfat gives the first cluster as the inode number
+	return chainRuns(partition, st.st_ino);
+}
+
+static void addFile(StorageFile* files, int* count, int maxFiles, const char* path, u32 fragments) {
+	int pos = *count;
+	while (pos > 0 && files[pos - 1].fragments < fragments) {
+		pos--;
+	}
+	if (pos >= maxFiles) {
+		return;
+	}
+	if (*count < maxFiles) {
+		(*count)++;
+	}
+	memmove(&files[pos + 1], &files[pos], (*count - 1 - pos) * sizeof(StorageFile));
+	strncpy(files[pos].path, path, sizeof(files[pos].path) - 1);
+	files[pos].path[sizeof(files[pos].path) - 1] = 0;
+	files[pos].fragments = fragments;
+}
+
+static void findFragmented(PARTITION* partition, char* path, int depth, StorageFile* files, int* count, int maxFiles) {
+	DIR* dir = opendir(path);
+	if (!dir) {
+		return;
+	}
+	const size_t pathLen = strlen(path);
+	struct dirent* entry;
+	while ((entry = readdir(dir)) != NULL) {
+		if (entry->d_name[0] == '.' || pathLen + 1 + strlen(entry->d_name) >= sizeof(files[0].path)) {
+			continue;
+		}
+		sprintf(path + pathLen, "/%s", entry->d_name);
+		if (entry->d_type == DT_DIR) {
+			if (depth < MAX_FOLDER_DEPTH) {
+				findFragmented(partition, path, depth + 1, files, count, maxFiles);
+			}
+		} else {
+			struct stat st;
+			if (stat(path, &st) == 0) {
+				const u32 fragments = chainRuns(partition, st.st_ino);
+				if (fragments > 1) {
+					addFile(files, count, maxFiles, path, fragments);
+				}
+			}
+		}
+		path[pathLen] = 0;
+	}
+	closedir(dir);
+}
+
+int storageFindFragmented(const char* folder, StorageFile* files, int maxFiles) {
+	PARTITION* partition = _FAT_partition_getPartitionFromPath(folder);
+	if (!partition || maxFiles <= 0) {
+		return 0;
+	}
+
+	char path[sizeof(files[0].path)];
+	strncpy(path, folder, sizeof(path) - 1);
+	path[sizeof(path) - 1] = 0;
+	const size_t len = strlen(path);
+	if (len > 0 && path[len - 1] == '/') {
+		path[len - 1] = 0;
+	}
+
+	int count = 0;
+	findFragmented(partition, path, 0, files, &count, maxFiles);
+	return count;
+}
+
+static u32 findFreeRun(PARTITION* partition, u32 needed) {
+	u32 runStart = 0, runLength = 0;
+	for (u32 cluster = CLUSTER_FIRST; cluster <= partition->fat.lastCluster; cluster++) {
+		if (_FAT_fat_nextCluster(partition, cluster) != CLUSTER_FREE) {
+			runLength = 0;
+		} else {
+			if (runLength == 0) {
+				runStart = cluster;
+			}
+			if (++runLength == needed) {
+				return runStart;
+			}
+		}
+	}
+	return 0;
+}
+
+static bool copyFile(const char* srcPath, const char* dstPath) {
+	FILE* src = fopen(srcPath, "rb");
+	FILE* dst = src ? fopen(dstPath, "wb") : NULL;
+	u8* buffer = dst ? (u8*)malloc(COPY_BUFFER_SIZE) : NULL;
+	bool ok = (buffer != NULL);
+	while (ok) {
+		const size_t len = fread(buffer, 1, COPY_BUFFER_SIZE, src);
+		if (len == 0) {
+			ok = !ferror(src);
+			break;
+		}
+		ok = (fwrite(buffer, 1, len, dst) == len);
+	}
+	free(buffer);
+	if (dst && fclose(dst) != 0) {
+		ok = false;
+	}
+	if (src) {
+		fclose(src);
+	}
+	return ok;
+}
+
+bool storageRelocate(const char* path) {
+	struct stat st;
+	PARTITION* partition = _FAT_partition_getPartitionFromPath(path);
+	if (!partition || stat(path, &st) != 0 || st.st_size == 0) {
+		return false;
+	}
+	const u32 needed = ((u32)st.st_size + partition->bytesPerCluster - 1) / partition->bytesPerCluster;
+
+	char tempPath[sizeof(((StorageFile*)0)->path) + 4];
+	char backupPath[sizeof(tempPath)];
+	snprintf(tempPath, sizeof(tempPath), "%s.tmp", path);
+	snprintf(backupPath, sizeof(backupPath), "%s.bak", path);
+
+	// Create the entry first, in case the folder needs another cluster for it
+	FILE* file = fopen(tempPath, "wb");
+	if (!file) {
+		return false;
+	}
+	fclose(file);
+
+	const u32 runStart = findFreeRun(partition, needed);
+	if (runStart == 0) {
+		remove(tempPath);
+		return false;
+	}
+
+	// libfat takes free clusters from this hint onwards, so the copy lands in the run
+	partition->fat.firstFree = runStart;
+	if (!copyFile(path, tempPath) || storageFragments(tempPath) != 1) {
+		remove(tempPath);
+		return false;
+	}
+
+	// Keep the original until the copy has its name
+	bool ok = (rename(path, backupPath) == 0);
+	if (ok && rename(tempPath, path) != 0) {
+		rename(backupPath, path);
+		ok = false;
+	}
+	if (ok) {
+		remove(backupPath);
+	} else {
+		remove(tempPath);
+	}
+	discCacheFlushAll();
+	return ok;
+}
@@ -0,0 +1,50 @@
+#ifndef STORAGE_HEALTH_H
+#define STORAGE_HEALTH_H
+
+#include <nds/ndstypes.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+	u32 bytesPerCluster;
+	u32 sequentialKBps;		// Reading 64KB at a time
+	u32 randomReadsPerSec;	// Reading 4KB at random places
+} StorageStats;
+
+typedef struct {
+	char path[256];
+	u32 fragments;			// Runs of contiguous clusters
+} StorageFile;
+
+/*
+Get the cluster size of a drive ("sd:/" or "fat:/"), and measure its read
+speed straight from the SD card or flashcard, without the sector cache
+*/
+bool storageMeasure(const char* drive, StorageStats* stats);
+
+/*
+Count the runs of contiguous clusters a file is stored in.
+Returns 0 if the file can't be found or is empty.
+*/
+u32 storageFragments(const char* path);
+
+/*
+List the most fragmented files in a folder and its subfolders, most
+fragmented first. Files stored in one run aren't listed.
+Returns the number of files listed.
+*/
+int storageFindFragmented(const char* folder, StorageFile* files, int maxFiles);
+
+/*
+Rewrite a file into one run of free clusters. The original is kept if
+there's no run large enough or the copy fails.
+*/
+bool storageRelocate(const char* path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // STORAGE_HEALTH_H
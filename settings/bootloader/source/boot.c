@@ -49,6 +49,7 @@ Helpful information:
 #include <nds/arm7/audio.h>
 #include "dmaTwl.h"
 #include "common/tonccpy.h"
+#include "common/srldrPack.h"
 #include "sdmmc.h"
 #include "i2c.h"
 #include "fat.h"
@@ -270,6 +271,41 @@ void resetMemory_ARM7 (void)
 }
 
 
+extern void LZ77_DecompressPacked(const u8* source, u32 packedLen, u8* destination);
+
+/*-------------------------------------------------------------------------
+getPackedSizes
+Gets the packed ARM9 and ARM7 sizes of a packed .srldr module, and clears
+them from its header so the module sees a normal header
+--------------------------------------------------------------------------*/
+static void getPackedSizes (u32* header, u32* arm9Packed, u32* arm7Packed) {
+	if (header[SRLDR_PACK_MAGIC_OFFSET>>2] != SRLDR_PACK_MAGIC) {
+		*arm9Packed = 0;
+		*arm7Packed = 0;
+		return;
+	}
+	*arm9Packed = header[SRLDR_PACK_ARM9_OFFSET>>2];
+	*arm7Packed = header[SRLDR_PACK_ARM7_OFFSET>>2];
+	header[SRLDR_PACK_MAGIC_OFFSET>>2] = 0;
+	header[SRLDR_PACK_ARM9_OFFSET>>2] = 0;
+	header[SRLDR_PACK_ARM7_OFFSET>>2] = 0;
+}
+
+/*-------------------------------------------------------------------------
+loadSection
+Reads a binary to RAM. A packed binary is read to the end of its RAM area
+and decompressed in place
+--------------------------------------------------------------------------*/
+static void loadSection (char* dst, u32 fileCluster, u32 src, u32 len, u32 packedLen) {
+	if (!packedLen) {
+		fileRead(dst, fileCluster, src, len);
+		return;
+	}
+	char* packed = dst + len - packedLen;
+	fileRead(packed, fileCluster, src, packedLen);
+	LZ77_DecompressPacked((u8*)packed, packedLen, (u8*)dst);
+}
+
 u32 ROM_TID;
 
 void loadBinary_ARM7 (u32 fileCluster)
@@ -284,8 +320,18 @@ void loadBinary_ARM7 (u32 fileCluster)
 
 		ROM_TID = *(u32*)(TWL_HEAD+0xC);
 
-		tonccpy(ARM9_DST, (char*)0x02800000, ARM9_LEN);
-		tonccpy(ARM7_DST, (char*)0x02B80000, ARM7_LEN);
+		u32 ARM9_PACKED, ARM7_PACKED;
+		getPackedSizes((u32*)TWL_HEAD, &ARM9_PACKED, &ARM7_PACKED);
+
+		// runNds9 only read the packed binaries, if packed
+		if (ARM9_PACKED)
+			LZ77_DecompressPacked((u8*)0x02800000, ARM9_PACKED, (u8*)ARM9_DST);
+		else
+			tonccpy(ARM9_DST, (char*)0x02800000, ARM9_LEN);
+		if (ARM7_PACKED)
+			LZ77_DecompressPacked((u8*)0x02B80000, ARM7_PACKED, (u8*)ARM7_DST);
+		else
+			tonccpy(ARM7_DST, (char*)0x02B80000, ARM7_LEN);
 
 		// first copy the header to its proper location, excluding
 		// the ARM9 start address, so as not to start it
@@ -330,9 +376,12 @@ void loadBinary_ARM7 (u32 fileCluster)
 
 	ROM_TID = ndsHeader[0x00C>>2];
 
+	u32 ARM9_PACKED, ARM7_PACKED;
+	getPackedSizes(ndsHeader, &ARM9_PACKED, &ARM7_PACKED);
+
 	// Load binaries into memory
-	fileRead(ARM9_DST, fileCluster, ARM9_SRC, ARM9_LEN);
-	fileRead(ARM7_DST, fileCluster, ARM7_SRC, ARM7_LEN);
+	loadSection(ARM9_DST, fileCluster, ARM9_SRC, ARM9_LEN, ARM9_PACKED);
+	loadSection(ARM7_DST, fileCluster, ARM7_SRC, ARM7_LEN, ARM7_PACKED);
 
 	// first copy the header to its proper location, excluding
 	// the ARM9 start address, so as not to start it
@@ -343,6 +392,7 @@ void loadBinary_ARM7 (u32 fileCluster)
 	if (!dsMode && dsiMode && (ndsHeader[0x10>>2]&BIT(16+1))) {
 		// Read full TWL header
 		fileRead((char*)TWL_HEAD, fileCluster, 0, 0x1000);
+		getPackedSizes((u32*)TWL_HEAD, &ARM9_PACKED, &ARM7_PACKED);	// Only to clear them
 
 		u32 ARM9i_SRC = *(u32*)(TWL_HEAD+0x1C0);
 		char* ARM9i_DST = (char*)*(u32*)(TWL_HEAD+0x1C8);
@@ -7,12 +7,15 @@
 #include "myDSiMode.h"
 #include "exptools.h"
 #include "nand/nandio.h"
+#include "nandFacts.h"
 
 #include "bootsplash.h"
+#include "common/blockRom.h"
 #include "common/bootstrapsettings.h"
 #include "common/bootstrappaths.h"
 #include "common/cardlaunch.h"
 #include "common/twlmenusettings.h"
+#include "common/discCache.h"
 #include "common/fileCopy.h"
 #include "common/fatHeader.h"
 #include "common/flashcard.h"
@@ -24,6 +27,7 @@
 #include "common/stringtool.h"
 #include "common/systemdetails.h"
 #include "common/tonccpy.h"
+#include "common/warmSwitch.h"
 #include "defaultSettings.h"
 #include "twlFlashcard.h"
 #include "graphics/graphics.h"
@@ -239,6 +243,7 @@ void unlaunchRomBoot(std::string_view rom) {
 		*(u16*)(0x0200080E) = swiCRC16(0xFFFF, (void*)0x02000810, 0x3F0);		// Unlaunch CRC16
 	}
 
+	discCacheFlushAll();
 	DC_FlushAll();						// Make reboot not fail
 	fifoSendValue32(FIFO_USER_02, 1);	// Reboot into DSiWare title, booted via Unlaunch
 	stop();
@@ -335,6 +340,7 @@ void ntrStartSdGame(void) {
 		unlaunchRomBoot("sd:/_nds/TWiLightMenu/main.srldr");
 	} else {
 		tonccpy((u32 *)0x02000300, autoboot_bin, 0x20);
+		discCacheFlushAll();
 		DC_FlushAll();						// Make reboot not fail
 		fifoSendValue32(FIFO_USER_02, 1);
 		stop();
@@ -354,6 +360,7 @@ void dsCardLaunch() {
 
 	unlaunchSetHiyaBoot();
 
+	discCacheFlushAll();
 	DC_FlushAll();						// Make reboot not fail
 	fifoSendValue32(FIFO_USER_02, 1); // Reboot into DSiWare title, booted via Launcher
 	stop();
@@ -1045,6 +1052,10 @@ void lastRunROM()
 
 			unlaunchRomBoot(ms().previousUsedDevice ? "sdmc:/_nds/TWiLightMenu/tempDSiWare.dsi" : ms().dsiWareSrlPath);
 		}
+	} else if (ms().launchType[ms().previousUsedDevice] > Launch::EDSiWareLaunch && ms().launchType[ms().previousUsedDevice] != Launch::EGBANativeLaunch
+			 && blockRomIsPacked(ms().romPath[ms().previousUsedDevice].c_str())) {
+		// GBARunner2 and the emulators open the ROM themselves, and can't read block ROMs
+		err = BLOCK_ROM_START_ERROR;
 	} else if (ms().launchType[ms().previousUsedDevice] == Launch::ENESDSLaunch) {
 		if (access(ms().romPath[ms().previousUsedDevice].c_str(), F_OK) != 0) return;	// Skip to running TWiLight Menu++
 
@@ -1110,8 +1121,6 @@ void lastRunROM()
 		if (*(u16*)(0x020000C0) == 0 || ms().gbaBooter != TWLSettings::EGbaNativeGbar2 || access(ms().romPath[true].c_str(), F_OK) != 0) return;	// Skip to running TWiLight Menu++
 
 		std::string savepath = replaceAll(ms().romPath[true], ".gba", ".sav");
-		u32 romSize = getFileSize(ms().romPath[true].c_str());
-		if (romSize > 0x2000000) romSize = 0x2000000;
 		u32 savesize = getFileSize(savepath.c_str());
 		if (savesize > 0x20000) savesize = 0x20000;
 
@@ -1121,14 +1130,20 @@ void lastRunROM()
 		fadeType = true;
 
 		u32 ptr = 0x08000000;
-		char titleID[4];
+		char titleID[4] = {0};
 		FILE* gbaFile = fopen(ms().romPath[true].c_str(), "rb");
-		fseek(gbaFile, 0xAC, SEEK_SET);
-		fread(&titleID, 1, 4, gbaFile);
+		BlockRom gbaRom;
+		const bool romUnreadable = !blockRomOpen(&gbaRom, gbaFile); // Block ROMs are read as if uncompressed
+		u32 romSize = gbaRom.romSize;
+		if (romSize > 0x2000000) romSize = 0x2000000;
+		if (!romUnreadable) {
+			fseek(gbaFile, 0xAC, SEEK_SET);
+			fread(&titleID, 1, 4, gbaFile);
+		}
 		if (strncmp(titleID, "AGBJ", 4) == 0 && romSize <= 0x40000) {
 			ptr += 0x400;
 		}
-		fseek(gbaFile, 0, SEEK_SET);
+		blockRomSeek(&gbaRom, 0);
 
 		extern char copyBuf[0x8000];
 		bool nor = false;
@@ -1144,7 +1159,7 @@ void lastRunROM()
 
 		if (!nor) {
 			for (u32 len = romSize; len > 0; len -= 0x8000) {
-				if (fread(&copyBuf, 1, (len>0x8000 ? 0x8000 : len), gbaFile) > 0) {
+				if (blockRomRead(&gbaRom, &copyBuf, (len>0x8000 ? 0x8000 : len)) > 0) {
 					s2RamAccess(true);
 					tonccpy((u16*)ptr, &copyBuf, (len>0x8000 ? 0x8000 : len));
 					s2RamAccess(false);
@@ -1153,12 +1168,13 @@ void lastRunROM()
 					break;
 				}
 			}
-			fclose(gbaFile);
 		}
+		blockRomClose(&gbaRom);
+		if (gbaFile) fclose(gbaFile);
 
 		ptr = 0x0A000000;
 
-		if (savesize > 0) {
+		if (savesize > 0 && !romUnreadable) {
 			FILE* savFile = fopen(savepath.c_str(), "rb");
 			for (u32 len = (savesize > 0x10000 ? 0x10000 : savesize); len > 0; len -= 0x8000) {
 				if (fread(&copyBuf, 1, (len>0x8000 ? 0x8000 : len), savFile) > 0) {
@@ -1178,8 +1194,12 @@ void lastRunROM()
 			swiWaitForVBlank();
 		}
 
-		argarray.at(0) = (char*)"fat:/_nds/TWiLightMenu/gbapatcher.srldr";
-		err = runNdsFile(argarray[0], argarray.size(), (const char **)&argarray[0], sys().isRunFromSD(), true, true, false, true, true, false, -1);
+		if (romUnreadable) {
+			err = BLOCK_ROM_START_ERROR;
+		} else {
+			argarray.at(0) = (char*)"fat:/_nds/TWiLightMenu/gbapatcher.srldr";
+			err = runNdsFile(argarray[0], argarray.size(), (const char **)&argarray[0], sys().isRunFromSD(), true, true, false, true, true, false, -1);
+		}
 	} else if (ms().launchType[ms().previousUsedDevice] == Launch::EA7800DSLaunch) {
 		if (access(ms().romPath[ms().previousUsedDevice].c_str(), F_OK) != 0) return;	// Skip to running TWiLight Menu++
 
@@ -1367,11 +1387,15 @@ void lastRunROM()
 	}
 }
 
-void setDSiDonorRom(const bool is3DS) {
-	if (!nandMounted) {
-		nandMounted = fatMountSimple("nand", &io_dsi_nand);
+// Donor paths set by the user may not be on NAND
+static bool donorRomExists(const std::string& path) {
+	if (strncmp(path.c_str(), "nand:", 5) == 0) {
+		return nandFactExists(path.c_str());
 	}
+	return (access(path.c_str(), F_OK) == 0);
+}
 
+void setDSiDonorRom(const bool is3DS) {
 	// const char* pathDefine0 = "DONORTWL0_NDS_PATH"; // SDK5.0
 	// const char* pathDefine = "DONORTWL_NDS_PATH"; // SDK5.x
 	const char* pathDefineOnly0 = "DONORTWLONLY0_NDS_PATH"; // SDK5.0
@@ -1391,10 +1415,10 @@ void setDSiDonorRom(const bool is3DS) {
 		donorRomPath = "";
 	} */
 
-	if (donorRomPathOnly0 != "" && access(donorRomPathOnly0.c_str(), F_OK) != 0) {
+	if (donorRomPathOnly0 != "" && !donorRomExists(donorRomPathOnly0)) {
 		donorRomPathOnly0 = "";
 	}
-	if (donorRomPathOnly != "" && access(donorRomPathOnly.c_str(), F_OK) != 0) {
+	if (donorRomPathOnly != "" && !donorRomExists(donorRomPathOnly)) {
 		donorRomPathOnly = "";
 	}
 
@@ -1403,11 +1427,8 @@ void setDSiDonorRom(const bool is3DS) {
 		u32 tid1 = 0x484E4B45; // Nintendo DSi Sound
 		u32 tid2 = 0x00030005;
 
-		TWLSettings::TRegion region = TWLSettings::ERegionJapan;
-		FILE *hwinfo_s = fopen("nand:/sys/HWINFO_S.dat", "rb");
-		fseek(hwinfo_s, 0x90, SEEK_SET);
-		region = (TWLSettings::TRegion)fgetc(hwinfo_s);
-		fclose(hwinfo_s);
+		u8 region = TWLSettings::ERegionJapan;
+		nandFactRead("nand:/sys/HWINFO_S.dat", 0x90, &region, 1);
 
 		switch ((int)region) {
 			case TWLSettings::ERegionJapan:
@@ -1428,14 +1449,9 @@ void setDSiDonorRom(const bool is3DS) {
 		}
 
 		sprintf(validTmdPath, "nand:/title/%08lx/%08lx/content/title.tmd", tid2, tid1);
-		FILE* donorTmd = fopen(validTmdPath, "rb");
-		if (donorTmd) {
+		u8 validAppVer = 0;
+		if (nandFactRead(validTmdPath, 0x1E7, &validAppVer, 1)) {
 			char validAppPath[64];
-			int validAppVer = 0;
-
-			fseek(donorTmd, 0x1E7, SEEK_SET);
-			validAppVer = fgetc(donorTmd);
-			fclose(donorTmd);
 
 			sprintf(validAppPath, "nand:/title/%08lx/%08lx/content/0000000%i.app", tid2, tid1, validAppVer);
 			bootstrapini.SetString("NDS-BOOTSTRAP", pathDefineOnly0, validAppPath);
@@ -1451,15 +1467,11 @@ void setDSiDonorRom(const bool is3DS) {
 		u32 tid2 = 0x00030005;
 
 		sprintf(validTmdPath, "nand:/title/%08lx/%08lx/content/00000000.tmd", tid2, tid1);
-		FILE* donorTmd = fopen(validTmdPath, "rb");
-		if (donorTmd) {
+		u8 appNameTemp[4] = {0};
+		if (nandFactRead(validTmdPath, 0xB04, appNameTemp, 4)) {
 			char validAppPath[64];
 
-			u8 appNameTemp[4] = {0};
 			u8 appName8[4] = {0};
-			fseek(donorTmd, 0xB04, SEEK_SET);
-			fread(appNameTemp, 1, 4, donorTmd);
-			fclose(donorTmd);
 			for (int i = 0; i < 4; i++) {
 				appName8[i] = appNameTemp[3-i];
 			}
@@ -1476,10 +1488,6 @@ void setDSiDonorRom(const bool is3DS) {
 }
 
 void setDSiDonorRomSCFGLocked(void) {
-	if (!nandMounted) {
-		nandMounted = fatMountSimple("nand", &io_dsi_nand);
-	}
-
 	const char* pathDefine0 = *(u32*)0x02FFE1A0 == 0x080037C0 ? "DONORTWLONLY0_NDS_PATH" : "DONORTWL0_NDS_PATH"; // SDK5.0
 	const char* pathDefine = *(u32*)0x02FFE1A0 == 0x080037C0 ? "DONORTWLONLY_NDS_PATH" : "DONORTWL_NDS_PATH"; // SDK5.x
 
@@ -1493,33 +1501,20 @@ void setDSiDonorRomSCFGLocked(void) {
 	bool currentAppRead = false;
 	char tmdPath[64];
 	char appPath[64];
-	int appVer = 0;
-	TWLSettings::TRegion region = TWLSettings::ERegionJapan;
-	FILE *hwinfo_s = fopen("nand:/sys/HWINFO_S.dat", "rb");
-	fseek(hwinfo_s, 0x90, SEEK_SET);
-	region = (TWLSettings::TRegion)fgetc(hwinfo_s);
-	fclose(hwinfo_s);
-
-	if (donorRomPath0 != "" && access(donorRomPath0.c_str(), F_OK) != 0) {
+	u8 appVer = 0;
+	u8 region = TWLSettings::ERegionJapan;
+	nandFactRead("nand:/sys/HWINFO_S.dat", 0x90, &region, 1);
+
+	if (donorRomPath0 != "" && !donorRomExists(donorRomPath0)) {
 		donorRomPath0 = "";
 	}
 
 	if (donorRomPath0 == "") {
 		snprintf(tmdPath, sizeof(tmdPath), "nand:/title/%08lx/%08lx/content/title.tmd", srBackendId[1], srBackendId[0]);
-		FILE* donorTmd = fopen(tmdPath, "rb");
-		if (donorTmd) {
-			fseek(donorTmd, 0x1E7, SEEK_SET);
-			appVer = fgetc(donorTmd);
-			fclose(donorTmd);
-		}
+		nandFactRead(tmdPath, 0x1E7, &appVer, 1);
 
 		snprintf(appPath, sizeof(appPath), "nand:/title/%08lx/%08lx/content/0000000%i.app", srBackendId[1], srBackendId[0], appVer);
-		FILE* donorRom = fopen(appPath, "rb");
-		if (donorRom) {
-			fseek(donorRom, 0x3C, SEEK_SET);
-			fread(&donorArm7Len, sizeof(u32), 1, donorRom);
-			fclose(donorRom);
-		}
+		nandFactRead(appPath, 0x3C, &donorArm7Len, sizeof(u32));
 		currentAppRead = true;
 
 		bool validDonor = false;
@@ -1540,7 +1535,7 @@ void setDSiDonorRomSCFGLocked(void) {
 			bool validAppFound = false;
 			char validTmdPath[64];
 			char validAppPath[64];
-			int validAppVer = 0;
+			u8 validAppVer = 0;
 			u32 tid1 = 0;
 			u32 tid2 = 0;
 
@@ -1567,13 +1562,7 @@ void setDSiDonorRomSCFGLocked(void) {
 				}
 
 				snprintf(validTmdPath, sizeof(validTmdPath), "nand:/title/%08lx/%08lx/content/title.tmd", tid2, tid1);
-				FILE* donorTmd = fopen(validTmdPath, "rb");
-				if (donorTmd) {
-					fseek(donorTmd, 0x1E7, SEEK_SET);
-					validAppVer = fgetc(donorTmd);
-					fclose(donorTmd);
-					validAppFound = true;
-				}
+				validAppFound = nandFactRead(validTmdPath, 0x1E7, &validAppVer, 1);
 			} else for (int i = 0; i < 5; i++) {
 				tid2 = 0x00030004;
 				switch (i) {
@@ -1642,11 +1631,7 @@ void setDSiDonorRomSCFGLocked(void) {
 				}
 
 				snprintf(validTmdPath, sizeof(validTmdPath), "nand:/title/%08lx/%08lx/content/title.tmd", tid2, tid1);
-				FILE* donorTmd = fopen(validTmdPath, "rb");
-				if (donorTmd) {
-					fseek(donorTmd, 0x1E7, SEEK_SET);
-					validAppVer = fgetc(donorTmd);
-					fclose(donorTmd);
+				if (nandFactRead(validTmdPath, 0x1E7, &validAppVer, 1)) {
 					validAppFound = true;
 					break;
 				}
@@ -1664,27 +1649,17 @@ void setDSiDonorRomSCFGLocked(void) {
 		}
 	}
 
-	if (donorRomPath != "" && access(donorRomPath.c_str(), F_OK) != 0) {
+	if (donorRomPath != "" && !donorRomExists(donorRomPath)) {
 		donorRomPath = "";
 	}
 
 	if (donorRomPath == "") {
 		if (!currentAppRead) {
 			snprintf(tmdPath, sizeof(tmdPath), "nand:/title/%08lx/%08lx/content/title.tmd", srBackendId[1], srBackendId[0]);
-			FILE* donorTmd = fopen(tmdPath, "rb");
-			if (donorTmd) {
-				fseek(donorTmd, 0x1E7, SEEK_SET);
-				appVer = fgetc(donorTmd);
-				fclose(donorTmd);
-			}
+			nandFactRead(tmdPath, 0x1E7, &appVer, 1);
 
 			snprintf(appPath, sizeof(appPath), "nand:/title/%08lx/%08lx/content/0000000%i.app", srBackendId[1], srBackendId[0], appVer);
-			FILE* donorRom = fopen(appPath, "rb");
-			if (donorRom) {
-				fseek(donorRom, 0x3C, SEEK_SET);
-				fread(&donorArm7Len, sizeof(u32), 1, donorRom);
-				fclose(donorRom);
-			}
+			nandFactRead(appPath, 0x3C, &donorArm7Len, sizeof(u32));
 			currentAppRead = true;
 		}
 
@@ -2454,10 +2429,8 @@ int titleMode(void)
 				}
 			} else {
 				if (tidPart != 0x0003) {
-					if (!nandMounted) {
-						nandMounted = fatMountSimple("nand", &io_dsi_nand);
-					}
-					// Read correct title ID of launched System Menu title
+					nandFactsMount();
+					// Read correct title ID of launched System Menu title (not cached, as it's rewritten in place)
 					FILE* twlCfgFile = fopen("nand:/shared1/TWLCFG0.dat", "rb");
 					fseek(twlCfgFile, 0xB0, SEEK_SET);
 					fread(srBackendId, sizeof(u32), 2, twlCfgFile);
@@ -2507,44 +2480,34 @@ int titleMode(void)
 	ms().loadSettings();
 	bs().loadSettings();
 	logInit();
+	logPrint("Warm switch: %lu sector reads saved\n", (unsigned long)warmSwitchReadsSaved());
 
 	// Get SysNAND region and launcher app
 	if (isDSiMode() && sdFound() && !is3DS && (ms().sysRegion == TWLSettings::ERegionDefault || ms().launcherApp == -1)) {
 		bool hiyaFound = (access("sd:/hiya.dsi", F_OK) == 0 && !sys().arm7SCFGLocked()); // Check for hiyaCFW
 		if (!hiyaFound) {
 			// hiyaCFW is not found
-			if (!nandMounted) {
-				nandMounted = fatMountSimple("nand", &io_dsi_nand);
-			}
-
-			FILE *hwinfo_s = fopen("nand:/sys/HWINFO_S.dat", "rb");
-			if (hwinfo_s) {
+			u8 region = 0;
+			if (nandFactRead("nand:/sys/HWINFO_S.dat", 0x90, &region, 1)) {
 				if (ms().sysRegion == TWLSettings::ERegionDefault) {
-					fseek(hwinfo_s, 0x90, SEEK_SET);
-					ms().sysRegion = (TWLSettings::TRegion)fgetc(hwinfo_s);
+					ms().sysRegion = (TWLSettings::TRegion)region;
 				}
 
 				if (ms().launcherApp == -1) {
-					if (access("nand:/launcher.dsi", F_OK) == 0) {
+					u32 launcherTid;
+					if (nandFactExists("nand:/launcher.dsi")) {
 						// DSi Language Patcher
 						ms().launcherApp = 9;
-					} else {
-						fseek(hwinfo_s, 0xA0, SEEK_SET);
-						u32 launcherTid;
-						fread(&launcherTid, sizeof(u32), 1, hwinfo_s);
-
+					} else if (nandFactRead("nand:/sys/HWINFO_S.dat", 0xA0, &launcherTid, sizeof(u32))) {
 						char tmdPath[64];
 						snprintf(tmdPath, sizeof(tmdPath), "nand:/title/00030017/%08lx/content/title.tmd", launcherTid);
-						FILE *launcherTmd = fopen(tmdPath, "rb");
-						if (launcherTmd) {
-							fseek(launcherTmd, 0x1E7, SEEK_SET);
-							ms().launcherApp = fgetc(launcherTmd);
-							fclose(launcherTmd);
+						u8 launcherApp = 0;
+						if (nandFactRead(tmdPath, 0x1E7, &launcherApp, 1)) {
+							ms().launcherApp = launcherApp;
 						}
 					}
 				}
 
-				fclose(hwinfo_s);
 				ms().saveSettings();
 			}
 		}
@@ -2560,6 +2523,7 @@ int titleMode(void)
 			setDSiDonorRom(is3DS);
 		}
 	}
+	nandFactsSave();
 
 	{
 		char currentSettingPath[40];
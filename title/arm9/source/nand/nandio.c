@@ -48,6 +48,19 @@ void getConsoleID(u8 *consoleID){
 	tonccpy(&consoleID[4], &key_x[0xC], 4);
 }
 
+void getCID(u8 *cid){
+	if (*(u32*)(0x2FFD7BC) == 0) {
+		// Get eMMC CID
+		*(u32*)(0xCFFFD0C) = 0x454D4D43;
+		while (*(u32*)(0xCFFFD0C) != 0) {
+			swiDelay(100);
+		}
+	}
+	if (cid) {
+		tonccpy(cid, (u8*)0x2FFD7BC, 16);
+	}
+}
+
 //---------------------------------------------------------------------------------
 bool my_nand_ReadSectors(sec_t sector, sec_t numSectors,void* buffer) {
 //---------------------------------------------------------------------------------
@@ -93,13 +106,7 @@ bool nandio_startup() {
 	my_nand_ReadSectors(0, 1, sector_buf);
 	is3DS = parse_ncsd(sector_buf, 0) == 0;
 
-	if (*(u32*)(0x2FFD7BC) == 0) {
-		// Get eMMC CID
-		*(u32*)(0xCFFFD0C) = 0x454D4D43;
-		while (*(u32*)(0xCFFFD0C) != 0) {
-			swiDelay(100);
-		}
-	}
+	getCID(NULL);
 
 	u8 consoleID[8];
 	u8 consoleIDfixed[8];
@@ -3,6 +3,19 @@
 #include <nds.h>
 #include <nds/disc_io.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 void nandio_set_fat_sig_fix(u32 offset);
 
+// Console ID from the NAND key (8 bytes), and the eMMC CID (16 bytes), which
+// is requested from the ARM7 if the launcher didn't leave it in memory
+void getConsoleID(u8 *consoleID);
+void getCID(u8 *cid);
+
 extern const DISC_INTERFACE io_dsi_nand;
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,200 @@
+#include "nandFacts.h"
+
+#include <nds.h>
+#include <fat.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "fat_ext.h"
+#include "nand/nandio.h"
+#include "common/tonccpy.h"
+
+#define NAND_FACTS_PATH "sd:/_nds/TWiLightMenu/nandFacts.bin"
+#define NAND_FACTS_MAGIC 0x3243464E // 'NFC2'
+#define NAND_FACTS_MAX 24
+#define NAND_FACT_MAX_SIZE 8
+#define NAND_FACT_EXISTS 0xFFFFFFFF // Offset of a fact which only records that the file exists
+
+extern bool nandMounted;
+
+struct NandFact {
+	char path[64];
+	u32 offset;
+	u32 size;
+	u32 entrySector;
+	u32 entryOffset;
+	u8 entry[32];
+	u8 data[NAND_FACT_MAX_SIZE];
+};
+
+struct NandFactsHeader {
+	u32 magic;
+	u32 count;
+	u8 consoleID[8]; // Console the facts were read on, as a NAND restored
+	u8 cid[16];      // from another console can have the same entries
+};
+
+static NandFact facts[NAND_FACTS_MAX];
+static bool factChecked[NAND_FACTS_MAX]; // Entry already compared this boot
+static int factCount = 0;
+static bool factsLoaded = false;
+static bool factsChanged = false;
+static bool nandStarted = false;
+static u32 sectorBuf[512/sizeof(u32)];
+static NandFactsHeader console;
+
+static void loadFacts(void) {
+	factsLoaded = true;
+	getConsoleID(console.consoleID);
+	getCID(console.cid);
+
+	FILE* file = fopen(NAND_FACTS_PATH, "rb");
+	if (!file) {
+		return;
+	}
+
+	NandFactsHeader header;
+	if (fread(&header, 1, sizeof(header), file) == sizeof(header)
+	 && header.magic == NAND_FACTS_MAGIC && header.count <= NAND_FACTS_MAX
+	 && memcmp(header.consoleID, console.consoleID, sizeof(header.consoleID)) == 0
+	 && memcmp(header.cid, console.cid, sizeof(header.cid)) == 0
+	 && fread(facts, sizeof(NandFact), header.count, file) == header.count) {
+		factCount = header.count;
+	}
+	fclose(file);
+}
+
+static NandFact* findFact(const char* path, u32 offset, u32 size) {
+	if (!factsLoaded) {
+		loadFacts();
+	}
+	for (int i = 0; i < factCount; i++) {
+		if (facts[i].offset == offset && facts[i].size == size && strcmp(facts[i].path, path) == 0) {
+			return &facts[i];
+		}
+	}
+	return NULL;
+}
+
+static void removeFact(NandFact* fact) {
+	const int i = fact - facts;
+	memmove(&facts[i], &facts[i + 1], (factCount - i - 1) * sizeof(NandFact));
+	memmove(&factChecked[i], &factChecked[i + 1], (factCount - i - 1) * sizeof(bool));
+	factCount--;
+	factsChanged = true;
+}
+
+// Check the fact's source against its directory entry, without mounting NAND
+static bool factValid(NandFact* fact) {
+	const int i = fact - facts;
+	if (factChecked[i]) {
+		return true;
+	}
+
+	if (!nandStarted) {
+		nandStarted = nandMounted || io_dsi_nand.startup();
+	}
+	if (!nandStarted || !io_dsi_nand.readSectors(fact->entrySector, 1, sectorBuf)) {
+		return false;
+	}
+
+	// Skip the last access date
+	const u8* entry = (u8*)sectorBuf + fact->entryOffset;
+	if (memcmp(entry, fact->entry, 0x12) != 0 || memcmp(entry + 0x14, fact->entry + 0x14, 0x20 - 0x14) != 0) {
+		removeFact(fact);
+		return false;
+	}
+	factChecked[i] = true;
+	return true;
+}
+
+static void storeFact(const char* path, u32 offset, const void* data, u32 size) {
+	NandFact fact;
+	toncset(&fact, 0, sizeof(fact));
+	sec_t sector = 0;
+	if (strlen(path) >= sizeof(fact.path) || !fatGetEntryLocation(path, &sector, &fact.entryOffset, fact.entry)) {
+		return;
+	}
+	strcpy(fact.path, path);
+	fact.offset = offset;
+	fact.size = size;
+	fact.entrySector = sector;
+	if (size > 0) {
+		tonccpy(fact.data, data, size);
+	}
+
+	if (factCount == NAND_FACTS_MAX) {
+		removeFact(&facts[0]); // Drop the oldest
+	}
+	facts[factCount] = fact;
+	factChecked[factCount] = true;
+	factCount++;
+	factsChanged = true;
+}
+
+bool nandFactsMount(void) {
+	if (!nandMounted) {
+		nandMounted = fatMountSimple("nand", &io_dsi_nand);
+	}
+	return nandMounted;
+}
+
+bool nandFactRead(const char* path, u32 offset, void* buffer, u32 size) {
+	if (size <= NAND_FACT_MAX_SIZE) {
+		NandFact* fact = findFact(path, offset, size);
+		if (fact && factValid(fact)) {
+			tonccpy(buffer, fact->data, size);
+			return true;
+		}
+	}
+
+	// Missing or stale, read it from NAND
+	if (!nandFactsMount()) {
+		return false;
+	}
+	FILE* file = fopen(path, "rb");
+	if (!file) {
+		return false;
+	}
+	fseek(file, offset, SEEK_SET);
+	const bool ok = (fread(buffer, 1, size, file) == size);
+	fclose(file);
+
+	if (ok && size <= NAND_FACT_MAX_SIZE) {
+		storeFact(path, offset, buffer, size);
+	}
+	return ok;
+}
+
+bool nandFactExists(const char* path) {
+	NandFact* fact = findFact(path, NAND_FACT_EXISTS, 0);
+	if (fact && factValid(fact)) {
+		return true;
+	}
+
+	// Missing files aren't cached, as there's no entry to check them against
+	if (!nandFactsMount() || access(path, F_OK) != 0) {
+		return false;
+	}
+	storeFact(path, NAND_FACT_EXISTS, NULL, 0);
+	return true;
+}
+
+void nandFactsSave(void) {
+	if (!factsChanged) {
+		return;
+	}
+
+	FILE* file = fopen(NAND_FACTS_PATH, "wb");
+	if (!file) {
+		return;
+	}
+	NandFactsHeader header = console;
+	header.magic = NAND_FACTS_MAGIC;
+	header.count = factCount;
+	fwrite(&header, 1, sizeof(header), file);
+	fwrite(facts, sizeof(NandFact), factCount, file);
+	fclose(file);
+	factsChanged = false;
+}
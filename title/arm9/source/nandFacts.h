@@ -0,0 +1,31 @@
+#ifndef NAND_FACTS_H
+#define NAND_FACTS_H
+
+#include <nds/ndstypes.h>
+
+/**
+ * Read part of a file on NAND, such as the region in HWINFO_S.dat or the
+ * app version in a title's TMD. The result is cached on the SD card along
+ * with the file's directory entry, and used again on later boots as long
+ * as that entry is unchanged, which only needs a single sector read
+ * instead of mounting NAND. The whole cache is dropped if the console ID
+ * or eMMC CID differs from the console it was written on.
+ */
+bool nandFactRead(const char* path, u32 offset, void* buffer, u32 size);
+
+/**
+ * Check if a file exists on NAND, such as a donor ROM's .app.
+ */
+bool nandFactExists(const char* path);
+
+/**
+ * Mount NAND, if not mounted already.
+ */
+bool nandFactsMount(void);
+
+/**
+ * Write the cache back to the SD card, if anything changed.
+ */
+void nandFactsSave(void);
+
+#endif // NAND_FACTS_H
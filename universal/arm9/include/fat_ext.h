@@ -6,6 +6,7 @@ extern "C" {
 #endif
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #include <nds/disc_io.h>
 
@@ -19,6 +20,12 @@ Get Alias Path
 */
 extern void fatGetAliasPath (const char* drive, const char* path, char *alias);
 
+/*
+Get the absolute sector and byte offset of a file's directory entry,
+and the entry itself (32 bytes)
+*/
+extern bool fatGetEntryLocation (const char* path, sec_t* sector, u32* offset, u8* entryData);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,30 @@
+#ifndef _FOLDER_INDEX_H
+#define _FOLDER_INDEX_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+
+/*
+Check if a file exists, using a hashed index of the names in its folder
+instead of a linear scan of the directory. The index is built on the
+first lookup in a folder and revalidated against the directory's cluster
+chain and last cluster at most once a second. Names match like in libfat,
+case insensitive with towlower.
+*/
+extern bool folderIndexExists (const char* path);
+
+/*
+Keep the index current after the menu itself creates, deletes or renames
+a file. Relative paths are taken from the working directory.
+*/
+extern void folderIndexNoteAdded (const char* path);
+extern void folderIndexNoteRemoved (const char* path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _FOLDER_INDEX_H
@@ -0,0 +1,298 @@
+#include <sys/stat.h>
+#include <dirent.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <wchar.h>
+#include <wctype.h>
+#include <time.h>
+
+#include "partition.h"
+#include "cache.h"
+#include "folderIndex.h"
+
+#define CLUSTER_EOF		0x0FFFFFFF
+#define CLUSTER_FIRST	0x00000002
+
+#define FOLDER_INDEX_SLOTS	8
+#define HASH_EMPTY		0
+#define HASH_DELETED	1
+
+// libfat internal
+extern uint32_t _FAT_fat_nextCluster (PARTITION* partition, uint32_t cluster);
+
+typedef struct {
+	u32 cluster;		// First cluster of the directory
+	u32 chainLength;
+	u32 tailHash;		// Contents of the last cluster, see tailHash()
+} FolderSignature;
+
+typedef struct {
+	char folder[96];
+	bool exists;		// The folder itself was found
+	FolderSignature signature;	// When the index was last validated
+	time_t validated;
+	u32* hashes;		// Open addressing, sized to a power of 2
+	u32 mask;
+	u32 count;			// Used slots, including deleted ones
+} FolderIndex;
+
+static FolderIndex indexes[FOLDER_INDEX_SLOTS];
+static int nextSlot = 0;
+
+static u32 nameHash (const char* name, int len) {
+	// FNV-1a over the characters folded with towlower, which is how libfat
+	// matches long names, so non-ASCII names differing in case are one file
+	// here as well. Sorting in the browser only folds ASCII, but it doesn't
+	// decide whether a file exists.
+	mbstate_t state;
+	memset(&state, 0, sizeof(state));
+	u32 hash = 2166136261u;
+	for (int i = 0; i < len; ) {
+		wchar_t wc;
+		size_t bytes = mbrtowc(&wc, name + i, len - i, &state);
+		if (bytes == 0 || bytes > (size_t)(len - i)) {
+			// Not a valid sequence, take the byte as is
+			wc = (u8)name[i];
+			bytes = 1;
+			memset(&state, 0, sizeof(state));
+		}
+		hash = (hash ^ (u32)towlower(wc)) * 16777619u;
+		i += bytes;
+	}
+	return (hash < 2) ? hash + 2 : hash;
+}
+
+// Relative paths are taken from the working directory, like libfat does
+static const char* absolutePath (const char* path, char* buffer, size_t size) {
+	if (strchr(path, ':') || !getcwd(buffer, size)) {
+		return path;
+	}
+	size_t len = strlen(buffer);
+	if (path[0] == '/') {
+		const char* colon = strchr(buffer, ':');
+		len = colon ? (size_t)(colon + 1 - buffer) : 0;
+	} else if (len > 0 && buffer[len - 1] != '/') {
+		buffer[len++] = '/';
+	}
+	if ((size_t)snprintf(buffer + len, size - len, "%s", path) >= size - len) {
+		return path;
+	}
+	return buffer;
+}
+
+static bool tableFind (const FolderIndex* index, u32 hash, u32* pos) {
+	for (u32 i = hash & index->mask; ; i = (i + 1) & index->mask) {
+		if (index->hashes[i] == hash) {
+			*pos = i;
+			return true;
+		}
+		if (index->hashes[i] == HASH_EMPTY) {
+			*pos = i;
+			return false;
+		}
+	}
+}
+
+static bool tableInsert (FolderIndex* index, u32 hash) {
+	if ((index->count + 1) * 2 > index->mask + 1) {
+		// Keep the load under 1/2
+		const u32 newSize = (index->mask + 1) * 2;
+		u32* newHashes = (u32*)calloc(newSize, sizeof(u32));
+		if (!newHashes) {
+			return false;
+		}
+		u32* oldHashes = index->hashes;
+		const u32 oldSize = index->mask + 1;
+		index->hashes = newHashes;
+		index->mask = newSize - 1;
+		index->count = 0;
+		for (u32 i = 0; i < oldSize; i++) {
+			if (oldHashes[i] > HASH_DELETED) {
+				tableInsert(index, oldHashes[i]);
+			}
+		}
+		free(oldHashes);
+	}
+
+	u32 pos;
+	if (!tableFind(index, hash, &pos)) {
+		index->hashes[pos] = hash;
+		index->count++;
+	}
+	return true;
+}
+
+/*
+Hash of the directory's last cluster, up to the sector with the end of
+directory marker. A file added to a directory doesn't always grow its
+cluster chain, but it's written after the last entry or in the gap left by
+a deleted one, and that is usually in the last cluster. The sectors come
+from libfat's cache, which the directory was just read through.
+*/
+static u32 tailHash (PARTITION* partition, u32 lastCluster) {
+	sec_t sector;
+	u32 sectors;
+	if (lastCluster < CLUSTER_FIRST) {
+		// FAT12/16 root directory, which is before the data area
+		sector = partition->rootDirStart;
+		sectors = partition->dataStart - partition->rootDirStart;
+	} else {
+		sector = (lastCluster - CLUSTER_FIRST) * partition->sectorsPerCluster + partition->dataStart;
+		sectors = partition->sectorsPerCluster;
+	}
+
+	u8* buffer = (u8*)malloc(partition->bytesPerSector);
+	if (!buffer) {
+		return 0;
+	}
+	u32 hash = 2166136261u;
+	bool end = false;
+	for (u32 i = 0; i < sectors && !end; i++) {
+		if (!_FAT_cache_readSector(partition->cache, buffer, sector + i)) {
+			break;
+		}
+		for (u32 j = 0; j < partition->bytesPerSector; j++) {
+			hash = (hash ^ buffer[j]) * 16777619u;
+			if ((j % 32) == 0 && buffer[j] == 0) {
+				end = true;
+			}
+		}
+	}
+	free(buffer);
+	return hash;
+}
+
+static bool folderSignature (const char* folder, FolderSignature* signature) {
+	struct stat st;
+	if (stat(folder, &st) != 0 || !S_ISDIR(st.st_mode)) {
+		return false;
+	}
+
+	signature->cluster = st.st_ino;
+	signature->chainLength = 0;
+	signature->tailHash = 0;
+	PARTITION* partition = _FAT_partition_getPartitionFromPath(folder);
+	if (partition) {
+		u32 last = st.st_ino;
+		for (u32 c = st.st_ino; c >= CLUSTER_FIRST && c < CLUSTER_EOF && signature->chainLength < 0x10000; signature->chainLength++) {
+			last = c;
+			c = _FAT_fat_nextCluster(partition, c);
+		}
+		signature->tailHash = tailHash(partition, last);
+	}
+	return true;
+}
+
+static void buildIndex (FolderIndex* index) {
+	free(index->hashes);
+	index->hashes = (u32*)calloc(256, sizeof(u32));
+	index->mask = index->hashes ? 255 : 0;
+	index->count = 0;
+	index->validated = time(NULL);
+	index->exists = folderSignature(index->folder, &index->signature);
+	if (!index->exists || !index->hashes) {
+		return;
+	}
+
+	DIR* dir = opendir(index->folder);
+	if (!dir) {
+		index->exists = false;
+		return;
+	}
+	struct dirent* entry;
+	while ((entry = readdir(dir)) != NULL) {
+		if (!tableInsert(index, nameHash(entry->d_name, strlen(entry->d_name)))) {
+			// Out of memory, fall back to plain lookups for this folder
+			free(index->hashes);
+			index->hashes = NULL;
+			break;
+		}
+	}
+	closedir(dir);
+}
+
+static FolderIndex* getIndex (const char* path, const char** name, bool create) {
+	const char* slash = strrchr(path, '/');
+	if (!slash || (size_t)(slash - path) >= sizeof(indexes[0].folder)) {
+		return NULL;
+	}
+	const int folderLen = slash - path;
+	*name = slash + 1;
+
+	for (int i = 0; i < FOLDER_INDEX_SLOTS; i++) {
+		if (indexes[i].folder[0] && strncasecmp(indexes[i].folder, path, folderLen) == 0 && indexes[i].folder[folderLen] == 0) {
+			return &indexes[i];
+		}
+	}
+	if (!create) {
+		return NULL;
+	}
+
+	FolderIndex* index = &indexes[nextSlot];
+	nextSlot = (nextSlot + 1) % FOLDER_INDEX_SLOTS;
+	memcpy(index->folder, path, folderLen);
+	index->folder[folderLen] = 0;
+	buildIndex(index);
+	return index;
+}
+
+bool folderIndexExists (const char* path) {
+	char buffer[256];
+	path = absolutePath(path, buffer, sizeof(buffer));
+	const char* name;
+	FolderIndex* index = getIndex(path, &name, true);
+	if (!index || !index->hashes) {
+		struct stat st;
+		return (stat(path, &st) == 0);
+	}
+
+	if (time(NULL) != index->validated) {
+		// Rebuild if the folder was replaced or its directory changed
+		FolderSignature signature = {0, 0, 0};
+		const bool exists = folderSignature(index->folder, &signature);
+		if (exists != index->exists || signature.cluster != index->signature.cluster
+		 || signature.chainLength != index->signature.chainLength || signature.tailHash != index->signature.tailHash) {
+			buildIndex(index);
+			if (!index->hashes) {
+				struct stat st;
+				return (stat(path, &st) == 0);
+			}
+		}
+		index->validated = time(NULL);
+	}
+
+	u32 pos;
+	return index->exists && tableFind(index, nameHash(name, strlen(name)), &pos);
+}
+
+void folderIndexNoteAdded (const char* path) {
+	char buffer[256];
+	path = absolutePath(path, buffer, sizeof(buffer));
+	const char* name;
+	FolderIndex* index = getIndex(path, &name, false);
+	if (!index || !index->hashes) {
+		return;
+	}
+	if (!tableInsert(index, nameHash(name, strlen(name)))) {
+		free(index->hashes);
+		index->hashes = NULL;
+		return;
+	}
+	// The new entry changed the directory
+	index->exists = folderSignature(index->folder, &index->signature);
+}
+
+void folderIndexNoteRemoved (const char* path) {
+	char buffer[256];
+	path = absolutePath(path, buffer, sizeof(buffer));
+	const char* name;
+	FolderIndex* index = getIndex(path, &name, false);
+	u32 pos;
+	if (index && index->hashes && tableFind(index, nameHash(name, strlen(name)), &pos)) {
+		index->hashes[pos] = HASH_DELETED;	// Still counted until the next rehash
+		index->exists = folderSignature(index->folder, &index->signature);
+	}
+}
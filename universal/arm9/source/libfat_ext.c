@@ -21,6 +21,8 @@ static inline void _FAT_mem_free (void* mem) {
 #include "partition.h"
 #include "common/tonccpy.h"
 
+#define CLUSTER_FIRST	0x00000002
+
 //static int timesRan = 0;
 
 static int fatGetAlias (const char* drive, const char* name, const char* nameEnd, char *alias) {
@@ -137,3 +139,23 @@ void fatGetAliasPath (const char* drive, const char* path, char *alias) {
 
 	chdir(dirBak);
 }
+
+bool fatGetEntryLocation (const char* path, sec_t* sector, u32* offset, u8* entryData) {
+	devoptab_t *devops = (devoptab_t*)GetDeviceOpTab(path);
+	if (!devops) {
+		return false;
+	}
+
+	PARTITION* partition = (PARTITION*)devops->deviceData;
+	DIR_ENTRY entry;
+	if (!_FAT_directory_entryFromPath(partition, &entry, path, NULL)) {
+		return false;
+	}
+
+	// The alias entry holds the size, cluster and timestamps
+	const uint32_t cluster = entry.dataEnd.cluster;
+	*sector = ((cluster >= CLUSTER_FIRST) ? ((cluster - CLUSTER_FIRST) * partition->sectorsPerCluster) + partition->dataStart : partition->rootDirStart) + entry.dataEnd.sector;
+	*offset = entry.dataEnd.offset * DIR_ENTRY_DATA_SIZE;
+	tonccpy(entryData, entry.entryData, DIR_ENTRY_DATA_SIZE);
+	return true;
+}
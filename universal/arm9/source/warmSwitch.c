@@ -0,0 +1,130 @@
+#include <nds.h>
+#include <nds/arm9/dldi.h>
+#include <string.h>
+#include <strings.h>
+
+#include "partition.h"
+#include "common/tonccpy.h"
+#include "common/warmSwitch.h"
+
+#define CLUSTER_FREE	0x00000000
+#define CLUSTER_EOF		0x0FFFFFFF
+#define CLUSTER_FIRST	0x00000002
+
+// libfat internal
+extern uint32_t _FAT_fat_nextCluster(PARTITION* partition, uint32_t cluster);
+
+static u32 readsSaved = 0;
+
+static PARTITION* warmSwitchPartition(u8 drive) {
+	return _FAT_partition_getPartitionFromPath(drive == WARM_SWITCH_DRIVE_SD ? "sd:/" : "fat:/");
+}
+
+/*
+	Only TWiLight Menu++ modules pick up the free cluster hint, and
+	anything else may write to the volume before coming back.
+*/
+static bool isMenuModule(const char* filename) {
+	const char* ext = strrchr(filename, '.');
+	return (ext && strcasecmp(ext, ".srldr") == 0 && strstr(filename, "/_nds/TWiLightMenu/") != NULL);
+}
+
+bool warmSwitchPrepare(const char* filename, u32 fileCluster) {
+	WarmSwitchBlock* block = (WarmSwitchBlock*)WARM_SWITCH_ADDR;
+	warmSwitchClear();
+	DC_FlushRange(block, 32);
+
+	PARTITION* partition = _FAT_partition_getPartitionFromPath(filename);
+	if (!partition || partition->bytesPerSector != 512
+	 || fileCluster < CLUSTER_FIRST || fileCluster >= CLUSTER_EOF) {
+		return false;
+	}
+
+	u8 drive;
+	if (partition == warmSwitchPartition(WARM_SWITCH_DRIVE_SD)) {
+		drive = WARM_SWITCH_DRIVE_SD;
+	} else if (partition->disc->ioType == dldiGetInternal()->ioType) {
+		drive = WARM_SWITCH_DRIVE_FAT;
+	} else {
+		// fat: is backed by the SD card (CycloDS iEvolution in DSi mode),
+		// which the bootloader won't read through DLDI
+		return false;
+	}
+
+	WarmSwitchBlock snapshot;
+	toncset(&snapshot, 0, sizeof(snapshot));
+
+	// Collapse the cluster chain into runs
+	u32 cluster = fileCluster;
+	while (cluster >= CLUSTER_FIRST && cluster < CLUSTER_EOF) {
+		WarmSwitchRun* run = &snapshot.runs[snapshot.runCount];
+		if (snapshot.runCount > 0 && run[-1].cluster + run[-1].length == cluster) {
+			run[-1].length++;
+		} else {
+			if (snapshot.runCount == WARM_SWITCH_MAX_RUNS) {
+				return false;	// Too fragmented, leave it to the bootloader
+			}
+			run->cluster = cluster;
+			run->length = 1;
+			snapshot.runCount++;
+		}
+		cluster = _FAT_fat_nextCluster(partition, cluster);
+	}
+	if (cluster != CLUSTER_EOF) {
+		return false;	// Broken chain
+	}
+
+	snapshot.magic = WARM_SWITCH_MAGIC;
+	snapshot.size = sizeof(WarmSwitchBlock);
+	snapshot.drive = drive;
+	snapshot.fileSystem = partition->filesysType;
+	snapshot.fatStart = partition->fat.fatStart;
+	snapshot.sectorsPerFat = partition->fat.sectorsPerFat;
+	snapshot.rootDirStart = partition->rootDirStart;
+	snapshot.rootDirCluster = partition->rootDirCluster;
+	snapshot.dataStart = partition->dataStart;
+	snapshot.numberOfSectors = partition->numberOfSectors;
+	snapshot.sectorsPerCluster = partition->sectorsPerCluster;
+	snapshot.lastCluster = partition->fat.lastCluster;
+	if (isMenuModule(filename)) {
+		snapshot.firstFree = partition->fat.firstFree;
+		snapshot.numberFreeCluster = partition->fat.numberFreeCluster;
+	}
+	snapshot.fileCluster = fileCluster;
+	snapshot.checksum = warmSwitchChecksum(&snapshot);
+
+	tonccpy(block, &snapshot, sizeof(WarmSwitchBlock));
+	DC_FlushRange(block, sizeof(WarmSwitchBlock));
+	return true;
+}
+
+bool warmSwitchApply(void) {
+	WarmSwitchBlock* block = (WarmSwitchBlock*)WARM_SWITCH_ADDR;
+	DC_InvalidateRange(block, sizeof(WarmSwitchBlock));
+	if (!warmSwitchValid(block)) {
+		return false;
+	}
+
+	PARTITION* partition = warmSwitchPartition(block->drive);
+	if (partition && block->numberFreeCluster != 0
+	 && partition->filesysType == block->fileSystem
+	 && partition->fat.fatStart == block->fatStart
+	 && partition->dataStart == block->dataStart
+	 && partition->numberOfSectors == block->numberOfSectors
+	 && partition->sectorsPerCluster == block->sectorsPerCluster
+	 && partition->fat.lastCluster == block->lastCluster) {
+		// The FSInfo sector isn't rewritten between modules, so the previous
+		// module's in-memory hint is newer than what was just mounted
+		partition->fat.firstFree = block->firstFree;
+		partition->fat.numberFreeCluster = block->numberFreeCluster;
+	}
+	readsSaved = block->sectorReadsSaved;
+
+	warmSwitchClear();
+	DC_FlushRange(block, 32);
+	return true;
+}
+
+u32 warmSwitchReadsSaved(void) {
+	return readsSaved;
+}
@@ -202,6 +202,12 @@ enum {FS_UNKNOWN, FS_FAT12, FS_FAT16, FS_FAT32} discFileSystem;
 // Global sector buffer to save on stack space
 unsigned char globalBuffer[BYTES_PER_SECTOR];
 
+// Cluster runs of the file being loaded, passed on by the previous module
+static WarmSwitchRun warmRuns[WARM_SWITCH_MAX_RUNS];
+static u32 warmRunCount = 0;
+static u32 warmRunCur = 0;
+static u32 warmReadsSaved = 0;
+
 
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 //FAT routines
@@ -220,6 +226,18 @@ u32 FAT_NextCluster(u32 cluster)
 	u32 sector;
 	int offset;
 	
+	// Look the cluster up in the known runs first, starting from the last one used
+	for (u32 i = 0; i < warmRunCount; i++) {
+		const u32 r = (warmRunCur + i) % warmRunCount;
+		if (cluster >= warmRuns[r].cluster && cluster < warmRuns[r].cluster + warmRuns[r].length) {
+			warmRunCur = r;
+			warmReadsSaved += (discFileSystem == FS_FAT12) ? 2 : 1;
+			if (cluster + 1 < warmRuns[r].cluster + warmRuns[r].length) {
+				return cluster + 1;
+			}
+			return (r + 1 < warmRunCount) ? warmRuns[r + 1].cluster : CLUSTER_EOF;
+		}
+	}
 	
 	switch (discFileSystem) 
 	{
@@ -388,6 +406,49 @@ bool FAT_InitFiles (bool initCard)
 }
 
 
+/*-----------------------------------------------------------------
+FAT_InitFromWarmSwitch
+Sets up the FAT information from the block left by the previous
+module, instead of reading the MBR and boot sector.
+bool return OUT: true if successful.
+-----------------------------------------------------------------*/
+bool FAT_InitFromWarmSwitch (bool initCard, const WarmSwitchBlock* block)
+{
+	if (initCard && !CARD_StartUp()) {
+		return (false);
+	}
+
+	if (block->fileSystem < FS_FAT12 || block->fileSystem > FS_FAT32 || block->sectorsPerCluster == 0) {
+		return (false);
+	}
+
+	discFileSystem = block->fileSystem;
+	discFAT = block->fatStart;
+	discSecPerFAT = block->sectorsPerFat;
+	discRootDir = block->rootDirStart;
+	discRootDirClus = (discFileSystem == FS_FAT32) ? block->rootDirCluster : FAT16_ROOT_DIR_CLUSTER;
+	discData = block->dataStart;
+	discNumSec = block->numberOfSectors;
+	discBytePerSec = BYTES_PER_SECTOR;
+	discSecPerClus = block->sectorsPerCluster;
+	discBytePerClus = discBytePerSec * discSecPerClus;
+
+	// Copy the runs, as main RAM gets cleared before the file is loaded
+	for (warmRunCount = 0; warmRunCount < block->runCount; warmRunCount++) {
+		warmRuns[warmRunCount] = block->runs[warmRunCount];
+	}
+	warmRunCur = 0;
+	warmReadsSaved = 2;	// MBR and boot sector
+
+	return (true);
+}
+
+u32 FAT_WarmSwitchReadsSaved (void)
+{
+	return warmReadsSaved;
+}
+
+
 /*-----------------------------------------------------------------
 getBootFileCluster
 -----------------------------------------------------------------*/
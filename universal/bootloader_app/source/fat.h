@@ -33,12 +33,15 @@ License:
 #define FAT_H
 
 #include <nds/ndstypes.h>
+#include "common/warmSwitch.h"
 
 #define CLUSTER_FREE	0x00000000
 #define	CLUSTER_EOF		0x0FFFFFFF
 #define CLUSTER_FIRST	0x00000002
 
 bool FAT_InitFiles (bool initCard);
+bool FAT_InitFromWarmSwitch (bool initCard, const WarmSwitchBlock* block);
+u32 FAT_WarmSwitchReadsSaved (void);
 u32 getBootFileCluster (const char* bootName);
 u32 fileRead (char* buffer, u32 cluster, u32 startOffset, u32 length);
 u32 FAT_ClustToSect (u32 cluster);
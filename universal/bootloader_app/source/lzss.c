@@ -25,3 +25,34 @@ void LZ77_Decompress(u8* source, u8* destination) {
 		}
 	}
 }
+
+// Decompress a packed .srldr binary (see common/srldrPack.h). The source may
+// be placed at the end of the destination, to decompress in place.
+void LZ77_DecompressPacked(const u8* source, u32 packedLen, u8* destination) {
+	u32 streamLen = (source[0] | (source[1] << 8) | (source[2] << 16));
+	const u8* src = source + 4 + source[3];
+	const u8* tail = src + streamLen;
+	u8* dst = destination;
+	while (src < tail) {
+		u8 header = *src++;
+		for (int i = 0; i < 8 && src < tail; i++) {
+			if ((header & 0x80) == 0) *dst++ = *src++;
+			else
+			{
+				u8 a = *src++;
+				u8 b = *src++;
+				int offs = (((a & 0xF) << 8) | b) + 1;
+				int length = (a >> 4) + 3;
+				for (int j = 0; j < length; j++) {
+					*dst = *(dst - offs);
+					dst++;
+				}
+			}
+			header <<= 1;
+		}
+	}
+	// In place, the tail is already where it belongs
+	if (dst != tail) {
+		memcpy(dst, tail, (source + packedLen) - tail);
+	}
+}
@@ -0,0 +1,77 @@
+#ifndef BLOCK_ROM_H
+#define BLOCK_ROM_H
+
+#include <nds/ndstypes.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BLOCK_ROM_MAGIC 0x525A4C42 // 'BLZR'
+#define BLOCK_ROM_HEADER_SIZE 0xC0
+#define BLOCK_ROM_CODEC_LZ77 0x10  // As used by the DS BIOS
+#define BLOCK_ROM_FLAG_CRC BIT(0)  // Chunks have a CRC16 of their uncompressed data
+#define BLOCK_ROM_STORED BIT(31)   // Chunk isn't compressed
+#define BLOCK_ROM_START_ERROR 20   // "Start failed" error for a block ROM which can't be read or launched
+
+/*
+	A ROM split into independently compressed chunks, with an index so it
+	can be read from any offset. Made by resources/blockrom.py.
+
+	Header (0xC0 bytes, little endian):
+	  0x00 'BLZR', u16 version (1), u8 codec, u8 flags
+	  0x08 u32 chunk size, u32 ROM size, u32 chunk count, u32 index offset
+	  0xA0 Copy of the ROM's header bytes 0xA0-0xBF, so the title and game
+	       code of a GBA ROM are where the menu expects them
+	Index: u32 offset, u32 compressed size (BLOCK_ROM_STORED if stored),
+	       u32 CRC16, per chunk
+*/
+typedef struct BlockRomChunk {
+	u32 offset;
+	u32 size;
+	u32 crc;
+} BlockRomChunk;
+
+typedef struct BlockRom {
+	FILE* file;
+	bool compressed;   // false to read the file as it is
+	u32 romSize;
+	u32 position;
+	u32 chunkSize;
+	u32 chunkCount;
+	u32 flags;
+	BlockRomChunk* index;
+	u8* packed;
+	u8* chunk;
+	u32 cachedChunk;   // Chunk currently in chunk, or 0xFFFFFFFF
+	u32 bytesRead;     // From the file, for comparing against romSize
+} BlockRom;
+
+/*
+Start reading a ROM from file, which may or may not be a block ROM, and
+set romSize to its uncompressed size. Returns false (with romSize set
+to 0) if file is NULL, a block ROM's index can't be read, or there isn't
+enough memory for it. blockRomClose is safe to call either way.
+*/
+bool blockRomOpen(BlockRom* rom, FILE* file);
+
+/*
+Check if the file at path is a block ROM. Only the native GBA path reads
+them, so launchers which open the ROM themselves should reject it.
+*/
+bool blockRomIsPacked(const char* path);
+
+// Read the next size bytes of the uncompressed ROM. Returns the number of bytes read.
+u32 blockRomRead(BlockRom* rom, void* buffer, u32 size);
+
+void blockRomSeek(BlockRom* rom, u32 position);
+
+// Free the buffers. The file is left open.
+void blockRomClose(BlockRom* rom);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BLOCK_ROM_H
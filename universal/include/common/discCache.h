@@ -0,0 +1,73 @@
+#ifndef DISC_CACHE_H
+#define DISC_CACHE_H
+
+#include <nds/ndstypes.h>
+#include <nds/disc_io.h>
+#include <nds/fifocommon.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DISC_CACHE_SECTORS_PER_BLOCK 8 // 4KB blocks
+#define DISC_CACHE_MAX_WRAPPERS 2      // sd: and fat:
+
+// The ARM7 sends DISC_CACHE_FLUSH_REQUEST before it powers off, and the
+// ARM9 sends it back once everything held back is written
+#define DISC_CACHE_FIFO FIFO_USER_06
+#define DISC_CACHE_FLUSH_REQUEST 0x48534C46 // 'FLSH'
+
+typedef struct DiscCacheStats {
+	u32 reads;           // readSectors calls
+	u32 hits;            // blocks served from the cache
+	u32 misses;          // blocks fetched from the disc
+	u32 readAheads;      // blocks prefetched by the sequential detector
+	u32 bypassReads;     // large reads sent straight to the disc
+	u32 writes;          // writeSectors calls
+	u32 writesAbsorbed;  // writes merged into an already dirty block
+	u32 writesThrough;   // FAT/root dir writes sent straight to the disc
+	u32 blocksFlushed;   // dirty blocks written back
+	u32 pinnedBlocks;    // blocks currently pinned (FAT/root dir)
+} DiscCacheStats;
+
+/*
+Wrap a disc interface with a block cache of (at most) cacheSize bytes.
+Returns the base interface unchanged if no wrapper slot or memory is free.
+*/
+const DISC_INTERFACE* discCacheWrap(const DISC_INTERFACE* base, u32 cacheSize);
+
+// Write back all dirty blocks of every wrapper
+void discCacheFlushAll(void);
+
+/*
+Flush after each file operation of a mounted libfat device which can
+leave blocks behind: close, fsync, unlink, rename, mkdir and rmdir.
+*/
+void discCacheHookDevice(const char* name);
+
+// Drop all cached blocks of every wrapper (dirty blocks are written back first)
+void discCacheInvalidateAll(void);
+
+// Returns false if disc is not a cache wrapper
+bool discCacheGetStats(const DISC_INTERFACE* disc, DiscCacheStats* stats);
+
+// The interface a wrapper reads from, or disc itself if it's not a wrapper
+const DISC_INTERFACE* discCacheBase(const DISC_INTERFACE* disc);
+
+#ifdef ARM7
+#include <nds/bios.h>
+
+// Ask the ARM9 to write back its cache before powering off, for up to a second
+static inline void discCacheRequestFlush(void) {
+	fifoSendValue32(DISC_CACHE_FIFO, DISC_CACHE_FLUSH_REQUEST);
+	for (int i = 0; i < 60 && !fifoCheckValue32(DISC_CACHE_FIFO); i++) {
+		swiWaitForVBlank();
+	}
+}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DISC_CACHE_H
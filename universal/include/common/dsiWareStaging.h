@@ -0,0 +1,49 @@
+#ifndef DSIWARE_STAGING_H
+#define DSIWARE_STAGING_H
+
+#include <nds/ndstypes.h>
+
+struct DSiWareStagingStats {
+	u32 bytesRead;
+	u32 bytesWritten;
+};
+
+enum DSiWareStageResult {
+	EStageFailed = -1,
+	EStageUpToDate = 0,	// Staged copy already matches, nothing written
+	EStageCopied = 1,
+};
+
+/**
+ * Copy a DSiWare SRL from the flashcard to the SD card, unless the staged
+ * copy was made from the same file. The source is fingerprinted by its
+ * size, first cluster, timestamp and header CRC, which is kept next to the
+ * staged copy (with a .fp extension).
+ */
+DSiWareStageResult dsiWareStageSrl(const char* srlPath, const char* stagedPath, DSiWareStagingStats* stats);
+
+/**
+ * Whether stagedPath is an up to date copy of srlPath.
+ */
+bool dsiWareStagedFrom(const char* srlPath, const char* stagedPath);
+
+/**
+ * Delete a staged SRL, its fingerprint, and the saves kept next to it
+ * (.pub.bak/.prv.bak) after it was last launched.
+ */
+void dsiWareUnstage(const char* stagedPath);
+
+/**
+ * Put a save kept from the last launch (savePath + ".bak") back in place,
+ * so it can be synced in place instead of being copied in full.
+ */
+void dsiWareRestoreSave(const char* savePath);
+
+/**
+ * Make dstPath a copy of srcPath, only writing the blocks which differ if
+ * both files have the same size. Used for the .pub/.prv saves.
+ * Returns false if the copy failed.
+ */
+bool dsiWareSyncFile(const char* srcPath, const char* dstPath, DSiWareStagingStats* stats);
+
+#endif // DSIWARE_STAGING_H
@@ -0,0 +1,23 @@
+#ifndef ESRB_DATABASE_H
+#define ESRB_DATABASE_H
+
+#include <string>
+
+/**
+ * Per-title rating info, looked up from nitro:/ESRB.bin
+ * (generated from resources/ESRB.ini by resources/esrbdb.py).
+ */
+struct EsrbInfo {
+	char rating[5];
+	bool online;
+	bool sideways; // Game starts with the console held sideways
+	std::string descriptors;
+};
+
+/**
+ * Find the info for a game by the first 3 characters of its TID.
+ * Returns false if the database can't be read or the game isn't rated.
+ */
+bool esrbLookup(const char* path, const char* tid3, EsrbInfo& info);
+
+#endif // ESRB_DATABASE_H
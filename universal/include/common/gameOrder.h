@@ -0,0 +1,42 @@
+#ifndef GAME_ORDER_H
+#define GAME_ORDER_H
+
+#include <nds/ndstypes.h>
+#include <string>
+#include <vector>
+
+/**
+ * Custom game order. Each placed file has a rank, kept as one fixed-width
+ * line in gameorder.dat (next to gameorder.ini), so moving a file usually
+ * rewrites only its own line. Ranks are spaced apart, and a moved file
+ * takes the midpoint of its neighbours' ranks.
+ */
+void gameOrderInit(const std::string& iniPath);
+
+/**
+ * Load the ranks of the files in a folder. A folder with no ranks yet
+ * takes its order from the ORDER section of gameorder.ini.
+ */
+void gameOrderLoad(const char* folder);
+
+/**
+ * Get the rank of a file in the loaded folder.
+ * Returns false if it hasn't been placed.
+ */
+bool gameOrderRank(const std::string& name, u32* rank);
+
+/**
+ * Give names[index] a rank between its neighbours, after the user moved it
+ * there. If they're unranked or there's no gap left, the whole folder is
+ * ranked again in the order of names.
+ */
+void gameOrderMove(const std::vector<std::string>& names, size_t index);
+
+/**
+ * Rank every file in the loaded folder in the order of names, such as when
+ * a file is moved while the list is in another order. gameorder.dat is
+ * rewritten, dropping the folder's files which no longer exist.
+ */
+void gameOrderRankAll(const std::vector<std::string>& names);
+
+#endif // GAME_ORDER_H
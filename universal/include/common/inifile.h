@@ -47,6 +47,7 @@ class CIniFile
     void SetStringVector(const std::string& Section,const std::string& Item,std::vector<std::string>& strings,char delimiter=',');
   protected:
     std::string m_sFileName;
+    std::string m_sSavedFileName; // File that m_FileContainer matches, if any
     typedef std::vector<std::string> StringArray;
     StringArray m_FileContainer;
     bool m_bLastResult;
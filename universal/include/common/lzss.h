@@ -7,6 +7,7 @@
 extern "C" {
 #endif
 void LZ77_Decompress(u8* source, u8* destination);
+bool LZ77_DecompressBounded(const u8* source, u32 sourceSize, u8* destination, u32 destinationSize);
 
 #ifdef __cplusplus
 }
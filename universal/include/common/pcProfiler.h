@@ -0,0 +1,46 @@
+#ifndef PC_PROFILER_H
+#define PC_PROFILER_H
+
+#include <nds/ndstypes.h>
+
+/*
+	ARM9 PC sampling
+
+	Only meant for profiling builds (make PROFILE=1, which defines
+	PC_PROFILER). A timer IRQ records where the ARM9 was interrupted, in 16
+	byte buckets. resources/itcmplace.py maps the buckets to functions with
+	the linker map, and picks which functions to put in ITCM.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct PcProfilerStats {
+	u32 samples;	// Samples taken
+	u32 dropped;	// Samples which didn't fit in the table
+	u32 buckets;	// Buckets in use
+} PcProfilerStats;
+
+/*
+Start sampling `hz` times a second on a timer, which the profiler takes
+over until it's stopped. Returns false if the table can't be allocated.
+*/
+bool pcProfilerStart(int timer, int hz);
+
+void pcProfilerStop(void);
+
+/*
+Add the samples to a histogram file, creating the folder if needed, and
+clear them. Each line is a bucket address and a sample count, in hex.
+The profiler has to be stopped first.
+*/
+bool pcProfilerDump(const char* path);
+
+PcProfilerStats pcProfilerStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PC_PROFILER_H
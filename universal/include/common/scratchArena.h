@@ -0,0 +1,59 @@
+#ifndef SCRATCH_ARENA_H
+#define SCRATCH_ARENA_H
+
+#include <nds/ndstypes.h>
+
+/*
+	Scratch arena
+
+	Large buffers which only live for one operation (a decoded screen, a
+	row buffer for an image) are checked out of a region reserved once at
+	startup, instead of being allocated from the heap each time. Repeated
+	96 KB allocations otherwise leave holes in the heap, and later loads
+	fail even though there's enough free memory in total.
+
+	Checkouts are scoped: the buffer goes back to the arena when its
+	ScratchBuffer goes out of scope. A checkout which doesn't fit in the
+	arena comes from the heap instead.
+*/
+
+struct ScratchArenaStats {
+	u32 size;			// Bytes reserved, 0 if there's no arena
+	u32 inUse;			// Bytes checked out of the arena now
+	u32 highWater;		// Most bytes checked out of the arena at once
+	u32 checkouts;
+	u32 heapFallbacks;	// Checkouts which came from the heap
+	u32 failed;			// Checkouts which didn't fit in the heap either
+};
+
+/**
+ * Reserve the arena. Call it early, before the heap gets fragmented.
+ * Returns false if the region can't be allocated, and checkouts then come
+ * from the heap.
+ */
+bool scratchArenaInit(u32 size);
+
+const ScratchArenaStats& scratchArenaStats(void);
+
+class ScratchBuffer {
+public:
+	explicit ScratchBuffer(u32 size);
+	~ScratchBuffer();
+
+	ScratchBuffer(const ScratchBuffer&) = delete;
+	ScratchBuffer& operator=(const ScratchBuffer&) = delete;
+
+	template <typename T>
+	T* as(void) const { return (T*)_data; }
+	u32 size(void) const { return _size; }
+
+	// False if the checkout failed, or the size was 0
+	explicit operator bool() const { return _data != nullptr; }
+
+private:
+	u8* _data;
+	u32 _size;
+	bool _fromHeap;
+};
+
+#endif // SCRATCH_ARENA_H
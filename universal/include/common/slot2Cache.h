@@ -0,0 +1,50 @@
+#ifndef SLOT2_CACHE_H
+#define SLOT2_CACHE_H
+
+#include <nds/ndstypes.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct Slot2CacheStats {
+	u32 puts;       // entries stored
+	u32 hits;       // gets served from Slot-2 RAM
+	u32 misses;     // gets for entries not (or no longer) stored
+	u32 evictions;  // entries overwritten as the ring wrapped
+} Slot2CacheStats;
+
+/*
+Use the RAM of a Slot-2 cart (Memory Expansion Pak, or the PSRAM of a
+SuperCard, M3 or G6) as a cache on a DS or DS Lite with a Slot-1
+flashcard. EZ-Flash carts aren't used, as their PSRAM has to be paged in
+first. The first reserved bytes at 0x09000000 are left alone.
+Returns the usable size, 0 if there's no Slot-2 RAM.
+*/
+u32 slot2CacheInit(u32 reserved);
+
+// Usable size, 0 if there's no Slot-2 RAM or it's been released
+u32 slot2CacheSize(void);
+
+/*
+Store a copy of data under key, replacing any entry with the same key.
+Entries are written one after the other around a ring, so the oldest ones
+are overwritten first. Returns false if it doesn't fit.
+*/
+bool slot2CachePut(u32 key, const void* data, u32 size);
+
+// Copy an entry back out. Returns false if it isn't stored, or has a different size
+bool slot2CacheGet(u32 key, void* data, u32 size);
+
+void slot2CacheRemove(u32 key);
+
+// Stop using Slot-2 RAM, before launching anything which uses the cart
+void slot2CacheRelease(void);
+
+void slot2CacheGetStats(Slot2CacheStats* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SLOT2_CACHE_H
@@ -0,0 +1,31 @@
+#ifndef SRLDR_PACK_H
+#define SRLDR_PACK_H
+
+/*
+	Packed .srldr modules
+
+	resources/srldrpack.py can compress the ARM9 and ARM7 binaries of a
+	module. Each packed binary is stored at its usual ROM offset as:
+
+		u32 stream length (bits 0-23) and padding length (bits 24-31)
+		padding, so the packed binary is read to a word aligned address
+		LZ77 stream (DS BIOS format, without the 4 byte BIOS header)
+		raw tail
+
+	The stream decompresses to the start of the binary and the tail is the
+	rest of it, as is. The split is chosen so the packed binary can be read
+	to the end of the binary's RAM area and decompressed in place: output
+	never catches up with input that hasn't been read yet, and when the
+	stream ends, the tail is already where it belongs.
+
+	The header's debug ROM fields, which homebrew doesn't use and the header
+	CRC doesn't cover, hold the magic and the packed sizes. Everything else
+	in the header, and the rest of the file (banner, NitroFS), is unchanged.
+*/
+
+#define SRLDR_PACK_MAGIC		0x5A4C5253 // 'SRLZ'
+#define SRLDR_PACK_MAGIC_OFFSET	0x160
+#define SRLDR_PACK_ARM9_OFFSET	0x164	// Packed ARM9 size
+#define SRLDR_PACK_ARM7_OFFSET	0x168	// Packed ARM7 size
+
+#endif // SRLDR_PACK_H
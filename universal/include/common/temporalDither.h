@@ -0,0 +1,34 @@
+#ifndef TEMPORAL_DITHER_H
+#define TEMPORAL_DITHER_H
+
+#include <nds/ndstypes.h>
+
+/**
+ * Temporal dithering: two frames are shown on alternating vblanks, so the
+ * eye sees their average and the image gets more color depth than the
+ * screen has. Both frames are produced together in one pass over the
+ * source, using a 4x4 ordered-dither kernel whose thresholds are mirrored
+ * between the two frames.
+ */
+
+enum TemporalDitherFormat {
+	TDFormatRgb555 = 0,	// BIT(15) set as the alpha/opaque bit
+	TDFormatRgb565,		// BIT(15) is the lowest green bit (hblank palette display)
+};
+
+/**
+ * Dither a single pixel.
+ * The first channel goes to the lowest color bits.
+ */
+void temporalDitherPixel(u8 c0, u8 c1, u8 c2, int x, int y, TemporalDitherFormat format, u16* out0, u16* out1);
+
+/**
+ * Dither one row of 8-bit pixels, bytesPerPixel (3 or 4) bytes each.
+ * If hasAlpha, the 4th byte is alpha: translucent pixels are blended over
+ * black, and fully transparent ones are left untouched in the output rows.
+ * Otherwise it's padding (32-bit BMPs) and every pixel is opaque.
+ * colorTable, if not NULL, is applied to both output frames.
+ */
+void temporalDitherRow(const u8* src, int bytesPerPixel, bool hasAlpha, int width, int y, TemporalDitherFormat format, const u16* colorTable, u16* dst0, u16* dst1);
+
+#endif // TEMPORAL_DITHER_H
@@ -0,0 +1,102 @@
+#ifndef WARM_SWITCH_H
+#define WARM_SWITCH_H
+
+#include <nds/ndstypes.h>
+
+/*
+	Warm module switching
+
+	When one TWiLight Menu++ module launches another, the outgoing module
+	leaves the volume geometry and the target file's cluster runs in this
+	block. The bootloader then loads the file without re-reading the boot
+	sector or walking the FAT, and the incoming module picks up the free
+	cluster hint libfat had in memory (the FSInfo sector isn't rewritten
+	on module switch, so it's stale).
+
+	The block lives in main RAM which is not cleared by the bootloader.
+	If the RAM size changes (DS mode switch), the mirror makes the block
+	unreadable and the checksum falls back to the cold path.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define WARM_SWITCH_ADDR		0x02FFF400
+#define WARM_SWITCH_MAGIC		0x4D524157 // 'WARM'
+#define WARM_SWITCH_MAX_RUNS	48
+
+#define WARM_SWITCH_DRIVE_SD	0
+#define WARM_SWITCH_DRIVE_FAT	1
+
+typedef struct {
+	u32 cluster;	// First cluster of the run
+	u32 length;		// Number of contiguous clusters
+} WarmSwitchRun;
+
+typedef struct {
+	u32 magic;
+	u16 size;
+	u8 drive;
+	u8 fileSystem;	// 1: FAT12, 2: FAT16, 3: FAT32
+
+	// Volume geometry, in 512 byte sectors
+	u32 fatStart;
+	u32 sectorsPerFat;
+	u32 rootDirStart;
+	u32 rootDirCluster;
+	u32 dataStart;
+	u32 numberOfSectors;
+	u32 sectorsPerCluster;
+	u32 lastCluster;
+	u32 firstFree;
+	u32 numberFreeCluster;
+
+	// File being launched
+	u32 fileCluster;
+	u32 runCount;
+	WarmSwitchRun runs[WARM_SWITCH_MAX_RUNS];
+
+	u32 checksum;	// Covers everything above
+
+	// Filled in by the bootloader, not checksummed
+	u32 sectorReadsSaved;
+} WarmSwitchBlock;
+
+static inline u32 warmSwitchChecksum(const WarmSwitchBlock* block) {
+	const u32* words = (const u32*)block;
+	const u32 count = (u32)((const u8*)&block->checksum - (const u8*)block) / 4;
+	u32 sum = 0x57A2B3C4;
+	for (u32 i = 0; i < count; i++) {
+		sum = ((sum << 5) | (sum >> 27)) ^ words[i];
+	}
+	return sum;
+}
+
+static inline bool warmSwitchValid(const WarmSwitchBlock* block) {
+	return (block->magic == WARM_SWITCH_MAGIC
+		 && block->size == sizeof(WarmSwitchBlock)
+		 && block->runCount > 0 && block->runCount <= WARM_SWITCH_MAX_RUNS
+		 && block->checksum == warmSwitchChecksum(block));
+}
+
+static inline void warmSwitchClear(void) {
+	((WarmSwitchBlock*)WARM_SWITCH_ADDR)->magic = 0;
+}
+
+#ifdef ARM9
+// Record the volume and cluster runs of the file about to be launched
+bool warmSwitchPrepare(const char* filename, u32 fileCluster);
+
+// Apply and then drop the block left by the previous module
+bool warmSwitchApply(void);
+
+// Sector reads the bootloader saved launching this module, 0 after a cold boot
+u32 warmSwitchReadsSaved(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WARM_SWITCH_H
@@ -1,15 +0,0 @@
-#ifndef DSGAMEINFOMAP_H
-#define DSGAMEINFOMAP_H
-
-// Games that start sideways
-static const char sidewaysGameList[][4] = {
-	"KAD", // Art Style: BASE 10
-	"AND", // Brain Age: Train Your Brain in Minutes a Day!
-	"ANM", // Brain Age 2: More Training in Minutes a Day!
-	"YCU", // Crosswords DS
-	"DHS", // Picture Perfect Hair Salon
-	"A8N", // Planet Puzzle League
-	"AZL", // Style Savvy
-};
-
-#endif // DSGAMEINFOMAP_H
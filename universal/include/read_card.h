@@ -41,6 +41,17 @@ extern sNDSHeaderExt ndsCardHeader;
 
 void my_cardReset (bool properReset);
 
+// The steps of my_cardReset(true) in DSi mode, for callers which wait between them without blocking
+enum {
+	CARD_RESET_POWER_OFF = 0,
+	CARD_RESET_POWER_ON,
+	CARD_RESET_CLEAR,
+	CARD_RESET_START,
+};
+
+// Perform one reset step, and return how many frames to wait before the next
+int my_cardResetStep (int step);
+
 int cardInit (void);
 
 void cardRead (u32 src, void* dest, size_t len);
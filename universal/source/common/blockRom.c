@@ -0,0 +1,163 @@
+#include "common/blockRom.h"
+#include "common/lzss.h"
+#include "common/tonccpy.h"
+
+#include <nds.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BLOCK_ROM_MIN_CHUNK 0x10000
+#define BLOCK_ROM_MAX_CHUNK 0x40000
+#define NO_CHUNK 0xFFFFFFFF
+
+typedef struct {
+	u32 magic;
+	u16 version;
+	u8 codec;
+	u8 flags;
+	u32 chunkSize;
+	u32 romSize;
+	u32 chunkCount;
+	u32 indexOffset;
+} BlockRomHeader;
+
+bool blockRomOpen(BlockRom* rom, FILE* file) {
+	toncset(rom, 0, sizeof(BlockRom));
+	rom->file = file;
+	rom->cachedChunk = NO_CHUNK;
+	if (!file) {
+		return false;
+	}
+
+	BlockRomHeader header;
+	fseek(file, 0, SEEK_END);
+	const u32 fileSize = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	rom->romSize = fileSize;
+	if (fread(&header, 1, sizeof(header), file) != sizeof(header) || header.magic != BLOCK_ROM_MAGIC) {
+		// Plain ROM
+		fseek(file, 0, SEEK_SET);
+		return true;
+	}
+
+	if (header.version != 1 || header.codec != BLOCK_ROM_CODEC_LZ77
+	 || header.chunkSize < BLOCK_ROM_MIN_CHUNK || header.chunkSize > BLOCK_ROM_MAX_CHUNK
+	 || header.chunkCount != (header.romSize + header.chunkSize - 1) / header.chunkSize) {
+		rom->romSize = 0;
+		return false;
+	}
+
+	rom->compressed = true;
+	rom->romSize = header.romSize;
+	rom->chunkSize = header.chunkSize;
+	rom->chunkCount = header.chunkCount;
+	rom->flags = header.flags;
+	rom->index = (BlockRomChunk*)malloc(header.chunkCount * sizeof(BlockRomChunk));
+	rom->packed = (u8*)malloc(header.chunkSize + (header.chunkSize / 8) + 8); // Worst case LZ77 output
+	rom->chunk = (u8*)malloc(header.chunkSize);
+	if (!rom->index || !rom->packed || !rom->chunk) {
+		blockRomClose(rom);
+		rom->romSize = 0;
+		return false;
+	}
+
+	fseek(file, header.indexOffset, SEEK_SET);
+	if (fread(rom->index, sizeof(BlockRomChunk), header.chunkCount, file) != header.chunkCount) {
+		blockRomClose(rom);
+		rom->romSize = 0;
+		return false;
+	}
+	return true;
+}
+
+bool blockRomIsPacked(const char* path) {
+	FILE* file = fopen(path, "rb");
+	if (!file) {
+		return false;
+	}
+	u32 magic = 0;
+	fread(&magic, 1, sizeof(magic), file);
+	fclose(file);
+	return (magic == BLOCK_ROM_MAGIC);
+}
+
+static bool loadChunk(BlockRom* rom, u32 chunk) {
+	if (rom->cachedChunk == chunk) {
+		return true;
+	}
+	rom->cachedChunk = NO_CHUNK;
+
+	const BlockRomChunk* entry = &rom->index[chunk];
+	const bool stored = (entry->size & BLOCK_ROM_STORED);
+	const u32 size = entry->size & ~BLOCK_ROM_STORED;
+	const u32 length = (chunk == rom->chunkCount - 1) ? rom->romSize - (chunk * rom->chunkSize) : rom->chunkSize;
+	if (size > rom->chunkSize + (rom->chunkSize / 8) + 8 || (stored && size != length)) {
+		return false;
+	}
+
+	fseek(rom->file, entry->offset, SEEK_SET);
+	if (fread(stored ? rom->chunk : rom->packed, 1, size, rom->file) != size) {
+		return false;
+	}
+	rom->bytesRead += size;
+
+	if (!stored) {
+		const u32 packedLength = rom->packed[1] | (rom->packed[2] << 8) | (rom->packed[3] << 16);
+		if (rom->packed[0] != BLOCK_ROM_CODEC_LZ77 || packedLength != length) {
+			return false;
+		}
+		if (!LZ77_DecompressBounded(rom->packed, size, rom->chunk, rom->chunkSize)) {
+			return false;
+		}
+	}
+
+	if ((rom->flags & BLOCK_ROM_FLAG_CRC) && swiCRC16(0xFFFF, rom->chunk, length) != (u16)entry->crc) {
+		return false;
+	}
+
+	rom->cachedChunk = chunk;
+	return true;
+}
+
+u32 blockRomRead(BlockRom* rom, void* buffer, u32 size) {
+	if (!rom->compressed) {
+		const u32 read = fread(buffer, 1, size, rom->file);
+		rom->position += read;
+		rom->bytesRead += read;
+		return read;
+	}
+
+	u32 done = 0;
+	while (done < size && rom->position < rom->romSize) {
+		const u32 chunk = rom->position / rom->chunkSize;
+		if (!loadChunk(rom, chunk)) {
+			break;
+		}
+		const u32 chunkOffset = rom->position - (chunk * rom->chunkSize);
+		u32 length = rom->chunkSize - chunkOffset;
+		if (length > size - done) length = size - done;
+		if (length > rom->romSize - rom->position) length = rom->romSize - rom->position;
+
+		tonccpy((u8*)buffer + done, rom->chunk + chunkOffset, length);
+		done += length;
+		rom->position += length;
+	}
+	return done;
+}
+
+void blockRomSeek(BlockRom* rom, u32 position) {
+	rom->position = position;
+	if (!rom->compressed) {
+		fseek(rom->file, position, SEEK_SET);
+	}
+}
+
+void blockRomClose(BlockRom* rom) {
+	free(rom->index);
+	free(rom->packed);
+	free(rom->chunk);
+	rom->index = NULL;
+	rom->packed = NULL;
+	rom->chunk = NULL;
+	rom->compressed = false;
+}
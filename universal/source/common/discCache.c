@@ -0,0 +1,562 @@
+/*
+	discCache.c
+	Block cache sitting between libfat and the SD/DLDI disc drivers.
+
+	- Sectors are cached in 4KB blocks, replaced least-recently-used first.
+	- A miss which continues the previous read also fetches the following
+	  blocks in the same driver call (read-ahead).
+	- The FAT and FAT12/16 root directory are detected from the volume boot
+	  sector as libfat mounts it, and blocks inside them are pinned.
+	- Writes to the FAT and FAT12/16 root directory go straight to the
+	  disc, after any data held back, so the FAT never points at clusters
+	  which weren't written yet.
+	- Other writes are held back and written out in runs of contiguous
+	  blocks whenever libfat finishes a file operation (close, sync,
+	  delete, rename, mkdir), so nothing stays unwritten once a file is
+	  closed. Launching another .nds and rebooting flush as well.
+	- The ARM7 asks for a flush before it powers off (DISC_CACHE_FIFO).
+	  It's answered from the FIFO handler when nothing is held back,
+	  otherwise as the disc operation in progress ends.
+*/
+
+#include "common/discCache.h"
+#include "common/tonccpy.h"
+
+#include <nds/fifocommon.h>
+#include <sys/iosupport.h>
+#include <malloc.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SPB DISC_CACHE_SECTORS_PER_BLOCK
+#define BYTES_PER_SECTOR 512
+#define BLOCK_SIZE (SPB*BYTES_PER_SECTOR)
+#define NO_BLOCK 0xFFFFFFFF
+#define BYPASS_SECTORS (SPB*4) // Reads this large (ROMs, streamed audio) skip the cache
+
+typedef struct {
+	sec_t block;
+	u32 lastAccess;
+	bool dirty;
+	bool pinned;
+	u8* data;
+} DiscCacheBlock;
+
+typedef struct {
+	DISC_INTERFACE iface;
+	const DISC_INTERFACE* base;
+	u32 cacheSize;
+	DiscCacheBlock* blocks;
+	u32 numBlocks;
+	u8* blockBuffer;
+	u8* stagingBuffer;
+	u32 stagingBlocks;
+	u32 accessCounter;
+	sec_t nextSeqSector;
+	sec_t pinStart;
+	sec_t pinEnd;
+	u32 maxPinned;
+	DiscCacheStats stats;
+} DiscCache;
+
+static DiscCache caches[DISC_CACHE_MAX_WRAPPERS];
+static int cacheCount = 0;
+static volatile bool opActive = false;
+static volatile bool flushRequested = false;
+static devoptab_t fatOps; // libfat's own operations, wrapped by discCacheHookDevice
+
+static DiscCacheBlock* findBlock(DiscCache* c, sec_t block) {
+	for (u32 i = 0; i < c->numBlocks; i++) {
+		if (c->blocks[i].block == block) {
+			c->blocks[i].lastAccess = ++c->accessCounter;
+			return &c->blocks[i];
+		}
+	}
+	return NULL;
+}
+
+static bool writeBackRun(DiscCache* c, DiscCacheBlock** run, u32 runLen) {
+	if (runLen == 1) {
+		if (!c->base->writeSectors(run[0]->block*SPB, SPB, run[0]->data)) return false;
+	} else {
+		for (u32 i = 0; i < runLen; i++) {
+			tonccpy(c->stagingBuffer + i*BLOCK_SIZE, run[i]->data, BLOCK_SIZE);
+		}
+		if (!c->base->writeSectors(run[0]->block*SPB, SPB*runLen, c->stagingBuffer)) return false;
+	}
+	for (u32 i = 0; i < runLen; i++) {
+		run[i]->dirty = false;
+	}
+	c->stats.blocksFlushed += runLen;
+	return true;
+}
+
+static bool writeBackBlock(DiscCache* c, DiscCacheBlock* entry) {
+	return writeBackRun(c, &entry, 1);
+}
+
+// Write back dirty blocks in ascending order, merging neighbours into one driver call
+static bool flushCache(DiscCache* c) {
+	DiscCacheBlock* run[8];
+	u32 runLen = 0;
+	sec_t lastBlock = NO_BLOCK;
+	bool ok = true;
+
+	for (;;) {
+		DiscCacheBlock* next = NULL;
+		for (u32 i = 0; i < c->numBlocks; i++) {
+			DiscCacheBlock* entry = &c->blocks[i];
+			if (!entry->dirty || (lastBlock != NO_BLOCK && entry->block <= lastBlock)) continue;
+			if (!next || entry->block < next->block) next = entry;
+		}
+		if (!next) break;
+
+		if (runLen > 0 && (next->block != lastBlock+1 || runLen == c->stagingBlocks || runLen == 8)) {
+			ok &= writeBackRun(c, run, runLen);
+			runLen = 0;
+		}
+		run[runLen++] = next;
+		lastBlock = next->block;
+	}
+	if (runLen > 0) {
+		ok &= writeBackRun(c, run, runLen);
+	}
+	return ok;
+}
+
+static DiscCacheBlock* evictBlock(DiscCache* c) {
+	DiscCacheBlock* victim = NULL;
+	for (u32 i = 0; i < c->numBlocks; i++) {
+		DiscCacheBlock* entry = &c->blocks[i];
+		if (entry->block == NO_BLOCK) {
+			victim = entry;
+			break;
+		}
+		if (entry->pinned) continue;
+		if (!victim || entry->lastAccess < victim->lastAccess) victim = entry;
+	}
+	if (!victim) return NULL;
+
+	if (victim->dirty && !writeBackBlock(c, victim)) return NULL;
+	if (victim->pinned) c->stats.pinnedBlocks--;
+	victim->block = NO_BLOCK;
+	victim->pinned = false;
+	return victim;
+}
+
+static void claimBlock(DiscCache* c, DiscCacheBlock* entry, sec_t block) {
+	entry->block = block;
+	entry->dirty = false;
+	entry->lastAccess = ++c->accessCounter;
+
+	const sec_t sector = block*SPB;
+	if (c->pinEnd > c->pinStart && sector+SPB > c->pinStart && sector < c->pinEnd
+	 && c->stats.pinnedBlocks < c->maxPinned) {
+		entry->pinned = true;
+		c->stats.pinnedBlocks++;
+	}
+}
+
+static DiscCacheBlock* loadBlock(DiscCache* c, sec_t block, bool sequential) {
+	u32 readAhead = 0;
+	if (sequential) {
+		while (readAhead+1 < c->stagingBlocks && !findBlock(c, block+readAhead+1)) {
+			readAhead++;
+		}
+	}
+
+	if (readAhead > 0 && c->base->readSectors(block*SPB, SPB*(readAhead+1), c->stagingBuffer)) {
+		DiscCacheBlock* first = NULL;
+		for (u32 i = 0; i <= readAhead; i++) {
+			DiscCacheBlock* entry = evictBlock(c);
+			if (!entry) break;
+			tonccpy(entry->data, c->stagingBuffer + i*BLOCK_SIZE, BLOCK_SIZE);
+			claimBlock(c, entry, block+i);
+			if (i == 0) {
+				first = entry;
+			} else {
+				c->stats.readAheads++;
+			}
+		}
+		if (first) first->lastAccess = ++c->accessCounter;
+		return first;
+	}
+
+	DiscCacheBlock* entry = evictBlock(c);
+	if (!entry) return NULL;
+	if (!c->base->readSectors(block*SPB, SPB, entry->data)) {
+		return NULL;
+	}
+	claimBlock(c, entry, block);
+	return entry;
+}
+
+// Look for the volume boot sector libfat reads on mount, to find the FAT region
+static void snoopBootSector(DiscCache* c, sec_t sector, const u8* data) {
+	if (c->pinEnd > c->pinStart) return;
+	if (data[0x1FE] != 0x55 || data[0x1FF] != 0xAA) return;
+	if (data[0] != 0xEB && data[0] != 0xE9) return;
+	if (memcmp(data+0x36, "FAT", 3) != 0 && memcmp(data+0x52, "FAT", 3) != 0) return;
+
+	const u32 bytesPerSector = data[0x0B] | (data[0x0C] << 8);
+	const u32 reservedSectors = data[0x0E] | (data[0x0F] << 8);
+	const u32 numberOfFats = data[0x10];
+	const u32 rootEntries = data[0x11] | (data[0x12] << 8);
+	u32 sectorsPerFat = data[0x16] | (data[0x17] << 8);
+	if (sectorsPerFat == 0) {
+		sectorsPerFat = data[0x24] | (data[0x25] << 8) | (data[0x26] << 16) | (data[0x27] << 24);
+	}
+	if (bytesPerSector != BYTES_PER_SECTOR || numberOfFats == 0) return;
+
+	c->pinStart = sector + reservedSectors;
+	// Only the first FAT copy is read by libfat
+	c->pinEnd = c->pinStart + sectorsPerFat;
+	if (rootEntries > 0) {
+		const sec_t rootStart = c->pinStart + (sectorsPerFat*numberOfFats);
+		if (rootStart == c->pinEnd) {
+			c->pinEnd += (rootEntries*32) / BYTES_PER_SECTOR;
+		}
+	}
+}
+
+static bool cacheReadSectors(DiscCache* c, sec_t sector, sec_t numSectors, void* buffer) {
+	c->stats.reads++;
+
+	if (c->numBlocks == 0 || numSectors >= BYPASS_SECTORS) {
+		if (c->numBlocks > 0) {
+			// Cached dirty data overlapping the range must reach the disc first
+			for (u32 i = 0; i < c->numBlocks; i++) {
+				DiscCacheBlock* entry = &c->blocks[i];
+				if (entry->dirty && entry->block*SPB < sector+numSectors && entry->block*SPB+SPB > sector) {
+					if (!writeBackBlock(c, entry)) return false;
+				}
+			}
+			c->stats.bypassReads++;
+		}
+		c->nextSeqSector = sector+numSectors;
+		return c->base->readSectors(sector, numSectors, buffer);
+	}
+
+	const bool sequential = (sector == c->nextSeqSector);
+	const sec_t firstSector = sector;
+	u8* dst = (u8*)buffer;
+	while (numSectors > 0) {
+		const sec_t block = sector / SPB;
+		const u32 offset = sector % SPB;
+		u32 count = SPB - offset;
+		if (count > numSectors) count = numSectors;
+
+		DiscCacheBlock* entry = findBlock(c, block);
+		if (entry) {
+			c->stats.hits++;
+		} else {
+			c->stats.misses++;
+			entry = loadBlock(c, block, sequential);
+		}
+
+		if (entry) {
+			tonccpy(dst, entry->data + offset*BYTES_PER_SECTOR, count*BYTES_PER_SECTOR);
+		} else if (!c->base->readSectors(sector, count, dst)) {
+			return false;
+		}
+
+		if (sector == firstSector && count == 1) {
+			snoopBootSector(c, sector, dst);
+		}
+
+		dst += count*BYTES_PER_SECTOR;
+		sector += count;
+		numSectors -= count;
+	}
+	c->nextSeqSector = sector;
+	return true;
+}
+
+// Write straight to the disc, then refresh any cached copies
+static bool writeThrough(DiscCache* c, sec_t sector, sec_t numSectors, const void* buffer) {
+	if (!c->base->writeSectors(sector, numSectors, buffer)) return false;
+	for (u32 i = 0; i < c->numBlocks; i++) {
+		DiscCacheBlock* entry = &c->blocks[i];
+		if (entry->block == NO_BLOCK) continue;
+		const sec_t blockStart = entry->block*SPB;
+		if (blockStart >= sector+numSectors || blockStart+SPB <= sector) continue;
+		const sec_t start = (blockStart > sector) ? blockStart : sector;
+		const sec_t end = (blockStart+SPB < sector+numSectors) ? blockStart+SPB : sector+numSectors;
+		tonccpy(entry->data + (start-blockStart)*BYTES_PER_SECTOR, (const u8*)buffer + (start-sector)*BYTES_PER_SECTOR, (end-start)*BYTES_PER_SECTOR);
+	}
+	return true;
+}
+
+static bool cacheWriteSectors(DiscCache* c, sec_t sector, sec_t numSectors, const void* buffer) {
+	c->stats.writes++;
+
+	if (c->numBlocks == 0) {
+		return c->base->writeSectors(sector, numSectors, buffer);
+	}
+
+	if (c->pinEnd > c->pinStart && sector < c->pinEnd && sector+numSectors > c->pinStart) {
+		// FAT or root directory: the data it points at goes first
+		if (!flushCache(c)) return false;
+		c->stats.writesThrough++;
+		return writeThrough(c, sector, numSectors, buffer);
+	}
+
+	if (numSectors >= BYPASS_SECTORS) {
+		return writeThrough(c, sector, numSectors, buffer);
+	}
+
+	const u8* src = (const u8*)buffer;
+	while (numSectors > 0) {
+		const sec_t block = sector / SPB;
+		const u32 offset = sector % SPB;
+		u32 count = SPB - offset;
+		if (count > numSectors) count = numSectors;
+
+		DiscCacheBlock* entry = findBlock(c, block);
+		if (!entry && count == SPB) {
+			// Whole block is overwritten, so no need to read it in first
+			entry = evictBlock(c);
+			if (entry) claimBlock(c, entry, block);
+		}
+
+		if (entry) {
+			if (entry->dirty) c->stats.writesAbsorbed++;
+			tonccpy(entry->data + offset*BYTES_PER_SECTOR, src, count*BYTES_PER_SECTOR);
+			entry->dirty = true;
+		} else if (!c->base->writeSectors(sector, count, src)) {
+			return false;
+		}
+
+		src += count*BYTES_PER_SECTOR;
+		sector += count;
+		numSectors -= count;
+	}
+	return true;
+}
+
+static void freeCache(DiscCache* c) {
+	free(c->blocks);
+	free(c->blockBuffer);
+	free(c->stagingBuffer);
+	c->blocks = NULL;
+	c->blockBuffer = NULL;
+	c->stagingBuffer = NULL;
+	c->numBlocks = 0;
+	c->stagingBlocks = 0;
+}
+
+static bool cacheStartup(DiscCache* c) {
+	if (!c->base->startup()) return false;
+	if (c->numBlocks > 0) return true;
+
+	u32 numBlocks = c->cacheSize / BLOCK_SIZE;
+	c->stagingBlocks = (numBlocks >= 64) ? 4 : 2;
+
+	// Back off until the allocation fits
+	while (numBlocks >= 8) {
+		c->blocks = (DiscCacheBlock*)calloc(numBlocks, sizeof(DiscCacheBlock));
+		c->blockBuffer = (u8*)memalign(32, numBlocks*BLOCK_SIZE);
+		c->stagingBuffer = (u8*)memalign(32, c->stagingBlocks*BLOCK_SIZE);
+		if (c->blocks && c->blockBuffer && c->stagingBuffer) break;
+		freeCache(c);
+		numBlocks /= 2;
+	}
+	if (numBlocks < 8) {
+		// Run uncached
+		return true;
+	}
+
+	for (u32 i = 0; i < numBlocks; i++) {
+		c->blocks[i].block = NO_BLOCK;
+		c->blocks[i].data = c->blockBuffer + i*BLOCK_SIZE;
+	}
+	c->numBlocks = numBlocks;
+	c->maxPinned = numBlocks/2;
+	c->accessCounter = 0;
+	c->nextSeqSector = NO_BLOCK;
+	c->pinStart = 0;
+	c->pinEnd = 0;
+	memset(&c->stats, 0, sizeof(DiscCacheStats));
+	return true;
+}
+
+static void invalidateCache(DiscCache* c) {
+	flushCache(c);
+	for (u32 i = 0; i < c->numBlocks; i++) {
+		c->blocks[i].block = NO_BLOCK;
+		c->blocks[i].dirty = false;
+		c->blocks[i].pinned = false;
+	}
+	c->stats.pinnedBlocks = 0;
+	c->nextSeqSector = NO_BLOCK;
+	c->pinStart = 0;
+	c->pinEnd = 0;
+}
+
+static bool cacheClearStatus(DiscCache* c) {
+	invalidateCache(c);
+	return c->base->clearStatus();
+}
+
+static bool cacheShutdown(DiscCache* c) {
+	flushCache(c);
+	freeCache(c);
+	return c->base->shutdown();
+}
+
+static bool hasDirtyBlocks(void) {
+	for (int i = 0; i < cacheCount; i++) {
+		for (u32 j = 0; j < caches[i].numBlocks; j++) {
+			if (caches[i].blocks[j].dirty) return true;
+		}
+	}
+	return false;
+}
+
+// FIFO handler, so the disc can't be touched from here
+static void flushRequestHandler(u32 value, void* userdata) {
+	if (value != DISC_CACHE_FLUSH_REQUEST) return;
+	if (opActive || hasDirtyBlocks()) {
+		flushRequested = true;
+	} else {
+		fifoSendValue32(DISC_CACHE_FIFO, DISC_CACHE_FLUSH_REQUEST);
+	}
+}
+
+static bool beginOp(void) {
+	opActive = true;
+	return true;
+}
+
+static bool endOp(bool result) {
+	opActive = false;
+	if (flushRequested) {
+		flushRequested = false;
+		discCacheFlushAll();
+		fifoSendValue32(DISC_CACHE_FIFO, DISC_CACHE_FLUSH_REQUEST);
+	}
+	return result;
+}
+
+#define DISC_CACHE_THUNKS(n) \
+static bool startup##n(void) { return cacheStartup(&caches[n]); } \
+static bool isInserted##n(void) { return caches[n].base->isInserted(); } \
+static bool readSectors##n(sec_t sector, sec_t numSectors, void* buffer) { return beginOp() && endOp(cacheReadSectors(&caches[n], sector, numSectors, buffer)); } \
+static bool writeSectors##n(sec_t sector, sec_t numSectors, const void* buffer) { return beginOp() && endOp(cacheWriteSectors(&caches[n], sector, numSectors, buffer)); } \
+static bool clearStatus##n(void) { return cacheClearStatus(&caches[n]); } \
+static bool shutdown##n(void) { return cacheShutdown(&caches[n]); }
+
+DISC_CACHE_THUNKS(0)
+DISC_CACHE_THUNKS(1)
+
+#define DISC_CACHE_FUNCS(n) \
+	startup##n, isInserted##n, readSectors##n, writeSectors##n, clearStatus##n, shutdown##n
+
+const DISC_INTERFACE* discCacheWrap(const DISC_INTERFACE* base, u32 cacheSize) {
+	if (!base || cacheCount >= DISC_CACHE_MAX_WRAPPERS) return base;
+
+	for (int i = 0; i < cacheCount; i++) {
+		if (caches[i].base == base) return &caches[i].iface;
+	}
+
+	static const DISC_INTERFACE wrapperFuncs[DISC_CACHE_MAX_WRAPPERS] = {
+		{0, 0, DISC_CACHE_FUNCS(0)},
+		{0, 0, DISC_CACHE_FUNCS(1)},
+	};
+
+	if (cacheCount == 0) {
+		fifoSetValue32Handler(DISC_CACHE_FIFO, flushRequestHandler, NULL);
+	}
+
+	DiscCache* c = &caches[cacheCount];
+	c->iface = wrapperFuncs[cacheCount];
+	c->iface.ioType = base->ioType;
+	c->iface.features = base->features;
+	c->base = base;
+	c->cacheSize = cacheSize;
+	cacheCount++;
+	return &c->iface;
+}
+
+void discCacheFlushAll(void) {
+	for (int i = 0; i < cacheCount; i++) {
+		flushCache(&caches[i]);
+	}
+}
+
+static int closeAndFlush(struct _reent* r, void* fd) {
+	const int result = fatOps.close_r(r, fd);
+	discCacheFlushAll();
+	return result;
+}
+
+static int fsyncAndFlush(struct _reent* r, void* fd) {
+	const int result = fatOps.fsync_r(r, fd);
+	discCacheFlushAll();
+	return result;
+}
+
+static int unlinkAndFlush(struct _reent* r, const char* name) {
+	const int result = fatOps.unlink_r(r, name);
+	discCacheFlushAll();
+	return result;
+}
+
+static int renameAndFlush(struct _reent* r, const char* oldName, const char* newName) {
+	const int result = fatOps.rename_r(r, oldName, newName);
+	discCacheFlushAll();
+	return result;
+}
+
+static int mkdirAndFlush(struct _reent* r, const char* path, int mode) {
+	const int result = fatOps.mkdir_r(r, path, mode);
+	discCacheFlushAll();
+	return result;
+}
+
+static int rmdirAndFlush(struct _reent* r, const char* name) {
+	const int result = fatOps.rmdir_r(r, name);
+	discCacheFlushAll();
+	return result;
+}
+
+void discCacheHookDevice(const char* name) {
+	// libfat allocates a copy of its devoptab for each mount, so it can be changed in place
+	devoptab_t* ops = (devoptab_t*)GetDeviceOpTab(name);
+	if (!ops || ops->close_r == closeAndFlush) return;
+
+	if (!fatOps.close_r) {
+		fatOps = *ops;
+	}
+	ops->close_r = closeAndFlush;
+	ops->fsync_r = fsyncAndFlush;
+	ops->unlink_r = unlinkAndFlush;
+	ops->rename_r = renameAndFlush;
+	ops->mkdir_r = mkdirAndFlush;
+	ops->rmdir_r = rmdirAndFlush;
+}
+
+void discCacheInvalidateAll(void) {
+	for (int i = 0; i < cacheCount; i++) {
+		invalidateCache(&caches[i]);
+	}
+}
+
+bool discCacheGetStats(const DISC_INTERFACE* disc, DiscCacheStats* stats) {
+	for (int i = 0; i < cacheCount; i++) {
+		if (disc == &caches[i].iface) {
+			*stats = caches[i].stats;
+			return true;
+		}
+	}
+	return false;
+}
+
+const DISC_INTERFACE* discCacheBase(const DISC_INTERFACE* disc) {
+	for (int i = 0; i < cacheCount; i++) {
+		if (disc == &caches[i].iface) {
+			return caches[i].base;
+		}
+	}
+	return disc;
+}
@@ -0,0 +1,201 @@
+#include "common/dsiWareStaging.h"
+
+#include <nds.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define STAGING_BLOCK_SIZE 0x4000
+#define STAGING_HEADER_SIZE 0x1000
+
+struct DSiWareFingerprint {
+	char magic[4];
+	u32 srcSize;
+	u32 srcCluster;
+	u32 srcTime;
+	u32 srcHeaderCrc;
+	u32 stagedSize;
+	u32 stagedCluster;
+};
+
+// stagedPath with its extension replaced
+static std::string stagedSibling(const char* stagedPath, const char* extension) {
+	std::string path = stagedPath;
+	size_t dot = path.find_last_of('.');
+	if (dot != std::string::npos && path.find('/', dot) == std::string::npos) {
+		path.resize(dot);
+	}
+	return path + extension;
+}
+
+static bool fingerprintSource(const char* srlPath, DSiWareFingerprint* fp, DSiWareStagingStats* stats) {
+	struct stat st;
+	if (stat(srlPath, &st) != 0) {
+		return false;
+	}
+
+	FILE* file = fopen(srlPath, "rb");
+	if (!file) {
+		return false;
+	}
+	u8* header = (u8*)malloc(STAGING_HEADER_SIZE);
+	if (!header) {
+		fclose(file);
+		return false;
+	}
+	const size_t headerLen = fread(header, 1, STAGING_HEADER_SIZE, file);
+	fclose(file);
+	stats->bytesRead += headerLen;
+
+	memcpy(fp->magic, "DSWF", 4);
+	fp->srcSize = st.st_size;
+	fp->srcCluster = st.st_ino;
+	fp->srcTime = st.st_mtime;
+	fp->srcHeaderCrc = swiCRC16(0xFFFF, header, headerLen);
+	free(header);
+	return true;
+}
+
+static bool readFingerprint(const char* fpPath, DSiWareFingerprint* fp) {
+	FILE* fpFile = fopen(fpPath, "rb");
+	if (!fpFile) {
+		return false;
+	}
+	const bool ok = (fread(fp, 1, sizeof(*fp), fpFile) == sizeof(*fp) && memcmp(fp->magic, "DSWF", 4) == 0);
+	fclose(fpFile);
+	return ok;
+}
+
+static bool stagedCopyMatches(const DSiWareFingerprint* current, const char* stagedPath, const char* fpPath) {
+	DSiWareFingerprint saved;
+	struct stat st;
+	return (readFingerprint(fpPath, &saved) && stat(stagedPath, &st) == 0
+	 && saved.srcSize == current->srcSize
+	 && saved.srcCluster == current->srcCluster
+	 && saved.srcTime == current->srcTime
+	 && saved.srcHeaderCrc == current->srcHeaderCrc
+	 && saved.stagedSize == (u32)st.st_size
+	 && saved.stagedCluster == (u32)st.st_ino);
+}
+
+DSiWareStageResult dsiWareStageSrl(const char* srlPath, const char* stagedPath, DSiWareStagingStats* stats) {
+	const std::string fpPath = stagedSibling(stagedPath, ".fp");
+
+	DSiWareFingerprint current;
+	if (!fingerprintSource(srlPath, &current, stats)) {
+		return EStageFailed;
+	}
+
+	if (stagedCopyMatches(&current, stagedPath, fpPath.c_str())) {
+		return EStageUpToDate;
+	}
+
+	// Don't trust a half-written copy if the console is turned off
+	remove(fpPath.c_str());
+	remove(stagedPath);
+
+	FILE* src = fopen(srlPath, "rb");
+	FILE* dst = src ? fopen(stagedPath, "wb") : NULL;
+	u8* buffer = (u8*)malloc(STAGING_BLOCK_SIZE);
+	bool ok = (src && dst && buffer);
+	while (ok) {
+		const size_t numr = fread(buffer, 1, STAGING_BLOCK_SIZE, src);
+		if (numr == 0) break;
+		stats->bytesRead += numr;
+		ok = (fwrite(buffer, 1, numr, dst) == numr);
+		stats->bytesWritten += numr;
+	}
+	free(buffer);
+	if (dst) fclose(dst);
+	if (src) fclose(src);
+
+	struct stat st;
+	if (!ok || stat(stagedPath, &st) != 0 || (u32)st.st_size != current.srcSize) {
+		remove(stagedPath);
+		return EStageFailed;
+	}
+
+	current.stagedSize = st.st_size;
+	current.stagedCluster = st.st_ino;
+	FILE* fpFile = fopen(fpPath.c_str(), "wb");
+	if (fpFile) {
+		fwrite(&current, 1, sizeof(current), fpFile);
+		fclose(fpFile);
+	}
+	return EStageCopied;
+}
+
+bool dsiWareStagedFrom(const char* srlPath, const char* stagedPath) {
+	const std::string fpPath = stagedSibling(stagedPath, ".fp");
+	DSiWareFingerprint saved;
+	struct stat st;
+	// Check what's known without reading the source first
+	if (!readFingerprint(fpPath.c_str(), &saved) || stat(srlPath, &st) != 0
+	 || saved.srcSize != (u32)st.st_size || saved.srcCluster != (u32)st.st_ino) {
+		return false;
+	}
+
+	DSiWareFingerprint current;
+	DSiWareStagingStats stats = {0, 0};
+	return (fingerprintSource(srlPath, &current, &stats) && stagedCopyMatches(&current, stagedPath, fpPath.c_str()));
+}
+
+void dsiWareUnstage(const char* stagedPath) {
+	remove(stagedSibling(stagedPath, ".fp").c_str());
+	remove(stagedPath);
+	remove(stagedSibling(stagedPath, ".pub.bak").c_str());
+	remove(stagedSibling(stagedPath, ".prv.bak").c_str());
+}
+
+void dsiWareRestoreSave(const char* savePath) {
+	const std::string bakPath = std::string(savePath) + ".bak";
+	if (access(bakPath.c_str(), F_OK) != 0) {
+		return;
+	}
+	remove(savePath);
+	rename(bakPath.c_str(), savePath);
+}
+
+bool dsiWareSyncFile(const char* srcPath, const char* dstPath, DSiWareStagingStats* stats) {
+	struct stat srcSt, dstSt;
+	if (stat(srcPath, &srcSt) != 0) {
+		return false;
+	}
+	const bool inPlace = (stat(dstPath, &dstSt) == 0 && dstSt.st_size == srcSt.st_size);
+
+	FILE* src = fopen(srcPath, "rb");
+	FILE* dst = src ? fopen(dstPath, inPlace ? "r+b" : "wb") : NULL;
+	u8* srcBuffer = (u8*)malloc(STAGING_BLOCK_SIZE);
+	u8* dstBuffer = inPlace ? (u8*)malloc(STAGING_BLOCK_SIZE) : NULL;
+	bool ok = (src && dst && srcBuffer && (dstBuffer || !inPlace));
+
+	off_t offset = 0;
+	while (ok) {
+		const size_t numr = fread(srcBuffer, 1, STAGING_BLOCK_SIZE, src);
+		if (numr == 0) break;
+		stats->bytesRead += numr;
+
+		if (inPlace) {
+			// Save blocks the game didn't touch are left alone
+			fseek(dst, offset, SEEK_SET);
+			const size_t dstr = fread(dstBuffer, 1, numr, dst);
+			stats->bytesRead += dstr;
+			if (dstr == numr && memcmp(srcBuffer, dstBuffer, numr) == 0) {
+				offset += numr;
+				continue;
+			}
+			fseek(dst, offset, SEEK_SET);
+		}
+		ok = (fwrite(srcBuffer, 1, numr, dst) == numr);
+		stats->bytesWritten += numr;
+		offset += numr;
+	}
+	free(dstBuffer);
+	free(srcBuffer);
+	if (dst) fclose(dst);
+	if (src) fclose(src);
+	return ok;
+}
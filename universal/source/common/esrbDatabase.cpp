@@ -0,0 +1,76 @@
+#include "common/esrbDatabase.h"
+
+#include <nds/ndstypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#define ESRB_FLAG_ONLINE	BIT(0)
+#define ESRB_FLAG_SIDEWAYS	BIT(1)
+
+struct EsrbHeader {
+	char magic[4];
+	u32 recordCount;
+	u32 stringsOffset;
+	u32 stringsSize;
+};
+
+struct EsrbRecord {
+	char tid[3];
+	u8 flags;
+	char rating[4];
+	u32 descriptorsOffset;
+};
+static_assert(sizeof(EsrbRecord) == 12);
+
+bool esrbLookup(const char* path, const char* tid3, EsrbInfo& info) {
+	FILE* file = fopen(path, "rb");
+	if (!file) return false;
+
+	EsrbHeader header;
+	if (fread(&header, 1, sizeof(header), file) != sizeof(header) || memcmp(header.magic, "ESRB", 4) != 0) {
+		fclose(file);
+		return false;
+	}
+
+	// Binary search over the sorted records, reading only the ones probed
+	EsrbRecord record;
+	int low = 0;
+	int high = (int)header.recordCount - 1;
+	bool found = false;
+	while (low <= high) {
+		const int mid = (low + high) / 2;
+		fseek(file, sizeof(EsrbHeader) + (mid * sizeof(EsrbRecord)), SEEK_SET);
+		if (fread(&record, 1, sizeof(record), file) != sizeof(record)) break;
+
+		const int cmp = memcmp(tid3, record.tid, 3);
+		if (cmp == 0) {
+			found = true;
+			break;
+		} else if (cmp < 0) {
+			high = mid - 1;
+		} else {
+			low = mid + 1;
+		}
+	}
+
+	if (!found) {
+		fclose(file);
+		return false;
+	}
+
+	memcpy(info.rating, record.rating, 4);
+	info.rating[4] = 0;
+	info.online = (record.flags & ESRB_FLAG_ONLINE);
+	info.sideways = (record.flags & ESRB_FLAG_SIDEWAYS);
+	info.descriptors.clear();
+
+	if (record.descriptorsOffset > 0 && record.descriptorsOffset < header.stringsSize) {
+		char descriptors[256] = {0};
+		fseek(file, header.stringsOffset + record.descriptorsOffset, SEEK_SET);
+		fread(descriptors, 1, sizeof(descriptors) - 1, file);
+		info.descriptors = descriptors;
+	}
+
+	fclose(file);
+	return true;
+}
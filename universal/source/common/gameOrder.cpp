@@ -0,0 +1,197 @@
+#include "common/gameOrder.h"
+#include "common/inifile.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <unordered_map>
+
+#define RANK_STEP 0x10000
+#define RANK_MAX 0x7FFFFFFF	// Ranks are sorted as ints
+#define RANK_DIGITS 8
+
+struct RankRecord {
+	u32 rank;
+	long offset;	// Of the line in gameorder.dat
+};
+
+static std::string iniFilePath, rankFilePath;
+static std::string loadedFolder;
+static std::unordered_map<std::string, RankRecord> ranks;
+
+static std::string folderPrefix(const char* folder) {
+	std::string prefix = folder;
+	if (prefix.empty() || prefix.back() != '/') {
+		prefix += '/';
+	}
+	return prefix;
+}
+
+static void writeRanks(const std::vector<std::pair<std::string, u32>>& updates) {
+	FILE* file = fopen(rankFilePath.c_str(), "r+b");
+	if (!file) {
+		file = fopen(rankFilePath.c_str(), "w+b");
+		if (!file) return;
+	}
+
+	char rankStr[RANK_DIGITS + 1];
+	for (const auto& update : updates) {
+		snprintf(rankStr, sizeof(rankStr), "%08lX", (unsigned long)update.second);
+		auto existing = ranks.find(update.first);
+		if (existing != ranks.end()) {
+			// Overwrite the rank in place
+			fseek(file, existing->second.offset, SEEK_SET);
+			fwrite(rankStr, 1, RANK_DIGITS, file);
+			existing->second.rank = update.second;
+		} else {
+			fseek(file, 0, SEEK_END);
+			const long offset = ftell(file);
+			fprintf(file, "%s %s%s\n", rankStr, loadedFolder.c_str(), update.first.c_str());
+			ranks[update.first] = {update.second, offset};
+		}
+	}
+	fclose(file);
+}
+
+// Belongs to a file directly in the loaded folder, and not in a subfolder
+static const char* loadedName(const char* path) {
+	if (strncmp(path, loadedFolder.c_str(), loadedFolder.size()) != 0) {
+		return NULL;
+	}
+	const char* name = path + loadedFolder.size();
+	return (*name && !strchr(name, '/')) ? name : NULL;
+}
+
+/*
+Rewrite gameorder.dat with new ranks for the loaded folder. Lines of other
+folders are kept as they are, and lines of this folder for files which are
+no longer there are dropped, so the file doesn't keep growing as files are
+deleted or renamed.
+*/
+static void rewriteRanks(const std::vector<std::pair<std::string, u32>>& updates) {
+	for (const auto& update : updates) {
+		ranks[update.first].rank = update.second;
+	}
+	for (auto record = ranks.begin(); record != ranks.end(); ) {
+		if (access((loadedFolder + record->first).c_str(), F_OK) != 0) {
+			record = ranks.erase(record);
+		} else {
+			++record;
+		}
+	}
+
+	const std::string tempPath = rankFilePath + ".tmp";
+	FILE* out = fopen(tempPath.c_str(), "wb");
+	if (!out) return;
+
+	FILE* in = fopen(rankFilePath.c_str(), "rb");
+	if (in) {
+		char line[PATH_MAX + RANK_DIGITS + 2];
+		while (fgets(line, sizeof(line), in)) {
+			const size_t len = strlen(line);
+			if (len <= RANK_DIGITS + 1 || line[RANK_DIGITS] != ' ') {
+				continue;
+			}
+			line[strcspn(line, "\r\n")] = 0;
+			if (!loadedName(line + RANK_DIGITS + 1)) {
+				fprintf(out, "%s\n", line);
+			}
+		}
+		fclose(in);
+	}
+
+	for (auto& record : ranks) {
+		record.second.offset = ftell(out);
+		fprintf(out, "%08lX %s%s\n", (unsigned long)record.second.rank, loadedFolder.c_str(), record.first.c_str());
+	}
+	const bool written = (fclose(out) == 0);
+
+	if (written) {
+		remove(rankFilePath.c_str());
+		rename(tempPath.c_str(), rankFilePath.c_str());
+	} else {
+		remove(tempPath.c_str());
+	}
+}
+
+void gameOrderInit(const std::string& iniPath) {
+	iniFilePath = iniPath;
+	rankFilePath = iniPath.substr(0, iniPath.find_last_of('.')) + ".dat";
+	loadedFolder.clear();
+	ranks.clear();
+}
+
+void gameOrderLoad(const char* folder) {
+	const std::string prefix = folderPrefix(folder);
+	if (prefix == loadedFolder) return;
+	loadedFolder = prefix;
+	ranks.clear();
+
+	FILE* file = fopen(rankFilePath.c_str(), "rb");
+	if (file) {
+		char line[PATH_MAX + RANK_DIGITS + 2];
+		long offset = 0;
+		while (fgets(line, sizeof(line), file)) {
+			const size_t len = strlen(line);
+			if (len > RANK_DIGITS + 1 && line[RANK_DIGITS] == ' ') {
+				line[strcspn(line, "\r\n")] = 0;
+				const char* name = loadedName(line + RANK_DIGITS + 1);
+				if (name) {
+					ranks[name] = {(u32)strtoul(line, NULL, 16), offset};
+				}
+			}
+			offset += len;
+		}
+		fclose(file);
+	}
+
+	if (ranks.empty()) {
+		CIniFile gameOrderIni(iniFilePath);
+		std::vector<std::string> gameOrder;
+		gameOrderIni.GetStringVector("ORDER", folder, gameOrder, ':');
+		if (!gameOrder.empty()) {
+			gameOrderRankAll(gameOrder);
+		}
+	}
+}
+
+bool gameOrderRank(const std::string& name, u32* rank) {
+	auto record = ranks.find(name);
+	if (record == ranks.end()) {
+		return false;
+	}
+	*rank = record->second.rank;
+	return true;
+}
+
+void gameOrderMove(const std::vector<std::string>& names, size_t index) {
+	// ".." is always listed first
+	u32 prev = 0, next = RANK_MAX;
+	bool ranked = (index == 0 || names[index - 1] == ".." || gameOrderRank(names[index - 1], &prev));
+	if (ranked && index + 1 < names.size()) {
+		ranked = gameOrderRank(names[index + 1], &next);
+	} else if (ranked && prev <= RANK_MAX - RANK_STEP * 2) {
+		next = prev + RANK_STEP * 2;
+	}
+
+	if (ranked && next > prev && next - prev >= 2) {
+		writeRanks({{names[index], prev + (next - prev) / 2}});
+	} else {
+		gameOrderRankAll(names);
+	}
+}
+
+void gameOrderRankAll(const std::vector<std::string>& names) {
+	const u32 step = (names.size() < RANK_MAX / RANK_STEP) ? RANK_STEP : RANK_MAX / (names.size() + 1);
+	std::vector<std::pair<std::string, u32>> updates;
+	u32 rank = 0;
+	for (const std::string& name : names) {
+		if (name != "..") {
+			rank += step;
+			updates.emplace_back(name, rank);
+		}
+	}
+	rewriteRanks(updates);
+}
@@ -20,6 +20,7 @@
 
 #include "common/inifile.h"
 #include "common/stringtool.h"
+#include "common/discCache.h"
 
 #include <cstdio>
 #include <cstdlib>
@@ -178,8 +179,15 @@ bool CIniFile::LoadIniFile(const std::string &FileName)
 
 	FILE *f = fopen(FileName.c_str(), "rb");
 
-	if (NULL == f)
-		return false;
+	if (NULL == f) {
+		// A save was cut off after removing the old file, so finish it
+		const std::string tempName = FileName + ".tmp";
+		if (rename(tempName.c_str(), FileName.c_str()) != 0)
+			return false;
+		f = fopen(FileName.c_str(), "rb");
+		if (NULL == f)
+			return false;
+	}
 
 	//check for utf8 bom.
 	char bom[3];
@@ -199,6 +207,7 @@ bool CIniFile::LoadIniFile(const std::string &FileName)
 
 	fclose(f);
 
+	m_sSavedFileName = m_sFileName;
 	m_bLastResult = false;
 	m_bModified = false;
 
@@ -219,27 +228,46 @@ bool CIniFile::SaveIniFile(const std::string &FileName)
 	if (FileName != "")
 		m_sFileName = FileName;
 
-	FILE *f = fopen(m_sFileName.c_str(), "wb");
-	if (NULL == f) {
-		return false;
-	}
+	// Nothing was set to a new value since the file was loaded or saved
+	if (!m_bModified && m_sFileName == m_sSavedFileName)
+		return true;
 
+	const char *newLine = (gbar2Fix ? "\n" : "\r\n");
+	std::string contents;
 	for (size_t ii = 0; ii < m_FileContainer.size(); ii++) {
 		std::string &strline = m_FileContainer[ii];
 		size_t notSpace = strline.find_first_not_of(' ');
 		strline = strline.substr(notSpace);
 		if (strline.find('[') == 0 && ii > 0) {
 			if (!m_FileContainer[ii - 1].empty() && m_FileContainer[ii - 1] != "")
-				fwrite((gbar2Fix ? "\n" : "\r\n"), 1, 2-gbar2Fix, f);
+				contents += newLine;
 		}
 		if (!strline.empty() && strline != "") {
-			fwrite(strline.c_str(), 1, strline.length(), f);
-			fwrite((gbar2Fix ? "\n" : "\r\n"), 1, 2-gbar2Fix, f);
+			contents += strline;
+			contents += newLine;
 		}
 	}
 
-	fclose(f);
+	// Write to a temporary file first, so a power loss can't leave half a file
+	const std::string tempName = m_sFileName + ".tmp";
+	FILE *f = fopen(tempName.c_str(), "wb");
+	if (NULL == f) {
+		return false;
+	}
+	const bool written = (fwrite(contents.c_str(), 1, contents.length(), f) == contents.length());
+	if (fclose(f) != 0 || !written) {
+		remove(tempName.c_str());
+		return false;
+	}
+
+	// FAT can't rename over an existing file
+	remove(m_sFileName.c_str());
+	if (rename(tempName.c_str(), m_sFileName.c_str()) != 0) {
+		return false;
+	}
+	discCacheFlushAll();
 
+	m_sSavedFileName = m_sFileName;
 	m_bModified = false;
 
 	return true;
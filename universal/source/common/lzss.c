@@ -29,3 +29,40 @@ LZ77_Decompress(u8* source, u8* destination){
 		}
 	}
 }
+
+// Decompress data which may be corrupt or crafted, never reading past
+// sourceSize or writing past destinationSize. Returns false if the data
+// is malformed or doesn't fit.
+bool __itcm
+LZ77_DecompressBounded(const u8* source, u32 sourceSize, u8* destination, u32 destinationSize){
+	if (sourceSize < 4) return false;
+	u32 leng = (source[1] | (source[2] << 8) | (source[3] << 16));
+	if (leng > destinationSize) return false;
+	u32 Offs = 4;
+	u32 dstoffs = 0;
+	while (dstoffs < leng) {
+		if (Offs >= sourceSize) return false;
+		u8 header = source[Offs++];
+		for (int i = 0; i < 8 && dstoffs < leng; i++) {
+			if ((header & 0x80) == 0) {
+				if (Offs >= sourceSize) return false;
+				destination[dstoffs++] = source[Offs++];
+			}
+			else
+			{
+				if (Offs + 2 > sourceSize) return false;
+				u8 a = source[Offs++];
+				u8 b = source[Offs++];
+				u32 offs = (((a & 0xF) << 8) | b) + 1;
+				u32 length = (a >> 4) + 3;
+				if (offs > dstoffs || length > leng - dstoffs) return false;
+				for (u32 j = 0; j < length; j++) {
+					destination[dstoffs] = destination[dstoffs - offs];
+					dstoffs++;
+				}
+			}
+			header <<= 1;
+		}
+	}
+	return true;
+}
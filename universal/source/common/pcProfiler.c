@@ -0,0 +1,107 @@
+#include <nds.h>
+#include <malloc.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "common/pcProfiler.h"
+
+#define TABLE_SIZE		4096	// Power of 2
+#define TABLE_SHIFT		12
+#define MAX_PROBES		16
+#define BUCKET_SHIFT	4		// 16 bytes
+
+typedef struct {
+	u32 bucket;		// Address >> BUCKET_SHIFT, 0 if unused
+	u32 count;
+} Slot;
+
+// Top of the IRQ stack, from the linker script
+extern u32 __sp_irq[];
+
+static Slot* table = NULL;
+static int profilerTimer = -1;
+static PcProfilerStats stats = {0, 0, 0};
+
+static void sample(void) {
+	// The BIOS IRQ handler pushes r0-r3, r12 and lr onto the empty IRQ stack,
+	// and lr is the interrupted instruction + 4 in both ARM and THUMB state
+	const u32 bucket = (__sp_irq[-1] - 4) >> BUCKET_SHIFT;
+	u32 index = (bucket * 2654435761u) >> (32 - TABLE_SHIFT);
+
+	stats.samples++;
+	for (int i = 0; i < MAX_PROBES; i++) {
+		Slot* slot = &table[index];
+		if (slot->bucket == bucket) {
+			slot->count++;
+			return;
+		}
+		if (slot->bucket == 0) {
+			slot->bucket = bucket;
+			slot->count = 1;
+			stats.buckets++;
+			return;
+		}
+		index = (index + 1) & (TABLE_SIZE - 1);
+	}
+	stats.dropped++;
+}
+
+bool pcProfilerStart(int timer, int hz) {
+	if (profilerTimer >= 0) {
+		return true;
+	}
+	if (!table) {
+		table = (Slot*)calloc(TABLE_SIZE, sizeof(Slot));
+		if (!table) {
+			return false;
+		}
+	}
+	profilerTimer = timer;
+	timerStart(timer, ClockDivider_64, TIMER_FREQ_64(hz), sample);
+	return true;
+}
+
+void pcProfilerStop(void) {
+	if (profilerTimer < 0) {
+		return;
+	}
+	timerStop(profilerTimer);
+	irqDisable(IRQ_TIMER(profilerTimer));
+	profilerTimer = -1;
+}
+
+bool pcProfilerDump(const char* path) {
+	if (!table || profilerTimer >= 0) {
+		return false;
+	}
+
+	char folder[256];
+	strncpy(folder, path, sizeof(folder) - 1);
+	folder[sizeof(folder) - 1] = 0;
+	char* slash = strrchr(folder, '/');
+	if (slash) {
+		*slash = 0;
+		mkdir(folder, 0777);
+	}
+
+	FILE* file = fopen(path, "a");
+	if (!file) {
+		return false;
+	}
+
+	fprintf(file, "# samples %lX dropped %lX\n", (unsigned long)stats.samples, (unsigned long)stats.dropped);
+	for (int i = 0; i < TABLE_SIZE; i++) {
+		if (table[i].bucket) {
+			fprintf(file, "%08lX %lX\n", (unsigned long)(table[i].bucket << BUCKET_SHIFT), (unsigned long)table[i].count);
+		}
+	}
+	memset(table, 0, TABLE_SIZE * sizeof(Slot));
+	memset(&stats, 0, sizeof(stats));
+
+	return (fclose(file) == 0);
+}
+
+PcProfilerStats pcProfilerStats(void) {
+	return stats;
+}
@@ -0,0 +1,107 @@
+#include "common/scratchArena.h"
+
+#include <malloc.h>
+
+#define MAX_CHECKOUTS	8
+#define ALIGNMENT		32	// Cache line, so buffers can be flushed on their own
+
+struct Checkout {
+	u32 offset;
+	u32 size;		// 0 if unused
+};
+
+static u8* arena = nullptr;
+static Checkout checkouts[MAX_CHECKOUTS];
+static ScratchArenaStats stats = {0, 0, 0, 0, 0, 0};
+
+bool scratchArenaInit(u32 size) {
+	if (arena) {
+		return true;
+	}
+	size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+	arena = (u8*)memalign(ALIGNMENT, size);
+	if (!arena) {
+		return false;
+	}
+	stats.size = size;
+	return true;
+}
+
+const ScratchArenaStats& scratchArenaStats(void) {
+	return stats;
+}
+
+// End of the highest buffer checked out, as buffers are stacked on each other
+static u32 arenaTop(void) {
+	u32 top = 0;
+	for (int i = 0; i < MAX_CHECKOUTS; i++) {
+		if (checkouts[i].size && checkouts[i].offset + checkouts[i].size > top) {
+			top = checkouts[i].offset + checkouts[i].size;
+		}
+	}
+	return top;
+}
+
+static u8* arenaCheckout(u32 size) {
+	if (!arena) {
+		return nullptr;
+	}
+	size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+	const u32 offset = arenaTop();
+	if (size > stats.size - offset) {
+		return nullptr;
+	}
+	for (int i = 0; i < MAX_CHECKOUTS; i++) {
+		if (checkouts[i].size == 0) {
+			checkouts[i].offset = offset;
+			checkouts[i].size = size;
+			stats.inUse += size;
+			if (offset + size > stats.highWater) {
+				stats.highWater = offset + size;
+			}
+			return arena + offset;
+		}
+	}
+	return nullptr;
+}
+
+static void arenaRelease(u8* data) {
+	for (int i = 0; i < MAX_CHECKOUTS; i++) {
+		if (checkouts[i].size && arena + checkouts[i].offset == data) {
+			stats.inUse -= checkouts[i].size;
+			checkouts[i].size = 0;
+			return;
+		}
+	}
+}
+
+ScratchBuffer::ScratchBuffer(u32 size)
+	: _data(nullptr), _size(size), _fromHeap(false)
+{
+	if (size == 0) {
+		return;
+	}
+	stats.checkouts++;
+	_data = arenaCheckout(size);
+	if (_data) {
+		return;
+	}
+
+	stats.heapFallbacks++;
+	_data = (u8*)memalign(ALIGNMENT, size);
+	_fromHeap = true;
+	if (!_data) {
+		stats.failed++;
+	}
+}
+
+ScratchBuffer::~ScratchBuffer() {
+	if (!_data) {
+		return;
+	}
+	if (_fromHeap) {
+		free(_data);
+	} else {
+		arenaRelease(_data);
+	}
+}
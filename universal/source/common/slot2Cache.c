@@ -0,0 +1,157 @@
+/*
+	slot2Cache.c
+	Secondary cache in the RAM of a Slot-2 cart, for a DS or DS Lite.
+
+	- Slot-2 RAM is only written 16 bits at a time (8-bit writes are
+	  ignored or duplicated), so entries are 4-byte aligned and copied
+	  with tonccpy, which never writes single bytes.
+	- The index stays in main RAM, so a lookup never touches the slow bus.
+*/
+
+#include "common/slot2Cache.h"
+#include "common/tonccpy.h"
+
+#include <nds.h>
+#include <nds/arm9/dldi.h>
+
+#define SLOT2_RAM_START 0x09000000
+#define SLOT2_RAM_END 0x09800000 // The Memory Expansion Pak has 8MB
+#define SLOT2_CACHE_ENTRIES 128
+
+typedef struct {
+	u32 key;
+	u32 offset;
+	u32 size;
+	u32 age;
+	bool used;
+} Slot2CacheEntry;
+
+static u8* ramStart = NULL;
+static u32 ramSize = 0;
+static u32 writePos = 0;
+static u32 nextAge = 0;
+static Slot2CacheEntry entries[SLOT2_CACHE_ENTRIES];
+static Slot2CacheStats stats;
+
+static Slot2CacheEntry* findEntry(u32 key) {
+	for (int i = 0; i < SLOT2_CACHE_ENTRIES; i++) {
+		if (entries[i].used && entries[i].key == key) {
+			return &entries[i];
+		}
+	}
+	return NULL;
+}
+
+static bool ramWorks(vu16* probe) {
+	const u16 old = *probe;
+	*probe = 0x5AA5;
+	const bool works = (*probe == 0x5AA5);
+	*probe = old;
+	return works;
+}
+
+u32 slot2CacheInit(u32 reserved) {
+	slot2CacheRelease();
+	if (!(io_dldi_data->ioInterface.features & FEATURE_SLOT_NDS)) {
+		// The flashcard itself is in Slot-2
+		return 0;
+	}
+
+	sysSetCartOwner(BUS_OWNER_ARM9);
+	if (*(u16*)(0x020000C0) == 0) {
+		*(vu16*)(0x08240000) = 1; // Unlock the Memory Expansion Pak
+	}
+	// Any detected cart with RAM already mapped, except EZ-Flash ('EZ'), or an unlocked Memory Expansion Pak
+	if (!((*(u16*)(0x020000C0) != 0 && *(u16*)(0x020000C0) != 0x5A45) || *(vu16*)(0x08240000) == 1)) {
+		return 0;
+	}
+
+	reserved = (reserved + 3) & ~3;
+	if (reserved >= SLOT2_RAM_END - SLOT2_RAM_START || !ramWorks((vu16*)(SLOT2_RAM_START + reserved))) {
+		return 0;
+	}
+
+	ramStart = (u8*)(SLOT2_RAM_START + reserved);
+	ramSize = SLOT2_RAM_END - SLOT2_RAM_START - reserved;
+	return ramSize;
+}
+
+u32 slot2CacheSize(void) {
+	return ramSize;
+}
+
+bool slot2CachePut(u32 key, const void* data, u32 size) {
+	const u32 alignedSize = (size + 3) & ~3;
+	if (alignedSize == 0 || alignedSize > ramSize) {
+		return false;
+	}
+
+	slot2CacheRemove(key);
+	if (writePos + alignedSize > ramSize) {
+		writePos = 0;
+	}
+
+	// Drop the entries about to be overwritten, and pick a free one
+	Slot2CacheEntry* entry = NULL;
+	for (int i = 0; i < SLOT2_CACHE_ENTRIES; i++) {
+		Slot2CacheEntry* e = &entries[i];
+		if (e->used && e->offset < writePos + alignedSize && writePos < e->offset + ((e->size + 3) & ~3)) {
+			e->used = false;
+			stats.evictions++;
+		}
+		if (!e->used && !entry) {
+			entry = e;
+		}
+	}
+	if (!entry) {
+		// Out of index entries, so drop the oldest
+		entry = &entries[0];
+		for (int i = 1; i < SLOT2_CACHE_ENTRIES; i++) {
+			if (nextAge - entries[i].age > nextAge - entry->age) {
+				entry = &entries[i];
+			}
+		}
+		stats.evictions++;
+	}
+
+	tonccpy(ramStart + writePos, data, size);
+	entry->key = key;
+	entry->offset = writePos;
+	entry->size = size;
+	entry->age = nextAge++;
+	entry->used = true;
+	writePos += alignedSize;
+	stats.puts++;
+	return true;
+}
+
+bool slot2CacheGet(u32 key, void* data, u32 size) {
+	const Slot2CacheEntry* entry = ramSize ? findEntry(key) : NULL;
+	if (!entry || entry->size != size) {
+		stats.misses++;
+		return false;
+	}
+	tonccpy(data, ramStart + entry->offset, size);
+	stats.hits++;
+	return true;
+}
+
+void slot2CacheRemove(u32 key) {
+	Slot2CacheEntry* entry = findEntry(key);
+	if (entry) {
+		entry->used = false;
+	}
+}
+
+void slot2CacheRelease(void) {
+	ramStart = NULL;
+	ramSize = 0;
+	writePos = 0;
+	for (int i = 0; i < SLOT2_CACHE_ENTRIES; i++) {
+		entries[i].used = false;
+	}
+}
+
+void slot2CacheGetStats(Slot2CacheStats* out) {
+	*out = stats;
+}
@@ -1,6 +1,8 @@
 #include "common/systemdetails.h"
 #include "common/flashcard.h"
 #include "common/arm7status.h"
+#include "common/discCache.h"
+#include "common/warmSwitch.h"
 #include "myDSiMode.h"
 
 #include <nds/arm9/dldi.h>
@@ -39,6 +41,7 @@ SystemDetails::SystemDetails()
 	_isDSPhat = false;
 	_hasRegulableBacklight = true;
 	_i2cBricked = false;
+	_dsDebugRam = false;
 	_nitroFsInitOk = false;
 	_fatInitOk = false;
 	_fifoOk = false;
@@ -113,17 +116,28 @@ void SystemDetails::initFilesystem(const char *runningPath)
 		return;
 	}
 
+	// Size the sector cache to the RAM available
+	const u32 discCacheSize = (isDSiMode() || _dsDebugRam) ? 512*1024 : 64*1024;
+
 	*(u32*)(0x2FFFD0C) = 0x54494D52;	// Run reboot timer
 	if (isDSiMode() && memcmp(io_dldi_data->friendlyName, "CycloDS iEvolution", 18) == 0) {
 		*(u32*)(0x2FFFA04) = 0x49444C44;
-		fatMountSimple("fat", &__my_io_dsisd);
+		fatMountSimple("fat", discCacheWrap(&__my_io_dsisd, discCacheSize));
+		discCacheHookDevice("fat:");
 		_fatInitOk = flashcardFound();
 	} else {
-		fatMountSimple("sd", &__my_io_dsisd);
-		fatMountSimple("fat", dldiGetInternal());
+		fatMountSimple("sd", discCacheWrap(&__my_io_dsisd, discCacheSize));
+		fatMountSimple("fat", discCacheWrap(dldiGetInternal(), discCacheSize));
+		discCacheHookDevice("sd:");
+		discCacheHookDevice("fat:");
 		_fatInitOk = (sdFound() || flashcardFound());
 	}
 	*(u32*)(0x2FFFD0C) = 0;
+#ifndef _NO_MAIN_ALL
+	if (_fatInitOk) {
+		warmSwitchApply();
+	}
+#endif
 	_isRunFromSD = (strncmp(runningPath, "sd:/", 4) == 0);
 	chdir(_isRunFromSD ? "sd:/" : "fat:/");
 
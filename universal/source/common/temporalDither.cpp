@@ -0,0 +1,66 @@
+#include "common/temporalDither.h"
+
+// 4x4 Bayer matrix, scaled to the 3 bits dropped from each 8-bit channel
+static const u8 bayer4x4[4][4] = {
+	{0, 4, 1, 5},
+	{6, 2, 7, 3},
+	{1, 5, 0, 4},
+	{7, 3, 6, 2},
+};
+
+static inline u32 ditherChannel5(u32 value8, u32 threshold) {
+	u32 value5 = value8 >> 3;
+	if ((value8 & 7) > threshold && value5 < 31) {
+		value5++;
+	}
+	return value5;
+}
+
+static inline u32 ditherChannel6(u32 value8, u32 threshold) {
+	u32 value6 = value8 >> 2;
+	if (((value8 & 3) << 1) > threshold && value6 < 63) {
+		value6++;
+	}
+	return value6;
+}
+
+static inline u16 packColor(u32 c0, u32 c1, u32 c2, u32 threshold, TemporalDitherFormat format) {
+	if (format == TDFormatRgb565) {
+		const u32 green = ditherChannel6(c1, threshold);
+		return ditherChannel5(c0, threshold) | (green >> 1) << 5 | ditherChannel5(c2, threshold) << 10 | (green & 1) << 15;
+	}
+	return ditherChannel5(c0, threshold) | ditherChannel5(c1, threshold) << 5 | ditherChannel5(c2, threshold) << 10 | BIT(15);
+}
+
+void temporalDitherPixel(u8 c0, u8 c1, u8 c2, int x, int y, TemporalDitherFormat format, u16* out0, u16* out1) {
+	// The second frame uses the mirrored threshold, so both frames average out to the source
+	const u32 threshold = bayer4x4[y & 3][x & 3];
+	*out0 = packColor(c0, c1, c2, threshold, format);
+	*out1 = packColor(c0, c1, c2, 7 - threshold, format);
+}
+
+void temporalDitherRow(const u8* src, int bytesPerPixel, bool hasAlpha, int width, int y, TemporalDitherFormat format, const u16* colorTable, u16* dst0, u16* dst1) {
+	for (int x = 0; x < width; x++, src += bytesPerPixel) {
+		u32 c0 = src[0];
+		u32 c1 = src[1];
+		u32 c2 = src[2];
+		if (hasAlpha) {
+			const u32 alpha = src[3];
+			if (alpha == 0) {
+				continue;
+			}
+			if (alpha != 255) {
+				// Blend over black
+				c0 = (c0 * alpha + 127) / 255;
+				c1 = (c1 * alpha + 127) / 255;
+				c2 = (c2 * alpha + 127) / 255;
+			}
+		}
+
+		temporalDitherPixel(c0, c1, c2, x, y, format, &dst0[x], &dst1[x]);
+		if (colorTable) {
+			dst0[x] = colorTable[dst0[x] % 0x8000];
+			dst1[x] = colorTable[dst1[x] % 0x8000];
+		}
+	}
+}
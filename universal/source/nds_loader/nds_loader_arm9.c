@@ -29,6 +29,11 @@
 #include <fat.h>
 
 #include "common/tonccpy.h"
+#include "common/discCache.h"
+#include "common/srldrPack.h"
+#ifndef _NO_MAIN_ALL
+#include "common/warmSwitch.h"
+#endif
 #include "load_bin.h"
 
 #ifndef _NO_BOOTSTUB_
@@ -265,6 +270,9 @@ int runNds (const void* loader, u32 loaderSize, u32 cluster, bool initDisc, bool
 	int argSize;
 	const char* argChar;
 
+	// Write back anything the sector cache is still holding
+	discCacheFlushAll();
+
 	irqDisable(IRQ_ALL);
 
 	// Direct CPU access to VRAM bank C
@@ -372,10 +380,20 @@ bool runNds9 (const char* filename, bool dsModeSwitch) {
 	FILE* ndsFile = fopen(filename, "rb");
 	fseek(ndsFile, 0, SEEK_SET);
 	fread(__DSiHeader, 1, 0x1000, ndsFile);
+
+	// Packed binaries are decompressed by the bootloader
+	u32 arm9Size = __DSiHeader->ndshdr.arm9binarySize;
+	u32 arm7Size = __DSiHeader->ndshdr.arm7binarySize;
+	const u32* header = (u32*)__DSiHeader;
+	if (header[SRLDR_PACK_MAGIC_OFFSET>>2] == SRLDR_PACK_MAGIC) {
+		if (header[SRLDR_PACK_ARM9_OFFSET>>2]) arm9Size = header[SRLDR_PACK_ARM9_OFFSET>>2];
+		if (header[SRLDR_PACK_ARM7_OFFSET>>2]) arm7Size = header[SRLDR_PACK_ARM7_OFFSET>>2];
+	}
+
 	fseek(ndsFile, __DSiHeader->ndshdr.arm9romOffset, SEEK_SET);
-	fread((void*)0x02800000, 1, __DSiHeader->ndshdr.arm9binarySize, ndsFile);
+	fread((void*)0x02800000, 1, arm9Size, ndsFile);
 	fseek(ndsFile, __DSiHeader->ndshdr.arm7romOffset, SEEK_SET);
-	fread((void*)0x02B80000, 1, __DSiHeader->ndshdr.arm7binarySize, ndsFile);
+	fread((void*)0x02B80000, 1, arm7Size, ndsFile);
 	fclose(ndsFile);
 
 	return true;
@@ -525,6 +543,12 @@ int runNdsFile (const char* filename, int argc, const char** argv, bool isRunFro
 
 	bool loadFromRam = runNds9(filename, dsModeSwitch);
 
+	#ifndef _NO_MAIN_ALL
+	if (!loadFromRam) {
+		warmSwitchPrepare(filename, st.st_ino);
+	}
+	#endif
+
 	#ifndef _NO_BOOTSTUB_
 	installBootStub(havedsiSD, isRunFromSD, dsModeSwitch);
 	#endif
@@ -309,6 +309,31 @@ void my_cardReset (bool properReset)
 	toncset(headerData, 0, 0x1000);
 }
 
+int my_cardResetStep (int step)
+{
+	switch (step) {
+		case CARD_RESET_POWER_OFF:
+			sysSetCardOwner (BUS_OWNER_ARM9);	// Allow arm9 to access NDS cart
+			disableSlot1();
+			return 25;
+		case CARD_RESET_POWER_ON:
+			enableSlot1();
+			return 15;
+		case CARD_RESET_CLEAR:
+			REG_ROMCTRL=0;
+			REG_AUXSPICNT=0;
+			return 25;
+		default:
+			REG_AUXSPICNT=CARD_CR1_ENABLE|CARD_CR1_IRQ;
+			REG_ROMCTRL=CARD_nRESET|CARD_SEC_SEED;
+			while (REG_ROMCTRL&CARD_BUSY) ;
+			cardReset();
+			while (REG_ROMCTRL&CARD_BUSY) ;
+			toncset(headerData, 0, 0x1000);
+			return 0;
+	}
+}
+
 int cardInit (void)
 {
 	u32 portFlagsKey1, portFlagsSecRead;